@@ -32,6 +32,9 @@ set(VISCOM_OPENGL_PROFILE "3.3" CACHE STRING "OpenGL profile version to use.")
 # This could be changed to "off" if the default target doesn't need the tuio library
 set(VISCOM_USE_TUIO ON CACHE BOOL "Use TUIO input library")
 set(VISCOM_TUIO_PORT 3333 CACHE STRING "UDP Port for TUIO to listen on")
+set(VISCOM_USE_SIMD ON CACHE BOOL "Use SSE/AVX code paths for CPU side kernels (skinning, culling, picking).")
+set(VISCOM_BUILD_TOOLS OFF CACHE BOOL "Build the command line tools (e.g., the blend mask converter).")
+set(VISCOM_BUILD_TESTS OFF CACHE BOOL "Build the CPU side unit tests and benchmarks (run with ctest).")
 
 # Build-flags.
 if(UNIX)
@@ -87,6 +90,8 @@ if (${VISCOM_LOCAL_ONLY})
     list(REMOVE_ITEM SRC_FILES_CORE "${PROJECT_SOURCE_DIR}/extern/fwcore/src/core/SlaveNodeInternal.cpp")
     list(REMOVE_ITEM SRC_FILES_CORE "${PROJECT_SOURCE_DIR}/extern/fwcore/src/core/OpenCVParserHelper.h")
     list(REMOVE_ITEM SRC_FILES_CORE "${PROJECT_SOURCE_DIR}/extern/fwcore/src/core/OpenCVParserHelper.cpp")
+    list(REMOVE_ITEM SRC_FILES_CORE "${PROJECT_SOURCE_DIR}/extern/fwcore/src/core/BlendMask.h")
+    list(REMOVE_ITEM SRC_FILES_CORE "${PROJECT_SOURCE_DIR}/extern/fwcore/src/core/BlendMask.cpp")
 endif()
 
 foreach(f ${SRC_FILES_CORE})
@@ -149,6 +154,10 @@ if (${VISCOM_LOCAL_ONLY})
     list(APPEND COMPILE_TIME_DEFS VISCOM_LOCAL_ONLY)
 endif()
 
+if (NOT ${VISCOM_USE_SIMD})
+    list(APPEND COMPILE_TIME_DEFS VISCOM_NO_SIMD)
+endif()
+
 if(${VISCOM_USE_TUIO})
     add_subdirectory(extern/fwcore/extern/tuio EXCLUDE_FROM_ALL)
     list(APPEND COMPILE_TIME_DEFS VISCOM_USE_TUIO)
@@ -162,6 +171,53 @@ target_include_directories(VISCOMCore PUBLIC ${CORE_INCLUDE_DIRS})
 target_link_libraries(VISCOMCore ${CORE_LIBS})
 target_compile_definitions(VISCOMCore PUBLIC ${COMPILE_TIME_DEFS})
 
+if (${VISCOM_BUILD_TOOLS})
+    add_executable(BlendMaskConverter extern/fwcore/tools/BlendMaskConverter.cpp extern/fwcore/src/core/BlendMask.cpp)
+    set_property(TARGET BlendMaskConverter PROPERTY CXX_STANDARD 17)
+    target_include_directories(BlendMaskConverter PRIVATE ${CORE_INCLUDE_DIRS})
+    install(TARGETS BlendMaskConverter DESTINATION ${VISCOM_INSTALL_BASE_PATH}/${VISCOM_APP_NAME})
+endif()
+
+if (${VISCOM_BUILD_TESTS})
+    enable_testing()
+
+    # Adds a test from extern/fwcore/tests/<TEST_NAME>.cpp, further arguments are the core sources it needs.
+    macro(add_core_test TEST_NAME)
+        add_executable(${TEST_NAME} extern/fwcore/tests/${TEST_NAME}.cpp ${ARGN})
+        set_property(TARGET ${TEST_NAME} PROPERTY CXX_STANDARD 17)
+        target_include_directories(${TEST_NAME} PRIVATE ${CORE_INCLUDE_DIRS} extern/fwcore/tests)
+        target_compile_definitions(${TEST_NAME} PRIVATE ${COMPILE_TIME_DEFS})
+        add_test(NAME ${TEST_NAME} COMMAND ${TEST_NAME})
+    endmacro()
+
+    add_core_test(FrustumCullingTest extern/fwcore/src/core/math/FrustumCulling.cpp)
+    add_core_test(AABBTransformTest)
+    add_core_test(IndirectDrawTest extern/fwcore/src/core/gfx/mesh/IndirectDraw.cpp)
+    add_core_test(OcclusionCullingTest extern/fwcore/src/core/math/OcclusionCulling.cpp)
+    add_core_test(BlendMaskTest extern/fwcore/src/core/BlendMask.cpp)
+    add_core_test(RenderTargetPoolTest extern/fwcore/src/core/gfx/RenderTargetPoolBookkeeping.cpp)
+    # only compiles graphs, but links the frame buffers of Execute().
+    add_core_test(RenderGraphTest extern/fwcore/src/core/gfx/RenderGraph.cpp extern/fwcore/src/core/gfx/FrameBuffer.cpp
+        extern/fwcore/src/core/gfx/GLStateCache.cpp extern/fwcore/src/core/gfx/RenderTargetPool.cpp
+        extern/fwcore/src/core/gfx/RenderTargetPoolBookkeeping.cpp)
+    if (NOT ${VISCOM_USE_SGCT})
+        target_sources(RenderGraphTest PRIVATE extern/fwcore/src_nosgct/glew/src/glew.c)
+    endif()
+    target_link_libraries(RenderGraphTest ${CORE_LIBS})
+    if (${VISCOM_USE_SGCT})
+        # the calibration parser uses tinyxml2 from SGCT and logs with g3log.
+        add_core_test(OpenCVParserTest extern/fwcore/src/core/OpenCVParserHelper.cpp)
+        target_link_libraries(OpenCVParserTest ${CORE_LIBS})
+    endif()
+    # compares indirect and direct draws on a headless EGL context, skipped (77) if the driver has none.
+    find_package(OpenGL COMPONENTS OpenGL EGL)
+    if (OpenGL_OpenGL_FOUND AND OpenGL_EGL_FOUND)
+        add_core_test(IndirectDrawGLTest extern/fwcore/src/core/gfx/mesh/IndirectDraw.cpp)
+        target_link_libraries(IndirectDrawGLTest OpenGL::OpenGL OpenGL::EGL)
+        set_tests_properties(IndirectDrawGLTest PROPERTIES ENVIRONMENT "LIBGL_ALWAYS_SOFTWARE=1" SKIP_RETURN_CODE 77)
+    endif()
+endif()
+
 macro(copy_core_lib_dlls APP_NAME)
     if (${VISCOM_USE_TUIO})
         add_custom_command(TARGET ${APP_NAME} POST_BUILD COMMAND ${CMAKE_COMMAND} -E copy_if_different $<TARGET_FILE:libTUIO> ${PROJECT_BINARY_DIR})
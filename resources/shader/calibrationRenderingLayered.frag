@@ -0,0 +1,27 @@
+#version 330 core
+in vec3 v_TexCoord;
+in vec4 gl_FragCoord;
+
+out vec4 color;
+
+// Texture samplers
+uniform sampler2DArray tex;
+uniform sampler2D alphaTex;
+// The layer of the window drawn.
+uniform int layer;
+
+void main()
+{
+    const float gamma = 1.0/2.2;
+
+    vec2 coord = vec2(v_TexCoord.s / v_TexCoord.p, v_TexCoord.t / v_TexCoord.p);
+    vec2 screenSize = vec2(textureSize(alphaTex, 0));
+    vec2 screenCoords = gl_FragCoord.xy / screenSize;
+
+    vec4 colorTexture = texture(tex, vec3(coord, float(layer)));
+    vec4 alpha = texture(alphaTex, screenCoords);
+    
+    alpha = vec4(vec3(pow(alpha.r, gamma)), 1.0f);
+
+    color = vec4(colorTexture.rgb * alpha.rgb, 1.0f);
+}
@@ -0,0 +1,18 @@
+#version 330 core
+in vec3 v_TexCoord;
+in float v_BlendWeight;
+
+out vec4 color;
+
+// Texture samplers
+uniform sampler2D tex;
+
+void main()
+{
+    const float gamma = 1.0/2.2;
+
+    vec2 coord = vec2(v_TexCoord.s / v_TexCoord.p, v_TexCoord.t / v_TexCoord.p);
+    vec4 colorTexture = texture(tex, coord);
+
+    color = vec4(colorTexture.rgb * pow(v_BlendWeight, gamma), 1.0f);
+}
@@ -0,0 +1,14 @@
+#version 330 core
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 texCoord;
+layout(location = 2) in float blendWeight;
+
+out vec3 v_TexCoord;
+out float v_BlendWeight;
+
+void main()
+{
+    gl_Position = vec4(position, 1.0f);
+    v_TexCoord = texCoord;
+    v_BlendWeight = blendWeight;
+}
@@ -1,4 +1,6 @@
 #version 330 core
+#extension GL_ARB_shader_viewport_layer_array : enable
+#extension GL_AMD_vertex_shader_layer : enable
 
 out vec2 texCoord;
 
@@ -20,4 +22,8 @@ void main()
 {
     texCoord = tex_data[ gl_VertexID ];
     gl_Position = vec4( pos_data[ gl_VertexID ], 0.0, 1.0 );
+    // layered rendering draws one instance per layer.
+#if defined(GL_ARB_shader_viewport_layer_array) || defined(GL_AMD_vertex_shader_layer)
+    gl_Layer = gl_InstanceID;
+#endif
 }
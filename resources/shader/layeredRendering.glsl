@@ -0,0 +1,38 @@
+// Layer selection for rendering all windows of a node at once (LAYERED_RENDERING=1).
+// Include it in vertex shaders directly after the #version line (includes are relative to the including shader,
+// so applications include it from extern/fwcore/resources/shader). Framework draws are instanced numLayers times,
+// draws instanced by the application have to multiply their instance count by numLayers as well.
+#extension GL_ARB_shader_viewport_layer_array : enable
+#extension GL_AMD_vertex_shader_layer : enable
+
+layout(std140) uniform PerLayerUniforms
+{
+    mat4 layerViewProjectionMatrices[8];
+    int numLayers;
+};
+
+// The layer of the current vertex.
+int GetRenderLayer()
+{
+    return gl_InstanceID % numLayers;
+}
+
+// The instance index of draws instanced by the application.
+int GetInstanceIndex()
+{
+    return gl_InstanceID / numLayers;
+}
+
+// The view projection matrix of the layer of the current vertex.
+mat4 GetLayerViewProjection()
+{
+    return layerViewProjectionMatrices[GetRenderLayer()];
+}
+
+// Sends the current vertex to its layer, call once in main().
+void SetRenderLayer()
+{
+#if defined(GL_ARB_shader_viewport_layer_array) || defined(GL_AMD_vertex_shader_layer)
+    gl_Layer = GetRenderLayer();
+#endif
+}
@@ -54,6 +54,13 @@ namespace viscom {
         virtual void PostDraw();
         virtual void CleanUp();
 
+        /**
+         *  Returns if DrawFrame can render all windows of a node at once (LAYERED_RENDERING=1). This needs all shaders
+         *  used in DrawFrame to select their layer (see resources/shader/layeredRendering.glsl) and all draws not done
+         *  by the framework to be instanced StandardUniforms::GetNumRenderLayers() times.
+         */
+        virtual bool IsLayeredRenderingSupported() const { return false; }
+
         virtual bool DataTransferCallback(void* receivedData, int receivedLength, std::uint16_t packageID, int clientID);
         virtual bool DataAcknowledgeCallback(std::uint16_t packageID, int clientID);
         virtual bool DataTransferStatusCallback(bool connected, int clientID);
@@ -86,6 +93,8 @@ namespace viscom {
         MeshManager& GetMeshManager() { return appNode_->GetMeshManager(); }
 
         CameraHelper* GetCamera() { return appNode_->GetCamera(); }
+        /** Returns the number of layers DrawFrame renders to at once (see PerLayerUniforms), 1 if windows are drawn separately. */
+        unsigned int GetNumRenderLayers() const { return appNode_->GetNumRenderLayers(); }
         std::vector<FrameBuffer> CreateOffscreenBuffers(const FrameBufferDescriptor& fboDesc, int sizeDivisor = 1) const { return appNode_->CreateOffscreenBuffers(fboDesc, sizeDivisor); }
         const FrameBuffer* SelectOffscreenBuffer(const std::vector<FrameBuffer>& offscreenBuffers) const { return appNode_->SelectOffscreenBuffer(offscreenBuffers); }
         std::unique_ptr<FullscreenQuad> CreateFullscreenQuad(const std::string& fragmentShader) { return appNode_->CreateFullscreenQuad(fragmentShader); }
@@ -0,0 +1,315 @@
+/**
+ * @file   BlendMask.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of reading and writing the blend masks (alpha textures) of projectors.
+ */
+
+#include "BlendMask.h"
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <glm/gtc/packing.hpp>
+
+namespace viscom {
+
+    namespace {
+        /** The magic number of the compact format, legacy files would need a width of over 10^9 pixels to match. */
+        constexpr std::array<char, 4> BLEND_MASK_MAGIC{ { 'V', 'B', 'M', 'K' } };
+        /** The version of the compact format. */
+        constexpr std::uint32_t BLEND_MASK_VERSION = 1;
+        /** The size of the buffer for reading compressed data. */
+        constexpr std::size_t READ_BUFFER_SIZE = 64 * 1024;
+        /** The maximum number of bytes of a literal block (control bytes 0 to 127). */
+        constexpr std::size_t RLE_MAX_LITERAL = 128;
+        /** The minimum and maximum number of bytes of a run (control bytes 128 to 255). */
+        constexpr std::size_t RLE_MIN_RUN = 3;
+        constexpr std::size_t RLE_MAX_RUN = 130;
+
+        /** The header of the compact format. */
+        struct BlendMaskHeader
+        {
+            std::array<char, 4> magic_;
+            std::uint32_t version_;
+            std::uint32_t width_;
+            std::uint32_t height_;
+            BlendMaskFormat format_;
+            BlendMaskCompression compression_;
+        };
+
+        template<typename T> void DeltaEncode(std::uint8_t* row, std::size_t numPixels)
+        {
+            for (auto x = numPixels; x > 1; --x) {
+                T current, previous;
+                std::memcpy(&current, row + (x - 1) * sizeof(T), sizeof(T));
+                std::memcpy(&previous, row + (x - 2) * sizeof(T), sizeof(T));
+                current = static_cast<T>(current - previous);
+                std::memcpy(row + (x - 1) * sizeof(T), &current, sizeof(T));
+            }
+        }
+
+        template<typename T> void DeltaDecode(std::uint8_t* row, std::size_t numPixels)
+        {
+            T sum = 0;
+            for (std::size_t x = 0; x < numPixels; ++x) {
+                T delta;
+                std::memcpy(&delta, row + x * sizeof(T), sizeof(T));
+                sum = static_cast<T>(sum + delta);
+                std::memcpy(row + x * sizeof(T), &sum, sizeof(T));
+            }
+        }
+
+        void DeltaEncode(std::uint8_t* row, std::size_t numPixels, std::size_t bytesPerPixel)
+        {
+            if (bytesPerPixel == 1) DeltaEncode<std::uint8_t>(row, numPixels);
+            else if (bytesPerPixel == 2) DeltaEncode<std::uint16_t>(row, numPixels);
+            else DeltaEncode<std::uint32_t>(row, numPixels);
+        }
+
+        void DeltaDecode(std::uint8_t* row, std::size_t numPixels, std::size_t bytesPerPixel)
+        {
+            if (bytesPerPixel == 1) DeltaDecode<std::uint8_t>(row, numPixels);
+            else if (bytesPerPixel == 2) DeltaDecode<std::uint16_t>(row, numPixels);
+            else DeltaDecode<std::uint32_t>(row, numPixels);
+        }
+
+        /** Run-length encodes a row: runs of at least RLE_MIN_RUN equal bytes are stored as two bytes, others as literals. */
+        void EncodeRLE(const std::vector<std::uint8_t>& row, std::vector<std::uint8_t>& encoded)
+        {
+            encoded.clear();
+            std::size_t literalStart = 0;
+            auto flushLiterals = [&row, &encoded, &literalStart](std::size_t end) {
+                while (literalStart < end) {
+                    auto n = glm::min(end - literalStart, RLE_MAX_LITERAL);
+                    encoded.push_back(static_cast<std::uint8_t>(n - 1));
+                    encoded.insert(encoded.end(), row.begin() + literalStart, row.begin() + literalStart + n);
+                    literalStart += n;
+                }
+            };
+
+            std::size_t i = 0;
+            while (i < row.size()) {
+                std::size_t run = 1;
+                while (i + run < row.size() && run < RLE_MAX_RUN && row[i + run] == row[i]) ++run;
+                if (run >= RLE_MIN_RUN) {
+                    flushLiterals(i);
+                    encoded.push_back(static_cast<std::uint8_t>(run + RLE_MAX_LITERAL - RLE_MIN_RUN));
+                    encoded.push_back(row[i]);
+                    literalStart = i + run;
+                }
+                i += run;
+            }
+            flushLiterals(row.size());
+        }
+
+        void EncodePixel(float value, BlendMaskFormat format, std::uint8_t* pixel)
+        {
+            switch (format) {
+            case BlendMaskFormat::R8: {
+                auto v = static_cast<std::uint8_t>(glm::round(glm::clamp(value, 0.0f, 1.0f) * 255.0f));
+                std::memcpy(pixel, &v, sizeof(v));
+            } break;
+            case BlendMaskFormat::R16: {
+                auto v = static_cast<std::uint16_t>(glm::round(glm::clamp(value, 0.0f, 1.0f) * 65535.0f));
+                std::memcpy(pixel, &v, sizeof(v));
+            } break;
+            case BlendMaskFormat::R16F: {
+                auto v = static_cast<std::uint16_t>(glm::packHalf1x16(value));
+                std::memcpy(pixel, &v, sizeof(v));
+            } break;
+            case BlendMaskFormat::R32F:
+                std::memcpy(pixel, &value, sizeof(value));
+                break;
+            }
+        }
+
+        float DecodePixel(const std::uint8_t* pixel, BlendMaskFormat format)
+        {
+            switch (format) {
+            case BlendMaskFormat::R8:
+                return static_cast<float>(*pixel) / 255.0f;
+            case BlendMaskFormat::R16: {
+                std::uint16_t v;
+                std::memcpy(&v, pixel, sizeof(v));
+                return static_cast<float>(v) / 65535.0f;
+            }
+            case BlendMaskFormat::R16F: {
+                std::uint16_t v;
+                std::memcpy(&v, pixel, sizeof(v));
+                return glm::unpackHalf1x16(v);
+            }
+            default: {
+                float v;
+                std::memcpy(&v, pixel, sizeof(v));
+                return v;
+            }
+            }
+        }
+    }
+
+    /**
+     *  Returns the bytes per pixel of a blend mask format.
+     *  @param format the format.
+     */
+    std::size_t GetBlendMaskBytesPerPixel(BlendMaskFormat format)
+    {
+        switch (format) {
+        case BlendMaskFormat::R8:
+            return 1;
+        case BlendMaskFormat::R16: case BlendMaskFormat::R16F:
+            return 2;
+        default:
+            return 4;
+        }
+    }
+
+    /**
+     *  Opens a blend mask and reads its header.
+     *  @param filename the name of the file.
+     */
+    BlendMaskReader::BlendMaskReader(const std::string& filename) :
+        file_{ filename, std::ios::binary },
+        filename_{ filename }
+    {
+        if (!file_) throw std::runtime_error("Blend mask file not found (" + filename + ").");
+
+        BlendMaskHeader header;
+        file_.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (file_ && header.magic_ == BLEND_MASK_MAGIC) {
+            if (header.version_ != BLEND_MASK_VERSION) throw std::runtime_error("Unsupported blend mask version (" + filename + ").");
+            if (header.format_ > BlendMaskFormat::R32F || header.compression_ > BlendMaskCompression::DeltaRLE) {
+                throw std::runtime_error("Unsupported blend mask format (" + filename + ").");
+            }
+            size_ = glm::uvec2(header.width_, header.height_);
+            format_ = header.format_;
+            compression_ = header.compression_;
+        } else {
+            file_.clear();
+            file_.seekg(0);
+            glm::u32vec2 size;
+            file_.read(reinterpret_cast<char*>(&size), sizeof(size));
+            if (!file_) throw std::runtime_error("Blend mask file is too short (" + filename + ").");
+            size_ = size;
+            legacy_ = true;
+        }
+
+        if (compression_ != BlendMaskCompression::None) readBuffer_.resize(READ_BUFFER_SIZE);
+    }
+
+    std::size_t BlendMaskReader::GetBytesPerPixel() const noexcept
+    {
+        return GetBlendMaskBytesPerPixel(format_);
+    }
+
+    /**
+     *  Reads the next rows of the mask.
+     *  @param numRows the number of rows to read.
+     *  @param data the pixels of the rows (numRows * width * GetBytesPerPixel() bytes).
+     */
+    void BlendMaskReader::ReadRows(unsigned int numRows, void* data)
+    {
+        if (numRowsRead_ + numRows > size_.y) throw std::runtime_error("Reading beyond the end of the blend mask (" + filename_ + ").");
+
+        auto rowSize = static_cast<std::size_t>(size_.x) * GetBytesPerPixel();
+        auto rows = static_cast<std::uint8_t*>(data);
+        if (compression_ == BlendMaskCompression::None) {
+            file_.read(reinterpret_cast<char*>(rows), rowSize * numRows);
+            if (!file_) throw std::runtime_error("Unexpected end of blend mask (" + filename_ + ").");
+        } else {
+            for (auto y = 0U; y < numRows; ++y) DecodeRow(rows + y * rowSize);
+        }
+        numRowsRead_ += numRows;
+    }
+
+    /**
+     *  Reads the next rows of the mask and converts them to floats.
+     *  @param numRows the number of rows to read.
+     *  @return the pixels of the rows.
+     */
+    std::vector<float> BlendMaskReader::ReadRowsf(unsigned int numRows)
+    {
+        auto numPixels = static_cast<std::size_t>(size_.x) * numRows;
+        auto bytesPerPixel = GetBytesPerPixel();
+        std::vector<std::uint8_t> rows(numPixels * bytesPerPixel);
+        ReadRows(numRows, rows.data());
+
+        std::vector<float> result(numPixels);
+        for (std::size_t i = 0; i < numPixels; ++i) result[i] = DecodePixel(rows.data() + i * bytesPerPixel, format_);
+        return result;
+    }
+
+    void BlendMaskReader::ReadBytes(std::uint8_t* data, std::size_t size)
+    {
+        while (size > 0) {
+            if (readBufferPos_ == readBufferSize_) {
+                file_.read(reinterpret_cast<char*>(readBuffer_.data()), readBuffer_.size());
+                readBufferSize_ = static_cast<std::size_t>(file_.gcount());
+                readBufferPos_ = 0;
+                if (readBufferSize_ == 0) throw std::runtime_error("Unexpected end of blend mask (" + filename_ + ").");
+            }
+            auto n = glm::min(size, readBufferSize_ - readBufferPos_);
+            std::memcpy(data, readBuffer_.data() + readBufferPos_, n);
+            readBufferPos_ += n;
+            data += n;
+            size -= n;
+        }
+    }
+
+    void BlendMaskReader::DecodeRow(std::uint8_t* row)
+    {
+        auto bytesPerPixel = GetBytesPerPixel();
+        auto rowSize = static_cast<std::size_t>(size_.x) * bytesPerPixel;
+        std::size_t pos = 0;
+        while (pos < rowSize) {
+            std::array<std::uint8_t, 2> run;
+            ReadBytes(run.data(), 1);
+            std::size_t n = run[0] < RLE_MAX_LITERAL ? run[0] + 1 : run[0] + RLE_MIN_RUN - RLE_MAX_LITERAL;
+            if (pos + n > rowSize) throw std::runtime_error("Corrupt blend mask (" + filename_ + ").");
+
+            if (run[0] < RLE_MAX_LITERAL) ReadBytes(row + pos, n);
+            else {
+                ReadBytes(&run[1], 1);
+                std::memset(row + pos, run[1], n);
+            }
+            pos += n;
+        }
+        DeltaDecode(row, size_.x, bytesPerPixel);
+    }
+
+    /**
+     *  Writes a blend mask in the compact format. Values are clamped to [0, 1] for the normalized formats.
+     *  @param filename the name of the file.
+     *  @param size the size of the mask.
+     *  @param data the pixels (row by row, starting with the bottom row like OpenGL).
+     *  @param format the pixel format.
+     *  @param compression the compression.
+     */
+    void WriteBlendMask(const std::string& filename, const glm::uvec2& size, const std::vector<float>& data,
+        BlendMaskFormat format, BlendMaskCompression compression)
+    {
+        if (data.size() != static_cast<std::size_t>(size.x) * size.y) throw std::runtime_error("Blend mask data does not match its size.");
+
+        std::ofstream file(filename, std::ios::binary);
+        if (!file) throw std::runtime_error("Could not open blend mask file for writing (" + filename + ").");
+
+        BlendMaskHeader header{ BLEND_MASK_MAGIC, BLEND_MASK_VERSION, size.x, size.y, format, compression };
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        auto bytesPerPixel = GetBlendMaskBytesPerPixel(format);
+        std::vector<std::uint8_t> row(static_cast<std::size_t>(size.x) * bytesPerPixel);
+        std::vector<std::uint8_t> encoded;
+        for (auto y = 0U; y < size.y; ++y) {
+            for (auto x = 0U; x < size.x; ++x) EncodePixel(data[static_cast<std::size_t>(y) * size.x + x], format, row.data() + x * bytesPerPixel);
+
+            if (compression == BlendMaskCompression::None) {
+                file.write(reinterpret_cast<const char*>(row.data()), row.size());
+                continue;
+            }
+            DeltaEncode(row.data(), size.x, bytesPerPixel);
+            EncodeRLE(row, encoded);
+            file.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+        }
+        if (!file) throw std::runtime_error("Could not write blend mask file (" + filename + ").");
+    }
+}
@@ -0,0 +1,90 @@
+/**
+ * @file   BlendMask.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of reading and writing the blend masks (alpha textures) of projectors.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace viscom {
+
+    /** The pixel format of a blend mask. */
+    enum class BlendMaskFormat : std::uint32_t
+    {
+        /** 8 bit unsigned normalized. */
+        R8 = 0,
+        /** 16 bit unsigned normalized. */
+        R16 = 1,
+        /** 16 bit half float. */
+        R16F = 2,
+        /** 32 bit float (the legacy format). */
+        R32F = 3
+    };
+
+    /** The compression of the pixel data of a blend mask. */
+    enum class BlendMaskCompression : std::uint32_t
+    {
+        /** The rows are stored as is. */
+        None = 0,
+        /** The differences of neighboring pixels of each row are stored run-length encoded. */
+        DeltaRLE = 1
+    };
+
+    /**
+     *  Reads a blend mask row by row, so it can be uploaded in chunks without holding the whole mask in memory.
+     *  Reads both the compact format written by WriteBlendMask() and the legacy format (the size as two unsigned
+     *  integers followed by the pixels as floats). Read errors throw std::runtime_error.
+     */
+    class BlendMaskReader final
+    {
+    public:
+        explicit BlendMaskReader(const std::string& filename);
+
+        void ReadRows(unsigned int numRows, void* data);
+        std::vector<float> ReadRowsf(unsigned int numRows);
+
+        const glm::uvec2& GetSize() const noexcept { return size_; }
+        BlendMaskFormat GetFormat() const noexcept { return format_; }
+        BlendMaskCompression GetCompression() const noexcept { return compression_; }
+        bool IsLegacy() const noexcept { return legacy_; }
+        std::size_t GetBytesPerPixel() const noexcept;
+        unsigned int GetNumRowsRead() const noexcept { return numRowsRead_; }
+
+    private:
+        void ReadBytes(std::uint8_t* data, std::size_t size);
+        void DecodeRow(std::uint8_t* row);
+
+        /** The file. */
+        std::ifstream file_;
+        /** The name of the file (for errors). */
+        std::string filename_;
+        /** The size of the mask. */
+        glm::uvec2 size_ = glm::uvec2{ 0 };
+        /** The pixel format. */
+        BlendMaskFormat format_ = BlendMaskFormat::R32F;
+        /** The compression. */
+        BlendMaskCompression compression_ = BlendMaskCompression::None;
+        /** Flag if the file has the legacy format. */
+        bool legacy_ = false;
+        /** The number of rows read so far. */
+        unsigned int numRowsRead_ = 0;
+        /** The buffer for reading compressed data. */
+        std::vector<std::uint8_t> readBuffer_;
+        /** The current position in the read buffer. */
+        std::size_t readBufferPos_ = 0;
+        /** The number of valid bytes in the read buffer. */
+        std::size_t readBufferSize_ = 0;
+    };
+
+    void WriteBlendMask(const std::string& filename, const glm::uvec2& size, const std::vector<float>& data,
+        BlendMaskFormat format, BlendMaskCompression compression = BlendMaskCompression::DeltaRLE);
+    std::size_t GetBlendMaskBytesPerPixel(BlendMaskFormat format);
+}
@@ -21,4 +21,15 @@ namespace viscom {
         CalbrationProjectorQuadVertex(const glm::vec3& pos, const glm::vec3& tex) : position_(pos), texCoords_(tex) {}
     };
 
+    struct CalibrationWarpGridVertex
+    {
+        glm::vec3 position_;
+        glm::vec3 texCoords_;
+        /** The blend weight of the projector at the vertex (as in the alpha texture). */
+        float blendWeight_;
+
+        CalibrationWarpGridVertex() {}
+        CalibrationWarpGridVertex(const glm::vec3& pos, const glm::vec3& tex, float blendWeight) : position_(pos), texCoords_(tex), blendWeight_(blendWeight) {}
+    };
+
 }
\ No newline at end of file
@@ -7,9 +7,126 @@
  */
 
 #include "OpenCVParserHelper.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <experimental/filesystem>
+#include <fstream>
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
 
 namespace viscom {
 
+    namespace {
+        /** The magic number of the matrix cache files. */
+        constexpr std::array<char, 4> CACHE_MAGIC{ { 'V', 'C', 'M', 'C' } };
+        /** The version of the matrix cache files. */
+        constexpr std::uint32_t CACHE_VERSION = 1;
+        /** The extension appended to the XML file name for the matrix cache. */
+        constexpr const char* CACHE_EXTENSION = ".cache";
+
+        /** Identifies the XML file a cache was created from. */
+        struct CacheHeader
+        {
+            std::array<char, 4> magic_;
+            std::uint32_t version_;
+            std::uint64_t sourceSize_;
+            std::int64_t sourceWriteTime_;
+            std::uint64_t numMatrices_;
+        };
+
+        bool IsSpace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+        /** Parses a single float, returns the end of the value (first if there is none). */
+        const char* ParseFloat(const char* first, const char* last, float& value)
+        {
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+            auto[ptr, ec] = std::from_chars(first, last, value);
+            // std::from_chars does not return (denormalized) values out of range, strtof does.
+            if (ec == std::errc::result_out_of_range) value = std::strtof(first, nullptr);
+            else if (ec != std::errc()) return first;
+            return ptr;
+#else
+            // floats are not supported by std::from_chars of this standard library.
+            char* ptr = nullptr;
+            value = std::strtof(first, &ptr);
+            return ptr;
+#endif
+        }
+
+        /** Parses the whitespace separated values of an OpenCV matrix. */
+        void ParseFloats(const char* text, std::size_t count, float* result)
+        {
+            if (text == nullptr) text = "";
+            auto last = text + std::strlen(text);
+            auto first = text;
+            for (std::size_t i = 0; i < count; ++i) {
+                while (first != last && IsSpace(*first)) ++first;
+                if (first != last && *first == '+') ++first;
+                if (first == last) throw std::runtime_error("Too few values in matrix.");
+
+                auto next = ParseFloat(first, last, result[i]);
+                if (next == first) throw std::runtime_error("Invalid value in matrix.");
+                first = next;
+            }
+            while (first != last && IsSpace(*first)) ++first;
+            if (first != last) throw std::runtime_error("Too many values in matrix.");
+        }
+
+        /** Returns the data type of a matrix without the quotes of multi-channel types. */
+        std::string GetMatrixType(tinyxml2::XMLElement* element)
+        {
+            auto dtElement = element->FirstChildElement("dt");
+            std::string dt = dtElement && dtElement->GetText() ? dtElement->GetText() : "";
+            if (dt.size() >= 2 && dt.front() == '"' && dt.back() == '"') dt = dt.substr(1, dt.size() - 2);
+            return dt;
+        }
+
+        bool IsMatrix(tinyxml2::XMLElement* element)
+        {
+            auto typeId = element->Attribute("type_id");
+            return typeId != nullptr && std::strcmp(typeId, "opencv-matrix") == 0;
+        }
+
+        /** Checks a single column matrix of the given type and returns its number of rows. */
+        std::size_t CheckVector(tinyxml2::XMLElement* element, const std::string& dt)
+        {
+            if (element == nullptr) throw std::runtime_error("Matrix not found.");
+            if (!IsMatrix(element)) throw std::runtime_error("Not a OpenCV matrix.");
+            if (1 != OpenCVParserHelper::Parse<int>(element->FirstChildElement("cols"))) throw std::runtime_error("Too many columns.");
+            if (dt != GetMatrixType(element)) throw std::runtime_error("Wrong type.");
+            return OpenCVParserHelper::Parse<size_t>(element->FirstChildElement("rows"));
+        }
+
+        /** Parses a float matrix with any number of rows, columns and channels, returns false for other elements. */
+        bool ParseMatrix(tinyxml2::XMLElement* element, OpenCVMatrix& matrix)
+        {
+            if (!IsMatrix(element)) return false;
+            auto dt = GetMatrixType(element);
+            if (dt == "f") matrix.numChannels_ = 1;
+            else if (dt.size() == 2 && dt[1] == 'f' && dt[0] >= '1' && dt[0] <= '4') matrix.numChannels_ = static_cast<std::size_t>(dt[0] - '0');
+            else return false;
+
+            auto rows = OpenCVParserHelper::Parse<size_t>(element->FirstChildElement("rows"));
+            auto cols = OpenCVParserHelper::Parse<size_t>(element->FirstChildElement("cols"));
+            matrix.data_.resize(rows * cols * matrix.numChannels_);
+            ParseFloats(element->FirstChildElement("data")->GetText(), matrix.data_.size(), matrix.data_.data());
+            return true;
+        }
+
+        template<typename T> void ReadCache(std::ifstream& file, T* data, std::size_t count)
+        {
+            file.read(reinterpret_cast<char*>(data), sizeof(T) * count);
+            if (!file) throw std::runtime_error("Unexpected end of cache.");
+        }
+
+        template<typename T> void WriteCache(std::ofstream& file, const T* data, std::size_t count)
+        {
+            file.write(reinterpret_cast<const char*>(data), sizeof(T) * count);
+        }
+    }
+
     void OpenCVParserHelper::LoadXMLDocument(const std::string& docName, const std::string& filename, tinyxml2::XMLDocument& doc)
     {
         auto result = doc.LoadFile(filename.c_str());
@@ -20,6 +137,39 @@ namespace viscom {
         }
     }
 
+    /**
+     *  Loads all float matrices of an OpenCV XML file. With the cache enabled the matrices are read from a binary
+     *  file next to the XML file (filename + ".cache") if it was created from the same version of the XML file,
+     *  otherwise the XML file is parsed and the cache is written.
+     *  @param docName the name of the document (for errors).
+     *  @param filename the name of the XML file.
+     *  @param useCache whether to use the binary cache.
+     *  @return the matrices by name.
+     */
+    OpenCVMatrices OpenCVParserHelper::LoadMatrices(const std::string& docName, const std::string& filename, bool useCache)
+    {
+        auto startTime = std::chrono::high_resolution_clock::now();
+
+        OpenCVMatrices matrices;
+        auto fromCache = useCache && LoadMatricesCache(filename, matrices);
+        if (!fromCache) {
+            tinyxml2::XMLDocument doc;
+            LoadXMLDocument(docName, filename, doc);
+            auto storage = doc.FirstChildElement("opencv_storage");
+            if (storage == nullptr) throw std::runtime_error(docName + " file is not an OpenCV file.");
+
+            for (auto element = storage->FirstChildElement(); element != nullptr; element = element->NextSiblingElement()) {
+                OpenCVMatrix matrix;
+                if (ParseMatrix(element, matrix)) matrices.emplace(element->Name(), std::move(matrix));
+            }
+            if (useCache) SaveMatricesCache(filename, matrices);
+        }
+
+        auto loadTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        LOG(INFO) << docName << ": loaded " << matrices.size() << " matrices " << (fromCache ? "from cache" : "from XML") << " in " << loadTime << "ms.";
+        return matrices;
+    }
+
     std::string OpenCVParserHelper::ParseTextString(tinyxml2::XMLElement* element)
     {
         std::string result = element->GetText();
@@ -28,73 +178,136 @@ namespace viscom {
 
     std::vector<float> OpenCVParserHelper::ParseVectorf(tinyxml2::XMLElement * element)
     {
-        std::vector<float> result;
-
-        std::string typeId = element->Attribute("type_id");
-        if (typeId != "opencv-matrix") throw std::runtime_error("Not a OpenCV matrix.");
-
-        if (1 != Parse<int>(element->FirstChildElement("cols"))) throw std::runtime_error("Too many columns.");
-        std::string dtStr = element->FirstChildElement("dt")->GetText();
-        if ("f" != dtStr) throw std::runtime_error("Wrong type.");
-        auto rowsVal = element->FirstChildElement("rows");
-        result.resize(Parse<size_t>(element->FirstChildElement("rows")));
-
-        std::stringstream dataStream(element->FirstChildElement("data")->GetText());
-        float x;
-        size_t i = 0;
-        while (dataStream >> x) {
-            result[i++] = x;
-        }
+        std::vector<float> result(CheckVector(element, "f"));
+        ParseFloats(element->FirstChildElement("data")->GetText(), result.size(), result.data());
         return result;
     }
 
     std::vector<glm::vec2> OpenCVParserHelper::ParseVector2f(tinyxml2::XMLElement* element)
     {
-        std::vector<glm::vec2> result;
+        std::vector<float> values(2 * CheckVector(element, "2f"));
+        ParseFloats(element->FirstChildElement("data")->GetText(), values.size(), values.data());
 
-        std::string typeId = element->Attribute("type_id");
-        if (typeId != "opencv-matrix") throw std::runtime_error("Not a OpenCV matrix.");
+        std::vector<glm::vec2> result(values.size() / 2);
+        for (std::size_t i = 0; i < result.size(); ++i) result[i] = glm::vec2(values[2 * i], values[2 * i + 1]);
+        return result;
+    }
+
+    std::vector<glm::vec3> OpenCVParserHelper::ParseVector3f(tinyxml2::XMLElement* element)
+    {
+        std::vector<float> values(3 * CheckVector(element, "3f"));
+        ParseFloats(element->FirstChildElement("data")->GetText(), values.size(), values.data());
 
-        if (1 != Parse<int>(element->FirstChildElement("cols"))) throw std::runtime_error("Too many columns.");
-        if ("2f" != ParseTextString(element->FirstChildElement("dt"))) throw std::runtime_error("Wrong type.");
+        std::vector<glm::vec3> result(values.size() / 3);
+        for (std::size_t i = 0; i < result.size(); ++i) result[i] = glm::vec3(values[3 * i], values[3 * i + 1], values[3 * i + 2]);
+        return result;
+    }
 
-        result.resize(Parse<size_t>(element->FirstChildElement("rows")));
+    glm::vec2 OpenCVParserHelper::Parse2f(tinyxml2::XMLElement* element)
+    {
+        std::array<float, 2> values;
+        ParseFloats(element->GetText(), values.size(), values.data());
+        return glm::vec2(values[0], values[1]);
+    }
 
-        std::stringstream dataStream(element->FirstChildElement("data")->GetText());
-        float x, y;
-        size_t i = 0;
-        while (dataStream >> x >> y) {
-            result[i++] = glm::vec2(x, y);
-        }
+    std::vector<float> OpenCVParserHelper::GetVectorf(const OpenCVMatrices& matrices, const std::string& name)
+    {
+        return GetMatrix(matrices, name, 1).data_;
+    }
+
+    std::vector<glm::vec2> OpenCVParserHelper::GetVector2f(const OpenCVMatrices& matrices, const std::string& name)
+    {
+        const auto& values = GetMatrix(matrices, name, 2).data_;
+        std::vector<glm::vec2> result(values.size() / 2);
+        for (std::size_t i = 0; i < result.size(); ++i) result[i] = glm::vec2(values[2 * i], values[2 * i + 1]);
         return result;
     }
 
-    std::vector<glm::vec3> OpenCVParserHelper::ParseVector3f(tinyxml2::XMLElement* element)
+    std::vector<glm::vec3> OpenCVParserHelper::GetVector3f(const OpenCVMatrices& matrices, const std::string& name)
+    {
+        const auto& values = GetMatrix(matrices, name, 3).data_;
+        std::vector<glm::vec3> result(values.size() / 3);
+        for (std::size_t i = 0; i < result.size(); ++i) result[i] = glm::vec3(values[3 * i], values[3 * i + 1], values[3 * i + 2]);
+        return result;
+    }
+
+    const OpenCVMatrix& OpenCVParserHelper::GetMatrix(const OpenCVMatrices& matrices, const std::string& name, std::size_t numChannels)
     {
-        std::vector<glm::vec3> result;
+        auto matrix = matrices.find(name);
+        if (matrix == matrices.end()) throw std::runtime_error("Matrix not found (" + name + ").");
+        if (matrix->second.numChannels_ != numChannels) throw std::runtime_error("Wrong type (" + name + ").");
+        return matrix->second;
+    }
 
-        std::string typeId = element->Attribute("type_id");
-        if (typeId != "opencv-matrix") throw std::runtime_error("Not a OpenCV matrix.");
+    /** Reads the matrices from the cache of an XML file, returns false if there is no valid cache. */
+    bool OpenCVParserHelper::LoadMatricesCache(const std::string& filename, OpenCVMatrices& matrices)
+    {
+        namespace fs = std::experimental::filesystem;
+        auto cacheFilename = filename + CACHE_EXTENSION;
+        std::error_code ec;
+        if (!fs::exists(cacheFilename, ec) || !fs::exists(filename, ec)) return false;
 
-        if (1 != Parse<int>(element->FirstChildElement("cols"))) throw std::runtime_error("Too many columns.");
-        if ("3f" != ParseTextString(element->FirstChildElement("dt"))) throw std::runtime_error("Wrong type.");
+        try {
+            std::ifstream file(cacheFilename, std::ios::binary);
+            CacheHeader header;
+            ReadCache(file, &header, 1);
+            if (header.magic_ != CACHE_MAGIC || header.version_ != CACHE_VERSION
+                || header.sourceSize_ != static_cast<std::uint64_t>(fs::file_size(filename))
+                || header.sourceWriteTime_ != static_cast<std::int64_t>(fs::last_write_time(filename).time_since_epoch().count())) {
+                LOG(INFO) << "Matrix cache is outdated (" << cacheFilename << ").";
+                return false;
+            }
 
-        result.resize(Parse<size_t>(element->FirstChildElement("rows")));
+            // sizes are checked against the file size, so corrupt caches do not allocate arbitrary amounts of memory.
+            auto cacheSize = static_cast<std::uint64_t>(fs::file_size(cacheFilename));
+            for (std::uint64_t i = 0; i < header.numMatrices_; ++i) {
+                std::array<std::uint64_t, 3> sizes; // name length, number of channels, number of values.
+                ReadCache(file, sizes.data(), sizes.size());
+                if (sizes[0] > cacheSize || sizes[2] > cacheSize / sizeof(float)) throw std::runtime_error("Invalid matrix size.");
 
-        std::stringstream dataStream(element->FirstChildElement("data")->GetText());
-        float x, y, z;
-        size_t i = 0;
-        while (dataStream >> x >> y >> z) {
-            result[i++] = glm::vec3(x, y, z);
+                std::string name(static_cast<std::size_t>(sizes[0]), '\0');
+                ReadCache(file, &name[0], name.size());
+                OpenCVMatrix matrix;
+                matrix.numChannels_ = static_cast<std::size_t>(sizes[1]);
+                matrix.data_.resize(static_cast<std::size_t>(sizes[2]));
+                ReadCache(file, matrix.data_.data(), matrix.data_.size());
+                matrices.emplace(std::move(name), std::move(matrix));
+            }
+            return true;
+        } catch (const std::exception& e) {
+            LOG(WARNING) << "Could not read matrix cache (" << cacheFilename << "): " << e.what();
+            matrices.clear();
+            return false;
         }
-        return result;
     }
 
-    glm::vec2 OpenCVParserHelper::Parse2f(tinyxml2::XMLElement* element)
+    /** Writes the matrices to the cache of an XML file, failures only disable the cache. */
+    void OpenCVParserHelper::SaveMatricesCache(const std::string& filename, const OpenCVMatrices& matrices)
     {
-        std::stringstream dataStream(element->GetText());
-        float x, y;
-        dataStream >> x >> y;
-        return glm::vec2(x, y);
+        namespace fs = std::experimental::filesystem;
+        auto cacheFilename = filename + CACHE_EXTENSION;
+        // other nodes may read the cache concurrently, so it is written to a temporary file that replaces it.
+        auto tmpFilename = cacheFilename + "." + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+
+        try {
+            CacheHeader header{ CACHE_MAGIC, CACHE_VERSION, static_cast<std::uint64_t>(fs::file_size(filename)),
+                static_cast<std::int64_t>(fs::last_write_time(filename).time_since_epoch().count()), matrices.size() };
+            {
+                std::ofstream file(tmpFilename, std::ios::binary);
+                WriteCache(file, &header, 1);
+                for (const auto& matrix : matrices) {
+                    std::array<std::uint64_t, 3> sizes{ { matrix.first.size(), matrix.second.numChannels_, matrix.second.data_.size() } };
+                    WriteCache(file, sizes.data(), sizes.size());
+                    WriteCache(file, matrix.first.data(), matrix.first.size());
+                    WriteCache(file, matrix.second.data_.data(), matrix.second.data_.size());
+                }
+                if (!file) throw std::runtime_error("Could not write file.");
+            }
+            fs::rename(tmpFilename, cacheFilename);
+        } catch (const std::exception& e) {
+            LOG(WARNING) << "Could not write matrix cache (" << cacheFilename << "): " << e.what();
+            std::error_code ec;
+            fs::remove(tmpFilename, ec);
+        }
     }
 }
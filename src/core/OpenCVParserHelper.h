@@ -10,13 +10,27 @@
 
 #include "main.h"
 #include <external/tinyxml2.h>
+#include <map>
 
 namespace viscom {
 
+    /** A float matrix of an OpenCV XML file. */
+    struct OpenCVMatrix
+    {
+        /** The number of channels (e.g., 3 for "3f"). */
+        std::size_t numChannels_ = 1;
+        /** The values of all rows, columns and channels. */
+        std::vector<float> data_;
+    };
+
+    /** The float matrices of an OpenCV XML file by name. */
+    using OpenCVMatrices = std::map<std::string, OpenCVMatrix>;
+
     class OpenCVParserHelper final
     {
     public:
         static void LoadXMLDocument(const std::string& docName, const std::string& filename, tinyxml2::XMLDocument& doc);
+        static OpenCVMatrices LoadMatrices(const std::string& docName, const std::string& filename, bool useCache);
         static std::string ParseTextString(tinyxml2::XMLElement* element);
         template<typename T> static T ParseText(tinyxml2::XMLElement* element);
         template<typename T> static T Parse(tinyxml2::XMLElement* element);
@@ -27,7 +41,15 @@ namespace viscom {
 
         static glm::vec2 Parse2f(tinyxml2::XMLElement* element);
 
+        static std::vector<float> GetVectorf(const OpenCVMatrices& matrices, const std::string& name);
+        static std::vector<glm::vec2> GetVector2f(const OpenCVMatrices& matrices, const std::string& name);
+        static std::vector<glm::vec3> GetVector3f(const OpenCVMatrices& matrices, const std::string& name);
+
     private:
+        static const OpenCVMatrix& GetMatrix(const OpenCVMatrices& matrices, const std::string& name, std::size_t numChannels);
+        static bool LoadMatricesCache(const std::string& filename, OpenCVMatrices& matrices);
+        static void SaveMatricesCache(const std::string& filename, const OpenCVMatrices& matrices);
+
         OpenCVParserHelper() = default;
         ~OpenCVParserHelper() = default;
     };
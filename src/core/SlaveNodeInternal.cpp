@@ -10,14 +10,73 @@
 
 #include "SlaveNodeInternal.h"
 #include "core/OpenCVParserHelper.h"
-#include <fstream>
+#include "core/BlendMask.h"
 #include <imgui.h>
 #include "core/imgui/imgui_impl_glfw_gl3.h"
 #include <experimental/filesystem>
+#include "core/gfx/GLStateCache.h"
+#include "core/gfx/RenderTargetPool.h"
+#include "core/gfx/StreamingBuffer.h"
+#include "core/gfx/UniformBuffers.h"
 #include "core/open_gl.h"
+#include <algorithm>
+#include <array>
 
 namespace viscom {
 
+    namespace {
+        /** A supported internal format of the scene frame buffers. */
+        struct SceneFormat
+        {
+            /** The name used in the configuration. */
+            const char* name_;
+            /** The internal format. */
+            GLenum internalFormat_;
+            /** The bytes per pixel of the color texture. */
+            std::size_t bytesPerPixel_;
+        };
+
+        /** The scene formats, ordered by precision. */
+        const std::array<SceneFormat, 4> SCENE_FORMATS{ {
+            { "RGBA32F", GL_RGBA32F, 16 },
+            { "RGBA16F", GL_RGBA16F, 8 },
+            { "RGB10_A2", GL_RGB10_A2, 4 },
+            { "SRGB8_ALPHA8", GL_SRGB8_ALPHA8, 4 }
+        } };
+        /** The bytes per pixel of the depth render buffer. */
+        constexpr std::size_t SCENE_DEPTH_BYTES_PER_PIXEL = 4;
+        /** The frames rendered with a format before measuring it. */
+        constexpr std::size_t BENCHMARK_WARMUP_FRAMES = 30;
+        /** The frames measured for each format. */
+        constexpr std::size_t BENCHMARK_FRAMES = 300;
+        /** The maximum difference of the baked blend weights to the alpha texture before a warning is logged. */
+        constexpr float WARP_GRID_MAX_BLEND_WEIGHT_ERROR = 0.05f;
+        /** The size of the chunks blend masks are decoded and uploaded in. */
+        constexpr std::size_t BLEND_MASK_UPLOAD_CHUNK_SIZE = 1024 * 1024;
+
+        const SceneFormat* FindSceneFormat(const std::string& name)
+        {
+            auto format = std::find_if(SCENE_FORMATS.begin(), SCENE_FORMATS.end(), [&name](const SceneFormat& f) { return name == f.name_; });
+            return format == SCENE_FORMATS.end() ? nullptr : &(*format);
+        }
+
+        /** Returns the internal format and the pixel type for uploading a blend mask. */
+        std::pair<GLenum, GLenum> GetBlendMaskUploadFormat(BlendMaskFormat format)
+        {
+            switch (format) {
+            case BlendMaskFormat::R8:
+                return std::make_pair(GL_R8, GL_UNSIGNED_BYTE);
+            case BlendMaskFormat::R16:
+                return std::make_pair(GL_R16, GL_UNSIGNED_SHORT);
+            case BlendMaskFormat::R16F:
+                return std::make_pair(GL_R16F, GL_HALF_FLOAT);
+            default:
+                // legacy blend weights are in [0, 1], 16 bit normalized is precise enough and halves the memory.
+                return std::make_pair(GL_R16, GL_FLOAT);
+            }
+        }
+    }
+
     SlaveNodeInternal::SlaveNodeInternal(ApplicationNodeInternal* appNode) :
         ApplicationNodeImplementation{ appNode }
     {
@@ -36,8 +95,7 @@ namespace viscom {
         calibrationSceneTexLoc_ = calibrationProgram_->getUniformLocation("tex");
 
         LOG(DBUG) << "Loading projector data.";
-        tinyxml2::XMLDocument doc;
-        OpenCVParserHelper::LoadXMLDocument("Projector data", GetConfig().projectorData_, doc);
+        auto calibrationData = OpenCVParserHelper::LoadMatrices("Projector data", GetConfig().projectorData_, GetConfig().calibrationCache_);
         std::experimental::filesystem::path projectorDataPath(GetConfig().projectorData_);
         auto alphaTexturePath = projectorDataPath.parent_path();
 
@@ -46,9 +104,17 @@ namespace viscom {
         auto numWindows = sgct_core::ClusterManager::instance()->getThisNodePtr()->getNumberOfWindows();
         projectorViewport_.resize(numWindows);
         sceneFBOs_.reserve(numWindows);
+        auto sceneFormat = FindSceneFormat(GetConfig().sceneFormat_);
+        if (sceneFormat == nullptr) {
+            LOG(WARNING) << "Unknown scene format (" << GetConfig().sceneFormat_ << "), using RGBA32F.";
+            sceneFormat = &SCENE_FORMATS[0];
+        }
+        sceneFormat_ = sceneFormat->internalFormat_;
         alphaTextures_.resize(numWindows, 0);
+        warpGrids_.resize(numWindows);
 
         glGenTextures(static_cast<GLsizei>(numWindows), alphaTextures_.data());
+        StreamingBuffer blendMaskUploadBuffer{ BLEND_MASK_UPLOAD_CHUNK_SIZE };
 
         for (auto i = 0U; i < numWindows; ++i) {
             LOG(DBUG) << "Initializing viewport: " << i;
@@ -62,11 +128,11 @@ namespace viscom {
             auto viewportName = FWConfiguration::CALIBRATION_VIEWPORT_NAME + std::to_string(projectorNo);
             auto texAlphaFilename = alphaTexturePath.string() + "/" + FWConfiguration::CALIBRATION_ALPHA_TEXTURE_NAME + std::to_string(projectorNo) + ".bin";
 
-            auto screenQuadCoords = OpenCVParserHelper::ParseVector3f(doc.FirstChildElement("opencv_storage")->FirstChildElement(quadCornersName.c_str()));
-            auto screenQuadTexCoords = OpenCVParserHelper::ParseVector3f(doc.FirstChildElement("opencv_storage")->FirstChildElement(quadTexCoordsName.c_str()));
-            auto resolutionScalingV = OpenCVParserHelper::ParseVectorf(doc.FirstChildElement("opencv_storage")->FirstChildElement(resolutionScalingName.c_str()));
+            auto screenQuadCoords = OpenCVParserHelper::GetVector3f(calibrationData, quadCornersName);
+            auto screenQuadTexCoords = OpenCVParserHelper::GetVector3f(calibrationData, quadTexCoordsName);
+            auto resolutionScalingV = OpenCVParserHelper::GetVectorf(calibrationData, resolutionScalingName);
             glm::vec2 resolutionScaling(resolutionScalingV[0], resolutionScalingV[1]);
-            auto viewportv2 = OpenCVParserHelper::ParseVector2f(doc.FirstChildElement("opencv_storage")->FirstChildElement(viewportName.c_str()));
+            auto viewportv2 = OpenCVParserHelper::GetVector2f(calibrationData, viewportName);
             std::vector<glm::vec3> viewport;
             for (const auto& v : viewportv2) viewport.emplace_back(v, 0.0f);
             for (auto j = 0U; j < screenQuadCoords.size(); ++j) quadCoordsProjector_.emplace_back(screenQuadCoords[j], screenQuadTexCoords[j]);
@@ -84,36 +150,47 @@ namespace viscom {
             GetViewportQuadSize(i) = fboSize;
             GetViewportScaling(i) = totalScreenSize / GetConfig().virtualScreenSize_;
 
-            CreateProjectorFBO(i, fboSize);
-
             LOG(DBUG) << "VP Pos: " << projectorViewport_[i].position_.x << ", " << projectorViewport_[i].position_.y;
             LOG(DBUG) << "VP Size: " << GetViewportQuadSize(i).x << ", " << GetViewportQuadSize(i).y;
-            sceneFBOs_[i].SetStandardViewport(projectorViewport_[i].position_.x, projectorViewport_[i].position_.y, GetViewportQuadSize(i).x, GetViewportQuadSize(i).y);
             GetApplication()->GetFramebuffer(i).SetStandardViewport(projectorViewport_[i].position_.x, projectorViewport_[i].position_.y, projectorViewport_[i].size_.x, projectorViewport_[i].size_.y);
 
-            {
-                std::ifstream texAlphaFile(texAlphaFilename, std::ios::binary);
-                glm::u32vec2 textureSize;
-                std::vector<float> texAlphaData(projectorSize.x * projectorSize.y);
-
-                texAlphaFile.read(reinterpret_cast<char*>(&textureSize), sizeof(textureSize));
-                assert(textureSize.x == projectorSize.x && textureSize.y == projectorSize.y);
-                texAlphaFile.read(reinterpret_cast<char*>(texAlphaData.data()), sizeof(float) * texAlphaData.size());
-
-                glBindTexture(GL_TEXTURE_2D, alphaTextures_[i]);
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, projectorSize.x, projectorSize.y, 0, GL_RED, GL_FLOAT, texAlphaData.data());
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            }
+            // with a warp grid the alpha texture is only read (if present) to validate the baked blend weights.
+            if (LoadWarpGrid(i, projectorNo, calibrationData)) {
+                if (std::experimental::filesystem::exists(texAlphaFilename)) {
+                    BlendMaskReader blendMask(texAlphaFilename);
+                    assert(blendMask.GetSize().x == projectorSize.x && blendMask.GetSize().y == projectorSize.y);
+                    ValidateWarpGrid(i, projectorSize, blendMask);
+                }
+            } else LoadBlendMask(i, texAlphaFilename, projectorSize, blendMaskUploadBuffer);
 
 
             glBindTexture(GL_TEXTURE_2D, 0);
             glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
         }
 
+        if (GetConfig().layeredRendering_ && !IsLayeredRenderingSupported()) {
+            LOG(WARNING) << "The application does not support layered rendering, rendering windows separately.";
+        } else if (GetConfig().layeredRendering_ && !GLEW_ARB_shader_viewport_layer_array && !GLEW_AMD_vertex_shader_layer) {
+            LOG(WARNING) << "Layered rendering needs ARB_shader_viewport_layer_array, rendering windows separately.";
+        } else if (GetConfig().layeredRendering_) {
+            auto equalViewports = numWindows > 1 && numWindows <= PerLayerUniforms::MAX_LAYERS;
+            for (auto i = 1U; i < numWindows && equalViewports; ++i) {
+                equalViewports = GetViewportQuadSize(i) == GetViewportQuadSize(0) && projectorViewport_[i].position_ == projectorViewport_[0].position_;
+            }
+            if (equalViewports) {
+                LOG(INFO) << "Rendering " << numWindows << " windows in one pass.";
+                layeredRendering_ = true;
+                GetApplication()->SetNumRenderLayers(static_cast<unsigned int>(numWindows));
+                calibrationProgram_ = GetApplication()->GetGPUProgramManager().GetResource("calibrationRenderingLayered", std::vector<std::string>{ "calibrationRendering.vert", "calibrationRenderingLayered.frag" });
+                calibrationAlphaTexLoc_ = calibrationProgram_->getUniformLocation("alphaTex");
+                calibrationSceneTexLoc_ = calibrationProgram_->getUniformLocation("tex");
+                calibrationLayerLoc_ = calibrationProgram_->getUniformLocation("layer");
+            } else {
+                LOG(WARNING) << "Layered rendering needs 2 to " << PerLayerUniforms::MAX_LAYERS << " windows with equal viewports, rendering windows separately.";
+            }
+        }
+        CreateSceneFBOs(sceneFormat_);
+
         LOG(DBUG) << "Creating VBOs.";
         glGenBuffers(1, &vboProjectorQuads_);
         glBindBuffer(GL_ARRAY_BUFFER, vboProjectorQuads_);
@@ -127,6 +204,40 @@ namespace viscom {
         glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(CalbrationProjectorQuadVertex), reinterpret_cast<GLvoid*>(offsetof(CalbrationProjectorQuadVertex, texCoords_)));
         glBindVertexArray(0);
 
+        if (!warpGridIndices_.empty()) {
+            LOG(DBUG) << "Creating warp grid buffers.";
+            glGenBuffers(1, &vboWarpGrid_);
+            glBindBuffer(GL_ARRAY_BUFFER, vboWarpGrid_);
+            glBufferData(GL_ARRAY_BUFFER, warpGridVertices_.size() * sizeof(CalibrationWarpGridVertex), warpGridVertices_.data(), GL_STATIC_DRAW);
+
+            glGenVertexArrays(1, &vaoWarpGrid_);
+            glBindVertexArray(vaoWarpGrid_);
+            glGenBuffers(1, &iboWarpGrid_);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, iboWarpGrid_);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, warpGridIndices_.size() * sizeof(unsigned int), warpGridIndices_.data(), GL_STATIC_DRAW);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(CalibrationWarpGridVertex), reinterpret_cast<GLvoid*>(offsetof(CalibrationWarpGridVertex, position_)));
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(CalibrationWarpGridVertex), reinterpret_cast<GLvoid*>(offsetof(CalibrationWarpGridVertex, texCoords_)));
+            glEnableVertexAttribArray(2);
+            glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, sizeof(CalibrationWarpGridVertex), reinterpret_cast<GLvoid*>(offsetof(CalibrationWarpGridVertex, blendWeight_)));
+            glBindVertexArray(0);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+            if (layeredRendering_) warpGridProgram_ = GetApplication()->GetGPUProgramManager().GetResource("calibrationWarpGridLayered", std::vector<std::string>{ "calibrationWarpGrid.vert", "calibrationWarpGridLayered.frag" });
+            else warpGridProgram_ = GetApplication()->GetGPUProgramManager().GetResource("calibrationWarpGrid", std::vector<std::string>{ "calibrationWarpGrid.vert", "calibrationWarpGrid.frag" });
+            warpGridSceneTexLoc_ = warpGridProgram_->getUniformLocation("tex");
+            warpGridLayerLoc_ = warpGridProgram_->getUniformLocation("layer");
+        }
+
+        if (GetConfig().sceneFormatBenchmark_) {
+            LOG(INFO) << "Comparing scene formats.";
+            benchmark_.running_ = true;
+            benchmark_.queries_.resize(2 * numWindows, 0);
+            benchmark_.queryPending_.resize(numWindows, false);
+            glGenQueries(static_cast<GLsizei>(benchmark_.queries_.size()), benchmark_.queries_.data());
+        }
+
         LOG(DBUG) << "Calibration Initialized.";
 
         ApplicationNodeImplementation::InitOpenGL();
@@ -139,82 +250,373 @@ namespace viscom {
 
         GetEngine().UnbindCurrentWindowFBO();
 
-        ClearBuffer(sceneFBOs_[windowId]);
+        if (windowId == 0) UpdateSceneFormatBenchmark();
+        // the first window renders the scenes of all windows to the layers of one frame buffer.
+        if (layeredRendering_ && windowId != 0) return;
+
+        BeginSceneTiming(windowId);
+        // shading is done in linear space, the sRGB target stores it with more precision in the dark range.
+        if (sceneFormat_ == GL_SRGB8_ALPHA8) GLStateCache::Enable(GL_FRAMEBUFFER_SRGB);
+
+        auto& sceneFBO = GetSceneFBO(windowId);
+        if (layeredRendering_) {
+            PerLayerUniforms perLayer;
+            perLayer.numLayers_ = static_cast<int>(projectorViewport_.size());
+            for (auto i = 0U; i < projectorViewport_.size(); ++i) perLayer.viewProjectionMatrices_[i] = GetCamera()->GetWindowViewPerspectiveMatrix(i);
+            StandardUniforms::SetPerLayer(perLayer);
+            sceneFBO.SetRenderLayer(-1);
+        }
+
+        ClearBuffer(sceneFBO);
 
-        ApplicationNodeImplementation::DrawFrame(sceneFBOs_[windowId]);
+        ApplicationNodeImplementation::DrawFrame(sceneFBO);
     }
 
     void SlaveNodeInternal::Draw2D(FrameBuffer& fbo)
     {
         auto windowId = GetEngine().GetCurrentWindowId();
-        ApplicationNodeImplementation::Draw2D(sceneFBOs_[windowId]);
+        auto& sceneFBO = GetSceneFBO(windowId);
+        // 2D elements are drawn for each window to its own layer.
+        if (layeredRendering_) {
+            PerLayerUniforms perLayer;
+            perLayer.viewProjectionMatrices_[0] = GetCamera()->GetWindowViewPerspectiveMatrix(windowId);
+            perLayer.numLayers_ = 1;
+            StandardUniforms::SetPerLayer(perLayer);
+            sceneFBO.SetRenderLayer(static_cast<int>(windowId));
+        }
+        if (sceneFormat_ == GL_SRGB8_ALPHA8) GLStateCache::Enable(GL_FRAMEBUFFER_SRGB);
+        ApplicationNodeImplementation::Draw2D(sceneFBO);
 
 #ifdef VISCOM_CLIENTGUI
-        sceneFBOs_[windowId].DrawToFBO([]() {
+        sceneFBO.DrawToFBO([]() {
             ImGui::Render();
             ImGui_ImplGlfwGL3_RenderDrawData(ImGui::GetDrawData());
         });
 #endif
 
+        EndSceneTiming(windowId);
+        // sampling decodes the sRGB values again, so the calibration pass writes them unchanged.
+        if (sceneFormat_ == GL_SRGB8_ALPHA8) GLStateCache::Disable(GL_FRAMEBUFFER_SRGB);
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-        fbo.DrawToFBO([windowId, this]() {
-            GLboolean last_enable_depth_test = glIsEnabled(GL_DEPTH_TEST);
-            GLboolean last_enable_scissor_test = glIsEnabled(GL_SCISSOR_TEST);
-            GLboolean last_enable_stencil_test = glIsEnabled(GL_STENCIL_TEST);
+        fbo.DrawToFBO([windowId, &sceneFBO, this]() {
+            // Draw2D and ImGui may have changed the state directly.
+            GLStateCache::Invalidate();
+            auto last_enable_depth_test = glIsEnabled(GL_DEPTH_TEST) == GL_TRUE;
+            auto last_enable_scissor_test = glIsEnabled(GL_SCISSOR_TEST) == GL_TRUE;
+            auto last_enable_stencil_test = glIsEnabled(GL_STENCIL_TEST) == GL_TRUE;
 
-            glDisable(GL_SCISSOR_TEST);
-            glDisable(GL_STENCIL_TEST);
-            glDisable(GL_DEPTH_TEST);
+            GLStateCache::Disable(GL_SCISSOR_TEST);
+            GLStateCache::Disable(GL_STENCIL_TEST);
+            GLStateCache::Disable(GL_DEPTH_TEST);
 
             // Draw off screen texture to screen
-            {
-                glUseProgram(calibrationProgram_->getProgramId());
+            const auto& warpGrid = warpGrids_[windowId];
+            if (warpGrid.numIndices_ > 0) {
+                GLStateCache::UseProgram(warpGridProgram_->getProgramId());
+
+                GLStateCache::BindTexture(0, layeredRendering_ ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, sceneFBO.GetTextures()[0]);
+                glUniform1i(warpGridSceneTexLoc_, 0);
+                if (layeredRendering_) glUniform1i(warpGridLayerLoc_, static_cast<GLint>(windowId));
+
+                GLStateCache::BindVertexArray(vaoWarpGrid_);
+                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(warpGrid.numIndices_), GL_UNSIGNED_INT, reinterpret_cast<GLvoid*>(warpGrid.firstIndex_ * sizeof(unsigned int)));
+            } else {
+                GLStateCache::UseProgram(calibrationProgram_->getProgramId());
 
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, sceneFBOs_[windowId].GetTextures()[0]);
-                glActiveTexture(GL_TEXTURE1);
-                glBindTexture(GL_TEXTURE_2D, alphaTextures_[windowId]);
+                GLStateCache::BindTexture(0, layeredRendering_ ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, sceneFBO.GetTextures()[0]);
+                GLStateCache::BindTexture(1, GL_TEXTURE_2D, alphaTextures_[windowId]);
 
                 glUniform1i(calibrationSceneTexLoc_, 0);
                 glUniform1i(calibrationAlphaTexLoc_, 1);
+                if (layeredRendering_) glUniform1i(calibrationLayerLoc_, static_cast<GLint>(windowId));
 
-                glBindVertexArray(vaoProjectorQuads_);
+                GLStateCache::BindVertexArray(vaoProjectorQuads_);
                 glDrawArrays(GL_TRIANGLE_FAN, 4 * windowId, 4);
-                glBindVertexArray(0);
             }
+            GLStateCache::BindVertexArray(0);
 
-            if (last_enable_depth_test) glEnable(GL_DEPTH_TEST);
-            if (last_enable_scissor_test) glEnable(GL_SCISSOR_TEST);
-            if (last_enable_stencil_test) glEnable(GL_STENCIL_TEST);
+            GLStateCache::SetEnabled(GL_DEPTH_TEST, last_enable_depth_test);
+            GLStateCache::SetEnabled(GL_SCISSOR_TEST, last_enable_scissor_test);
+            GLStateCache::SetEnabled(GL_STENCIL_TEST, last_enable_stencil_test);
         });
     }
 
 
-    void SlaveNodeInternal::CreateProjectorFBO(size_t windowId, const glm::ivec2& fboSize)
+    /**
+     *  Loads the warp grid of a projector if the calibration data contains one. The grid is a row-major array of
+     *  vertices with screen coordinates, texture coordinates and the blend weight baked from the alpha texture.
+     *  @param windowId the window the projector belongs to.
+     *  @param projectorNo the global number of the projector.
+     *  @param calibrationData the matrices of the calibration data.
+     *  @return whether a warp grid was loaded.
+     */
+    bool SlaveNodeInternal::LoadWarpGrid(size_t windowId, unsigned int projectorNo, const OpenCVMatrices& calibrationData)
     {
-        FrameBufferDescriptor fbDesc;
-        fbDesc.texDesc_.emplace_back(GL_RGBA32F, GL_TEXTURE_2D);
-        fbDesc.rbDesc_.emplace_back(GL_DEPTH_COMPONENT32);
-        sceneFBOs_.emplace_back(fboSize.x, fboSize.y, fbDesc);
-        glBindTexture(GL_TEXTURE_2D, sceneFBOs_[windowId].GetTextures()[0]);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        auto gridSizeName = FWConfiguration::CALIBRATION_WARP_GRID_SIZE_NAME + std::to_string(projectorNo);
+        if (calibrationData.count(gridSizeName) == 0) return false;
+
+        auto gridCoordsName = FWConfiguration::CALIBRATION_WARP_GRID_COORDS_NAME + std::to_string(projectorNo);
+        auto gridTexCoordsName = FWConfiguration::CALIBRATION_WARP_GRID_TEX_COORDS_NAME + std::to_string(projectorNo);
+        auto gridBlendWeightsName = FWConfiguration::CALIBRATION_WARP_GRID_BLEND_WEIGHTS_NAME + std::to_string(projectorNo);
+
+        auto gridSizeV = OpenCVParserHelper::GetVectorf(calibrationData, gridSizeName);
+        if (gridSizeV.size() != 2 || gridSizeV[0] < 2.0f || gridSizeV[1] < 2.0f) {
+            LOG(WARNING) << "Invalid warp grid size for projector " << projectorNo << ".";
+            throw std::runtime_error("Invalid warp grid size for projector " + std::to_string(projectorNo) + ".");
+        }
+        auto cols = static_cast<unsigned int>(gridSizeV[0]);
+        auto rows = static_cast<unsigned int>(gridSizeV[1]);
+
+        auto gridCoords = OpenCVParserHelper::GetVector3f(calibrationData, gridCoordsName);
+        auto gridTexCoords = OpenCVParserHelper::GetVector3f(calibrationData, gridTexCoordsName);
+        auto gridBlendWeights = OpenCVParserHelper::GetVectorf(calibrationData, gridBlendWeightsName);
+        std::size_t numVertices = static_cast<std::size_t>(cols) * rows;
+        if (gridCoords.size() != numVertices || gridTexCoords.size() != numVertices || gridBlendWeights.size() != numVertices) {
+            LOG(WARNING) << "Warp grid of projector " << projectorNo << " does not match its size (" << cols << "x" << rows << ").";
+            throw std::runtime_error("Warp grid of projector " + std::to_string(projectorNo) + " does not match its size.");
+        }
+
+        auto& warpGrid = warpGrids_[windowId];
+        warpGrid.firstVertex_ = warpGridVertices_.size();
+        warpGrid.numVertices_ = numVertices;
+        warpGrid.firstIndex_ = warpGridIndices_.size();
+        for (std::size_t j = 0; j < numVertices; ++j) warpGridVertices_.emplace_back(gridCoords[j], gridTexCoords[j], gridBlendWeights[j]);
+
+        auto base = static_cast<unsigned int>(warpGrid.firstVertex_);
+        for (auto y = 0U; y < rows - 1; ++y) {
+            for (auto x = 0U; x < cols - 1; ++x) {
+                auto v0 = base + y * cols + x;
+                auto v1 = v0 + 1;
+                auto v2 = v0 + cols;
+                auto v3 = v2 + 1;
+                warpGridIndices_.insert(warpGridIndices_.end(), { v0, v1, v3, v0, v3, v2 });
+            }
+        }
+        warpGrid.numIndices_ = warpGridIndices_.size() - warpGrid.firstIndex_;
+
+        LOG(INFO) << "Using warp grid (" << cols << "x" << rows << ") for projector " << projectorNo << ".";
+        return true;
+    }
+
+    /**
+     *  Compares the baked blend weights of a warp grid to the alpha texture at the grid vertices and logs the maximum
+     *  difference. The vertices are sorted by row, so the alpha texture is read in one pass in chunks of rows and
+     *  only up to the last row containing a vertex.
+     *  @param windowId the window of the warp grid.
+     *  @param projectorSize the size of the alpha texture.
+     *  @param blendMask the reader of the alpha texture (no rows read yet).
+     */
+    void SlaveNodeInternal::ValidateWarpGrid(size_t windowId, const glm::uvec2& projectorSize, BlendMaskReader& blendMask) const
+    {
+        const auto& warpGrid = warpGrids_[windowId];
+        // the alpha texture pixel and the blend weight of each vertex.
+        std::vector<std::pair<glm::uvec2, float>> samples;
+        samples.reserve(warpGrid.numVertices_);
+        for (auto j = warpGrid.firstVertex_; j < warpGrid.firstVertex_ + warpGrid.numVertices_; ++j) {
+            const auto& vertex = warpGridVertices_[j];
+            auto pixel = glm::clamp(glm::ivec2((vertex.position_.xy() * 0.5f + 0.5f) * glm::vec2(projectorSize)), glm::ivec2(0), glm::ivec2(projectorSize) - 1);
+            samples.emplace_back(glm::uvec2(pixel), vertex.blendWeight_);
+        }
+        std::sort(samples.begin(), samples.end(), [](const auto& left, const auto& right) { return left.first.y < right.first.y; });
+
+        auto rowsPerChunk = static_cast<unsigned int>(glm::max(BLEND_MASK_UPLOAD_CHUNK_SIZE / (projectorSize.x * sizeof(float)), std::size_t{ 1 }));
+        auto maxError = 0.0f;
+        auto sample = samples.begin();
+        for (auto y = 0U; y < projectorSize.y && sample != samples.end(); y += rowsPerChunk) {
+            auto numRows = glm::min(rowsPerChunk, projectorSize.y - y);
+            auto rows = blendMask.ReadRowsf(numRows);
+            for (; sample != samples.end() && sample->first.y < y + numRows; ++sample) {
+                auto alpha = rows[static_cast<std::size_t>(sample->first.y - y) * projectorSize.x + sample->first.x];
+                maxError = glm::max(maxError, glm::abs(sample->second - alpha));
+            }
+        }
+
+        LOG(INFO) << "Warp grid of window " << windowId << ": maximum blend weight difference to alpha texture is " << maxError << ".";
+        if (maxError > WARP_GRID_MAX_BLEND_WEIGHT_ERROR) {
+            LOG(WARNING) << "Blend weights of the warp grid of window " << windowId << " differ from the alpha texture (" << maxError << ").";
+        }
+    }
+
+    /**
+     *  Loads a blend mask to the alpha texture of a window. The mask is decoded in chunks of rows that are streamed
+     *  to the texture through a pixel unpack buffer, so the whole mask is never held in memory.
+     *  @param windowId the window.
+     *  @param filename the name of the blend mask file (compact or legacy format).
+     *  @param projectorSize the size of the projector.
+     *  @param uploadBuffer the buffer for streaming the rows.
+     */
+    void SlaveNodeInternal::LoadBlendMask(size_t windowId, const std::string& filename, const glm::uvec2& projectorSize, StreamingBuffer& uploadBuffer)
+    {
+        BlendMaskReader blendMask(filename);
+        const auto& maskSize = blendMask.GetSize();
+        assert(maskSize.x == projectorSize.x && maskSize.y == projectorSize.y);
+        LOG(DBUG) << "Loading blend mask " << filename << (blendMask.IsLegacy() ? " (legacy format)." : ".");
+
+        auto[internalFormat, type] = GetBlendMaskUploadFormat(blendMask.GetFormat());
+        glBindTexture(GL_TEXTURE_2D, alphaTextures_[windowId]);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, maskSize.x, maskSize.y, 0, GL_RED, type, nullptr);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        auto bytesPerPixel = blendMask.GetBytesPerPixel();
+        auto rowSize = static_cast<std::size_t>(maskSize.x) * bytesPerPixel;
+        auto rowsPerChunk = static_cast<unsigned int>(glm::max(BLEND_MASK_UPLOAD_CHUNK_SIZE / rowSize, std::size_t{ 1 }));
+        std::vector<std::uint8_t> rows(rowsPerChunk * rowSize);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (auto y = 0U; y < maskSize.y; y += rowsPerChunk) {
+            auto numRows = glm::min(rowsPerChunk, maskSize.y - y);
+            blendMask.ReadRows(numRows, rows.data());
+            auto offset = uploadBuffer.Upload(rows.data(), numRows * rowSize, bytesPerPixel);
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadBuffer.GetBuffer());
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, maskSize.x, numRows, GL_RED, type, reinterpret_cast<GLvoid*>(offset));
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            // decoding the next chunk overlaps with the transfer of this one.
+            uploadBuffer.NextFrame();
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+
+    FrameBuffer SlaveNodeInternal::CreateProjectorFBO(size_t windowId, GLenum sceneFormat)
+    {
+        FrameBufferDescriptor fbDesc;
+        fbDesc.texDesc_.emplace_back(sceneFormat, GL_TEXTURE_2D);
+        fbDesc.rbDesc_.emplace_back(GL_DEPTH_COMPONENT32);
+        const auto& fboSize = GetViewportQuadSize(windowId);
+        FrameBuffer fbo{ static_cast<unsigned int>(fboSize.x), static_cast<unsigned int>(fboSize.y), fbDesc };
+        fbo.SetStandardViewport(projectorViewport_[windowId].position_.x, projectorViewport_[windowId].position_.y, fboSize.x, fboSize.y);
+        return fbo;
+    }
+
+    /**
+     *  Creates the frame buffers the scene is rendered to, one for each window or a layered one for all windows.
+     *  @param sceneFormat the internal format of the color texture.
+     */
+    void SlaveNodeInternal::CreateSceneFBOs(GLenum sceneFormat)
+    {
+        sceneFBOs_.clear();
+        if (!layeredRendering_) {
+            for (auto i = 0U; i < projectorViewport_.size(); ++i) sceneFBOs_.emplace_back(CreateProjectorFBO(i, sceneFormat));
+            return;
+        }
+
+        // layered frame buffers cannot use render buffers.
+        FrameBufferDescriptor fbDesc;
+        fbDesc.texDesc_.emplace_back(sceneFormat, GL_TEXTURE_2D_ARRAY);
+        fbDesc.texDesc_.emplace_back(GL_DEPTH_COMPONENT32F, GL_TEXTURE_2D_ARRAY);
+        fbDesc.numLayers_ = static_cast<unsigned int>(projectorViewport_.size());
+        const auto& fboSize = GetViewportQuadSize(0);
+        sceneFBOs_.emplace_back(static_cast<unsigned int>(fboSize.x), static_cast<unsigned int>(fboSize.y), fbDesc);
+        sceneFBOs_.back().SetStandardViewport(projectorViewport_[0].position_.x, projectorViewport_[0].position_.y, fboSize.x, fboSize.y);
+    }
+
+    /**
+     *  Starts measuring the GPU time of a windows scene if the format comparison is running. The time is measured with
+     *  timestamp queries, as GL_TIME_ELAPSED queries cannot be nested and the application may use them itself.
+     */
+    void SlaveNodeInternal::BeginSceneTiming(size_t windowId)
+    {
+        if (!benchmark_.running_) return;
+
+        auto beginQuery = benchmark_.queries_[2 * windowId];
+        auto endQuery = benchmark_.queries_[2 * windowId + 1];
+        if (benchmark_.queryPending_[windowId]) {
+            GLuint available = GL_FALSE;
+            glGetQueryObjectuiv(endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+            // skip this frame instead of waiting for the GPU.
+            if (available == GL_FALSE) return;
+
+            GLuint64 beginTime = 0, endTime = 0;
+            glGetQueryObjectui64v(beginQuery, GL_QUERY_RESULT, &beginTime);
+            glGetQueryObjectui64v(endQuery, GL_QUERY_RESULT, &endTime);
+            benchmark_.queryPending_[windowId] = false;
+            if (benchmark_.frames_ > BENCHMARK_WARMUP_FRAMES) {
+                benchmark_.gpuTime_ += endTime - beginTime;
+                benchmark_.numMeasurements_ += 1;
+            }
+        }
+
+        glQueryCounter(beginQuery, GL_TIMESTAMP);
+        benchmark_.queryPending_[windowId] = true;
+        benchmark_.queryActive_ = true;
+    }
+
+    /**
+     *  Stops measuring the GPU time of the current windows scene. With layered rendering the first window measures the
+     *  scenes of all windows.
+     */
+    void SlaveNodeInternal::EndSceneTiming(size_t windowId)
+    {
+        if (!benchmark_.queryActive_) return;
+        glQueryCounter(benchmark_.queries_[2 * windowId + 1], GL_TIMESTAMP);
+        benchmark_.queryActive_ = false;
+    }
+
+    /**
+     *  Advances the format comparison, called once per frame. Each format is rendered for a few frames before its GPU
+     *  time is measured. When all formats are measured, the results are logged and the configured format is restored.
+     */
+    void SlaveNodeInternal::UpdateSceneFormatBenchmark()
+    {
+        if (!benchmark_.running_) return;
+
+        if (benchmark_.frames_ == 0) {
+            sceneFormat_ = SCENE_FORMATS[benchmark_.format_].internalFormat_;
+            CreateSceneFBOs(sceneFormat_);
+        }
+        if (++benchmark_.frames_ <= BENCHMARK_WARMUP_FRAMES + BENCHMARK_FRAMES) return;
+
+        std::size_t numPixels = 0;
+        for (auto i = 0U; i < projectorViewport_.size(); ++i) numPixels += static_cast<std::size_t>(GetViewportQuadSize(i).x) * GetViewportQuadSize(i).y;
+        const auto& format = SCENE_FORMATS[benchmark_.format_];
+        auto vram = numPixels * (format.bytesPerPixel_ + SCENE_DEPTH_BYTES_PER_PIXEL);
+        if (benchmark_.numMeasurements_ > 0) {
+            auto gpuTimeMs = static_cast<double>(benchmark_.gpuTime_) / (1000000.0 * static_cast<double>(benchmark_.numMeasurements_));
+            auto passPixels = static_cast<double>(numPixels) / static_cast<double>(sceneFBOs_.size());
+            LOG(INFO) << "Scene format " << format.name_ << ": " << gpuTimeMs << "ms GPU time per scene pass, "
+                << (passPixels / (gpuTimeMs * 1000.0)) << " MPixel/s fill rate, " << (static_cast<double>(vram) / (1024.0 * 1024.0)) << "MB VRAM.";
+        } else {
+            LOG(INFO) << "Scene format " << format.name_ << ": no GPU time measured, " << (static_cast<double>(vram) / (1024.0 * 1024.0)) << "MB VRAM.";
+        }
+
+        benchmark_.frames_ = 0;
+        benchmark_.gpuTime_ = 0;
+        benchmark_.numMeasurements_ = 0;
+        if (++benchmark_.format_ < SCENE_FORMATS.size()) return;
+
+        benchmark_.running_ = false;
+        auto sceneFormat = FindSceneFormat(GetConfig().sceneFormat_);
+        sceneFormat_ = sceneFormat ? sceneFormat->internalFormat_ : GL_RGBA32F;
+        CreateSceneFBOs(sceneFormat_);
+        RenderTargetPool::Trim();
+        glDeleteQueries(static_cast<GLsizei>(benchmark_.queries_.size()), benchmark_.queries_.data());
+        benchmark_.queries_.clear();
+        benchmark_.queryPending_.clear();
     }
 
 
     void SlaveNodeInternal::CleanUp()
     {
-        if (vaoProjectorQuads_ != 0) glDeleteVertexArrays(0, &vaoProjectorQuads_);
+        if (vaoProjectorQuads_ != 0) glDeleteVertexArrays(1, &vaoProjectorQuads_);
         vaoProjectorQuads_ = 0;
-        if (vboProjectorQuads_ != 0) glDeleteBuffers(0, &vboProjectorQuads_);
+        if (vboProjectorQuads_ != 0) glDeleteBuffers(1, &vboProjectorQuads_);
         vboProjectorQuads_ = 0;
+        if (vaoWarpGrid_ != 0) glDeleteVertexArrays(1, &vaoWarpGrid_);
+        vaoWarpGrid_ = 0;
+        if (vboWarpGrid_ != 0) glDeleteBuffers(1, &vboWarpGrid_);
+        vboWarpGrid_ = 0;
+        if (iboWarpGrid_ != 0) glDeleteBuffers(1, &iboWarpGrid_);
+        iboWarpGrid_ = 0;
 
         if (!alphaTextures_.empty()) glDeleteTextures(static_cast<GLsizei>(alphaTextures_.size()), alphaTextures_.data());
         alphaTextures_.clear();
+        if (!benchmark_.queries_.empty()) glDeleteQueries(static_cast<GLsizei>(benchmark_.queries_.size()), benchmark_.queries_.data());
+        benchmark_.queries_.clear();
+        benchmark_.running_ = false;
 
         ApplicationNodeImplementation::CleanUp();
     }
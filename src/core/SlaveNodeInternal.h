@@ -10,9 +10,13 @@
 
 #include "app/ApplicationNodeImplementation.h"
 #include "core/CalibrationVertices.h"
+#include "core/OpenCVParserHelper.h"
 
 namespace viscom {
 
+    class BlendMaskReader;
+    class StreamingBuffer;
+
     class SlaveNodeInternal : public ApplicationNodeImplementation
     {
     public:
@@ -25,7 +29,15 @@ namespace viscom {
         void CleanUp() override;
 
     private:
-        void CreateProjectorFBO(size_t windowId, const glm::ivec2& fboSize);
+        FrameBuffer CreateProjectorFBO(size_t windowId, GLenum sceneFormat);
+        void CreateSceneFBOs(GLenum sceneFormat);
+        FrameBuffer& GetSceneFBO(size_t windowId) { return sceneFBOs_[layeredRendering_ ? 0 : windowId]; }
+        void BeginSceneTiming(size_t windowId);
+        void EndSceneTiming(size_t windowId);
+        void UpdateSceneFormatBenchmark();
+        bool LoadWarpGrid(size_t windowId, unsigned int projectorNo, const OpenCVMatrices& calibrationData);
+        void ValidateWarpGrid(size_t windowId, const glm::uvec2& projectorSize, BlendMaskReader& blendMask) const;
+        void LoadBlendMask(size_t windowId, const std::string& filename, const glm::uvec2& projectorSize, StreamingBuffer& uploadBuffer);
 
 
         /** Holds the viewport for rendering directly to the projector. */
@@ -40,14 +52,74 @@ namespace viscom {
         GLint calibrationAlphaTexLoc_ = -1;
         /** Holds the location of the use alpha test flag. */
         GLint calibrationSceneTexLoc_ = -1;
+        /** Holds the location of the layer of the scene texture (for layered rendering). */
+        GLint calibrationLayerLoc_ = -1;
 
         /** Holds the vertex buffer for the projector quads. */
         GLuint vboProjectorQuads_ = 0;
         /** Holds the vertex array object for the projector quads. */
         GLuint vaoProjectorQuads_ = 0;
-        /** Holds the frame buffers for rendering the scene into. */
+
+        /** The vertices and indices of a windows warp grid. */
+        struct WarpGrid
+        {
+            /** The first vertex of the grid. */
+            std::size_t firstVertex_ = 0;
+            /** The number of vertices (0 if the window uses the projector quad). */
+            std::size_t numVertices_ = 0;
+            /** The first index of the grid. */
+            std::size_t firstIndex_ = 0;
+            /** The number of indices. */
+            std::size_t numIndices_ = 0;
+        };
+        /** Holds the warp grid of each window. */
+        std::vector<WarpGrid> warpGrids_;
+        /** Holds the vertices of all warp grids. */
+        std::vector<CalibrationWarpGridVertex> warpGridVertices_;
+        /** Holds the triangle indices of all warp grids. */
+        std::vector<unsigned int> warpGridIndices_;
+        /** Holds the shader program for applying the calibration with a warp grid. */
+        std::shared_ptr<GPUProgram> warpGridProgram_;
+        /** Holds the location of the scene texture for warp grids. */
+        GLint warpGridSceneTexLoc_ = -1;
+        /** Holds the location of the layer of the scene texture for warp grids (for layered rendering). */
+        GLint warpGridLayerLoc_ = -1;
+        /** Holds the vertex buffer for the warp grids. */
+        GLuint vboWarpGrid_ = 0;
+        /** Holds the index buffer for the warp grids. */
+        GLuint iboWarpGrid_ = 0;
+        /** Holds the vertex array object for the warp grids. */
+        GLuint vaoWarpGrid_ = 0;
+        /** Holds the frame buffers for rendering the scene into (one layered frame buffer for layered rendering). */
         std::vector<FrameBuffer> sceneFBOs_;
+        /** Holds whether all windows are rendered in one pass to the layers of a single frame buffer. */
+        bool layeredRendering_ = false;
         /** Holds the alpha textures. */
         std::vector<GLuint> alphaTextures_;
+        /** Holds the internal format of the scene frame buffers. */
+        GLenum sceneFormat_ = 0;
+
+        /** Measures the GPU time of rendering the scene with each supported format, one after another. */
+        struct SceneFormatBenchmark
+        {
+            /** Flag if the comparison is running. */
+            bool running_ = false;
+            /** The index of the format currently measured. */
+            std::size_t format_ = 0;
+            /** The number of frames rendered with the current format. */
+            std::size_t frames_ = 0;
+            /** The timestamp queries at the begin and end of the scene of each window. */
+            std::vector<GLuint> queries_;
+            /** Flag for each window if its query has a result pending. */
+            std::vector<bool> queryPending_;
+            /** The accumulated GPU time of the current format in nanoseconds. */
+            std::uint64_t gpuTime_ = 0;
+            /** The number of measurements of the current format. */
+            std::size_t numMeasurements_ = 0;
+            /** Flag if the scene of a window is measured. */
+            bool queryActive_ = false;
+        };
+        /** Holds the state of the scene format comparison. */
+        SceneFormatBenchmark benchmark_;
     };
 }
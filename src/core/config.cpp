@@ -40,6 +40,10 @@ namespace viscom {
             else if (str == "NEAR_PLANE_SIZE_X=") ifs >> config.nearPlaneSize_.x;
             else if (str == "NEAR_PLANE_SIZE_Y=") ifs >> config.nearPlaneSize_.y;
             else if (str == "OPENGL_PROFILE=") ifs >> config.openglProfile_;
+            else if (str == "SCENE_FORMAT=") ifs >> config.sceneFormat_;
+            else if (str == "SCENE_FORMAT_BENCHMARK=") ifs >> config.sceneFormatBenchmark_;
+            else if (str == "LAYERED_RENDERING=") ifs >> config.layeredRendering_;
+            else if (str == "CALIBRATION_CACHE=") ifs >> config.calibrationCache_;
         }
         ifs.close();
 
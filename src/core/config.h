@@ -26,6 +26,10 @@ namespace viscom {
         static constexpr const char* CALIBRATION_QUAD_RESOLUTION_SCALING_NAME = "resolutionScaling";
         static constexpr const char* CALIBRATION_VIEWPORT_NAME = "viewport";
         static constexpr const char* CALIBRATION_ALPHA_TEXTURE_NAME = "alphaTexture";
+        static constexpr const char* CALIBRATION_WARP_GRID_SIZE_NAME = "warpGridSize";
+        static constexpr const char* CALIBRATION_WARP_GRID_COORDS_NAME = "warpGridCoords";
+        static constexpr const char* CALIBRATION_WARP_GRID_TEX_COORDS_NAME = "warpGridTexCoords";
+        static constexpr const char* CALIBRATION_WARP_GRID_BLEND_WEIGHTS_NAME = "warpGridBlendWeights";
 
         std::string baseDirectory_;
         std::string viscomConfigName_;
@@ -39,6 +43,10 @@ namespace viscom {
         glm::vec2 nearPlaneSize_;
         std::vector<std::string> resourceSearchPaths_;
         std::string openglProfile_;
+        std::string sceneFormat_ = "RGBA32F";
+        bool sceneFormatBenchmark_ = false;
+        bool layeredRendering_ = false;
+        bool calibrationCache_ = false;
     };
 
     FWConfiguration LoadConfiguration(const std::string& configFilename);
@@ -7,7 +7,10 @@
  */
 
 #include "FrameBuffer.h"
+#include "GLStateCache.h"
+#include "RenderTargetPool.h"
 #include "core/open_gl.h"
+#include <cassert>
 
 namespace viscom {
 
@@ -50,6 +53,7 @@ namespace viscom {
     {
         for (auto& texDesc : desc_.texDesc_) {
             if (texDesc.texType_ == GL_TEXTURE_2D && desc_.numSamples_ != 1) texDesc.texType_ = GL_TEXTURE_2D_MULTISAMPLE;
+            if (texDesc.texType_ == GL_TEXTURE_2D_ARRAY && desc_.numSamples_ != 1) texDesc.texType_ = GL_TEXTURE_2D_MULTISAMPLE_ARRAY;
         }
         Resize(fbWidth, fbHeight);
     }
@@ -63,7 +67,8 @@ namespace viscom {
         isBackbuffer_(orig.isBackbuffer_),
         desc_(orig.desc_),
         width_(0),
-        height_(0)
+        height_(0),
+        renderLayer_(orig.renderLayer_)
     {
         Resize(orig.width_, orig.height_);
     }
@@ -81,7 +86,8 @@ namespace viscom {
         renderBuffers_(std::move(orig.renderBuffers_)),
         standardViewport_(orig.standardViewport_),
         width_(orig.width_),
-        height_(orig.height_)
+        height_(orig.height_),
+        renderLayer_(orig.renderLayer_)
     {
         orig.fbo_ = 0;
         orig.desc_ = FrameBufferDescriptor();
@@ -119,6 +125,7 @@ namespace viscom {
             standardViewport_ = orig.standardViewport_;
             width_ = orig.width_;
             height_ = orig.height_;
+            renderLayer_ = orig.renderLayer_;
         }
         return *this;
     }
@@ -128,14 +135,20 @@ namespace viscom {
      */
     FrameBuffer::~FrameBuffer()
     {
-        glDeleteTextures(static_cast<GLsizei>(textures_.size()), textures_.data());
-        textures_.clear();
-        glDeleteRenderbuffers(static_cast<GLsizei>(renderBuffers_.size()), renderBuffers_.data());
-        renderBuffers_.clear();
+        ReleaseTargets();
         if (fbo_ != 0) glDeleteFramebuffers(1, &fbo_);
         fbo_ = 0;
     }
 
+    /** Returns the textures and render buffers to the RenderTargetPool. */
+    void FrameBuffer::ReleaseTargets()
+    {
+        for (std::size_t i = 0; i < textures_.size(); ++i) RenderTargetPool::Release(desc_.texDesc_[i].texType_, textures_[i]);
+        textures_.clear();
+        for (auto renderBuffer : renderBuffers_) RenderTargetPool::Release(GL_RENDERBUFFER, renderBuffer);
+        renderBuffers_.clear();
+    }
+
     /**
      * Resizes the frame buffer and re-initializes it if needed.
      * @param fbWidth the new width
@@ -150,61 +163,41 @@ namespace viscom {
 
         if (isBackbuffer_) return;
 
+        if (fbo_ != 0) glDeleteFramebuffers(1, &fbo_);
         glGenFramebuffers(1, &fbo_);
         glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
         unsigned int colorAtt = 0;
         drawBuffers_.clear();
-        glDeleteTextures(static_cast<GLsizei>(textures_.size()), textures_.data());
-        textures_.clear();
-        textures_.resize(desc_.texDesc_.size(), 0);
-        glGenTextures(static_cast<GLsizei>(textures_.size()), textures_.data());
-        for (std::size_t i = 0; i < textures_.size(); ++i) {
-            glBindTexture(desc_.texDesc_[i].texType_, textures_[i]);
-            glTexParameteri(desc_.texDesc_[i].texType_, GL_TEXTURE_BASE_LEVEL, 0);
-            glTexParameteri(desc_.texDesc_[i].texType_, GL_TEXTURE_MAX_LEVEL, 0);
-            glTexParameteri(desc_.texDesc_[i].texType_, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-            glTexParameteri(desc_.texDesc_[i].texType_, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(desc_.texDesc_[i].texType_, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-            glTexParameteri(desc_.texDesc_[i].texType_, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-            glTexParameteri(desc_.texDesc_[i].texType_, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-
-            GLenum fmt = GL_RGBA;
-            GLenum tp = GL_FLOAT;
-            if (isDepthStencil(desc_.texDesc_[i].internalFormat_)) {
-                fmt = GL_DEPTH_COMPONENT; tp = GL_UNSIGNED_BYTE;
-            }
-
-            if (desc_.texDesc_[i].texType_ == GL_TEXTURE_CUBE_MAP) {
-                for (auto i = 0; i < 6; ++i) {
-                    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, desc_.texDesc_[i].internalFormat_, width_, height_, 0, GL_RGBA, GL_FLOAT, nullptr);
-                }
-            } else {
-                if (desc_.numSamples_ == 1) { glTexImage2D(desc_.texDesc_[i].texType_, 0, desc_.texDesc_[i].internalFormat_, width_, height_, 0, fmt, tp, nullptr); }
-                else { glTexImage2DMultisample(desc_.texDesc_[i].texType_, desc_.numSamples_, desc_.texDesc_[i].internalFormat_, width_, height_, GL_TRUE); }
+        ReleaseTargets();
+        for (const auto& texDesc : desc_.texDesc_) {
+            auto isArray = texDesc.texType_ == GL_TEXTURE_2D_ARRAY || texDesc.texType_ == GL_TEXTURE_2D_MULTISAMPLE_ARRAY;
+            auto texture = RenderTargetPool::Acquire(texDesc.texType_, texDesc.internalFormat_, width_, height_, desc_.numSamples_, isArray ? desc_.numLayers_ : 1);
+            textures_.push_back(texture);
+            GLStateCache::BindTexture(0, texDesc.texType_, texture);
+            if (texDesc.texType_ != GL_TEXTURE_2D_MULTISAMPLE && texDesc.texType_ != GL_TEXTURE_2D_MULTISAMPLE_ARRAY) {
+                glTexParameteri(texDesc.texType_, GL_TEXTURE_BASE_LEVEL, 0);
+                glTexParameteri(texDesc.texType_, GL_TEXTURE_MAX_LEVEL, 0);
+                glTexParameteri(texDesc.texType_, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                glTexParameteri(texDesc.texType_, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                glTexParameteri(texDesc.texType_, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+                glTexParameteri(texDesc.texType_, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+                glTexParameteri(texDesc.texType_, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
             }
 
-            if (desc_.texDesc_[i].texType_ == GL_TEXTURE_CUBE_MAP) {
-                for (auto i = 0; i < 6; ++i) {
-                    auto attachment = findAttachment(desc_.texDesc_[i].internalFormat_, colorAtt, drawBuffers_);
-                    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, textures_[i], 0);
+            if (texDesc.texType_ == GL_TEXTURE_CUBE_MAP) {
+                for (GLenum face = 0; face < 6; ++face) {
+                    auto attachment = findAttachment(texDesc.internalFormat_, colorAtt, drawBuffers_);
+                    glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, texture, 0);
                 }
             }
-            else {
-                auto attachment = findAttachment(desc_.texDesc_[i].internalFormat_, colorAtt, drawBuffers_);
-                glFramebufferTexture(GL_FRAMEBUFFER, attachment, textures_[i], 0);
-            }
+            else AttachTexture(findAttachment(texDesc.internalFormat_, colorAtt, drawBuffers_), texDesc.texType_, texture);
         }
 
-        glDeleteRenderbuffers(static_cast<GLsizei>(renderBuffers_.size()), renderBuffers_.data());
-        renderBuffers_.clear();
-        renderBuffers_.resize(desc_.rbDesc_.size(), 0);
-        glGenRenderbuffers(static_cast<GLsizei>(renderBuffers_.size()), renderBuffers_.data());
-        for (std::size_t i = 0; i < renderBuffers_.size(); ++i) {
-            glBindRenderbuffer(GL_RENDERBUFFER, renderBuffers_[i]);
-            if (desc_.numSamples_ == 1) { glRenderbufferStorage(GL_RENDERBUFFER, desc_.rbDesc_[i].internalFormat_, width_, height_); }
-            else { glRenderbufferStorageMultisample(GL_RENDERBUFFER, desc_.numSamples_, desc_.rbDesc_[i].internalFormat_, width_, height_); }
-            auto attachment = findAttachment(desc_.rbDesc_[i].internalFormat_, colorAtt, drawBuffers_);
-            glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, renderBuffers_[i]);
+        for (const auto& rbDesc : desc_.rbDesc_) {
+            auto renderBuffer = RenderTargetPool::Acquire(GL_RENDERBUFFER, rbDesc.internalFormat_, width_, height_, desc_.numSamples_);
+            renderBuffers_.push_back(renderBuffer);
+            auto attachment = findAttachment(rbDesc.internalFormat_, colorAtt, drawBuffers_);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment, GL_RENDERBUFFER, renderBuffer);
         }
 
         if (drawBuffers_.empty()) {
@@ -221,6 +214,39 @@ namespace viscom {
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
     }
 
+    /**
+     *  Selects the layer of the array textures to render to. With -1 all layers are attached and the layer is
+     *  selected per primitive by the shaders (gl_Layer). Other attachments are not changed.
+     *  @param layer the layer or -1 for layered rendering.
+     */
+    void FrameBuffer::SetRenderLayer(int layer)
+    {
+        if (isBackbuffer_ || layer == renderLayer_) return;
+        assert(layer < static_cast<int>(desc_.numLayers_));
+        renderLayer_ = layer;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+        unsigned int colorAtt = 0;
+        std::vector<GLenum> drawBuffers;
+        for (std::size_t i = 0; i < textures_.size(); ++i) {
+            const auto& texDesc = desc_.texDesc_[i];
+            // cube maps use one attachment per face.
+            auto numAttachments = texDesc.texType_ == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+            for (auto j = 0; j < numAttachments; ++j) {
+                auto attachment = findAttachment(texDesc.internalFormat_, colorAtt, drawBuffers);
+                if (texDesc.texType_ == GL_TEXTURE_2D_ARRAY || texDesc.texType_ == GL_TEXTURE_2D_MULTISAMPLE_ARRAY) AttachTexture(attachment, texDesc.texType_, textures_[i]);
+            }
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    void FrameBuffer::AttachTexture(GLenum attachment, GLenum texType, GLuint texture) const
+    {
+        auto isArray = texType == GL_TEXTURE_2D_ARRAY || texType == GL_TEXTURE_2D_MULTISAMPLE_ARRAY;
+        if (isArray && renderLayer_ >= 0) glFramebufferTextureLayer(GL_FRAMEBUFFER, attachment, texture, 0, renderLayer_);
+        else glFramebufferTexture(GL_FRAMEBUFFER, attachment, texture, 0);
+    }
+
     /**
      * Use this frame buffer object as target for rendering.
      */
@@ -288,28 +314,4 @@ namespace viscom {
         return attachment;
     }
 
-    bool FrameBuffer::isDepthStencil(GLenum internalFormat)
-    {
-        switch (internalFormat)
-        {
-        case GL_DEPTH_STENCIL:
-        case GL_DEPTH24_STENCIL8:
-        case GL_DEPTH32F_STENCIL8:
-        case GL_DEPTH_COMPONENT:
-        case GL_DEPTH_COMPONENT16:
-        case GL_DEPTH_COMPONENT32:
-        case GL_DEPTH_COMPONENT24:
-        case GL_DEPTH_COMPONENT32F:
-        case GL_STENCIL_INDEX:
-        case GL_STENCIL_INDEX1:
-        case GL_STENCIL_INDEX4:
-        case GL_STENCIL_INDEX8:
-        case GL_STENCIL_INDEX16:
-            return true;
-        default:
-            return false;
-        }
-        return false;
-    }
-
 }
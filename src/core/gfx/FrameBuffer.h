@@ -48,6 +48,8 @@ namespace viscom {
         std::vector<RenderBufferDescriptor> rbDesc_;
         /** Holds the number of samples for the frame buffer. */
         unsigned int numSamples_ = 1;
+        /** Holds the number of layers of array textures (GL_TEXTURE_2D_ARRAY), render buffers cannot be layered. */
+        unsigned int numLayers_ = 1;
     };
 
     struct Viewport
@@ -86,6 +88,9 @@ namespace viscom {
         inline void DrawToFBO(const std::vector<std::size_t>& drawBufferIndices, viscom::function_view<void()> drawFn) const;
 
         void Resize(unsigned int fbWidth, unsigned int fbHeight);
+        void SetRenderLayer(int layer);
+        /** Returns the layer of the array textures rendered to, -1 if all layers are attached (layered rendering). */
+        int GetRenderLayer() const { return renderLayer_; }
         const std::vector<GLuint>& GetTextures() const { return textures_; }
         void SetStandardViewport(const Viewport& vp) { standardViewport_ = vp; }
         void SetStandardViewport(int x, int y, unsigned int sizex, unsigned int sizey) { standardViewport_.position_ = glm::ivec2(x, y); standardViewport_.size_ = glm::ivec2(sizex, sizey); }
@@ -96,8 +101,9 @@ namespace viscom {
         unsigned int GetHeight() const { return height_; };
 
     private:
+        void ReleaseTargets();
+        void AttachTexture(GLenum attachment, GLenum texType, GLuint texture) const;
         static unsigned int findAttachment(GLenum internalFormat, unsigned int& colorAtt, std::vector<GLenum> &drawBuffers);
-        static bool isDepthStencil(GLenum internalFormat);
 
         /** holds the frame buffers OpenGL name. */
         GLuint fbo_;
@@ -117,6 +123,8 @@ namespace viscom {
         unsigned int width_;
         /** holds the frame buffers height. */
         unsigned int height_;
+        /** Holds the layer of the array textures attached (-1 for all layers). */
+        int renderLayer_ = -1;
     };
 
     inline void viscom::FrameBuffer::DrawToFBO(viscom::function_view<void()> drawFn) const
@@ -9,6 +9,8 @@
 #include "FullscreenQuad.h"
 #include "core/ApplicationNodeBase.h"
 #include "core/ApplicationNodeInternal.h"
+#include "GLStateCache.h"
+#include "UniformBuffers.h"
 #include "core/open_gl.h"
 
 namespace viscom {
@@ -56,12 +58,14 @@ namespace viscom {
 
     void FullscreenQuad::Draw() const
     {
-        glDisable(GL_DEPTH_TEST);
+        GLStateCache::Invalidate();
+        GLStateCache::Disable(GL_DEPTH_TEST);
         glDepthMask(GL_FALSE);
-        glBindVertexArray(staticQuad_.dummyVAO_);
-        glDrawArrays(GL_TRIANGLES, 0, 3);
-        glBindVertexArray(0);
+        GLStateCache::BindVertexArray(staticQuad_.dummyVAO_);
+        // one instance for each layer (see fullScreenQuad.vert).
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 3, static_cast<GLsizei>(StandardUniforms::GetNumRenderLayers()));
+        GLStateCache::BindVertexArray(0);
         glDepthMask(GL_TRUE);
-        glEnable(GL_DEPTH_TEST);
+        GLStateCache::Enable(GL_DEPTH_TEST);
     }
 }
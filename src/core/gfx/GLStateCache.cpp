@@ -0,0 +1,152 @@
+/**
+ * @file   GLStateCache.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of a cache for OpenGL binding and enable state.
+ */
+
+#include "GLStateCache.h"
+#include "core/open_gl.h"
+
+namespace viscom {
+
+    namespace {
+        template<std::size_t N, typename T> std::array<T, N> FilledArray(T value)
+        {
+            std::array<T, N> result;
+            result.fill(value);
+            return result;
+        }
+    }
+
+    GLuint GLStateCache::program_ = GLStateCache::UNKNOWN_BINDING;
+    GLuint GLStateCache::vao_ = GLStateCache::UNKNOWN_BINDING;
+    GLuint GLStateCache::drawIndirectBuffer_ = GLStateCache::UNKNOWN_BINDING;
+    GLuint GLStateCache::activeTextureUnit_ = GLStateCache::UNKNOWN_BINDING;
+    std::array<GLuint, GLStateCache::MAX_TEXTURE_UNITS> GLStateCache::textures2D_ = FilledArray<GLStateCache::MAX_TEXTURE_UNITS>(GLStateCache::UNKNOWN_BINDING);
+    std::array<int, GLStateCache::NUM_CAPS> GLStateCache::capStates_ = FilledArray<GLStateCache::NUM_CAPS>(-1);
+    GLStateStatistics GLStateCache::statistics_;
+
+    /** Forgets all tracked state, so the next call of each kind is passed to OpenGL. */
+    void GLStateCache::Invalidate()
+    {
+        program_ = UNKNOWN_BINDING;
+        vao_ = UNKNOWN_BINDING;
+        drawIndirectBuffer_ = UNKNOWN_BINDING;
+        activeTextureUnit_ = UNKNOWN_BINDING;
+        textures2D_.fill(UNKNOWN_BINDING);
+        capStates_.fill(-1);
+    }
+
+    void GLStateCache::UseProgram(GLuint program)
+    {
+        if (program_ == program) {
+            statistics_.redundantCalls_ += 1;
+            return;
+        }
+        glUseProgram(program);
+        program_ = program;
+        statistics_.calls_ += 1;
+    }
+
+    void GLStateCache::BindVertexArray(GLuint vao)
+    {
+        if (vao_ == vao) {
+            statistics_.redundantCalls_ += 1;
+            return;
+        }
+        glBindVertexArray(vao);
+        vao_ = vao;
+        statistics_.calls_ += 1;
+    }
+
+    /**
+     *  Binds a buffer. Only GL_DRAW_INDIRECT_BUFFER is cached, other targets are mostly bound to upload data (or are
+     *  part of the vertex array state) and are always passed to OpenGL.
+     *  @param target the buffer target.
+     *  @param buffer the buffer to bind.
+     */
+    void GLStateCache::BindBuffer(GLenum target, GLuint buffer)
+    {
+        auto cached = target == GL_DRAW_INDIRECT_BUFFER;
+        if (cached && drawIndirectBuffer_ == buffer) {
+            statistics_.redundantCalls_ += 1;
+            return;
+        }
+        glBindBuffer(target, buffer);
+        if (cached) drawIndirectBuffer_ = buffer;
+        statistics_.calls_ += 1;
+    }
+
+    /**
+     *  Binds a texture to a texture unit. Only GL_TEXTURE_2D bindings are cached.
+     *  @param unit the texture unit (0 for GL_TEXTURE0).
+     *  @param target the texture target.
+     *  @param texture the texture to bind.
+     */
+    void GLStateCache::BindTexture(GLuint unit, GLenum target, GLuint texture)
+    {
+        auto cached = target == GL_TEXTURE_2D && unit < MAX_TEXTURE_UNITS;
+        if (cached && textures2D_[unit] == texture) {
+            statistics_.redundantCalls_ += 1;
+            return;
+        }
+
+        if (activeTextureUnit_ != unit) {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            activeTextureUnit_ = unit;
+            statistics_.calls_ += 1;
+        }
+        glBindTexture(target, texture);
+        if (cached) textures2D_[unit] = texture;
+        statistics_.calls_ += 1;
+    }
+
+    void GLStateCache::SetEnabled(GLenum cap, bool enable)
+    {
+        auto capIndex = GetCapIndex(cap);
+        auto state = enable ? 1 : 0;
+        if (capIndex < NUM_CAPS && capStates_[capIndex] == state) {
+            statistics_.redundantCalls_ += 1;
+            return;
+        }
+
+        if (enable) glEnable(cap);
+        else glDisable(cap);
+        if (capIndex < NUM_CAPS) capStates_[capIndex] = state;
+        statistics_.calls_ += 1;
+    }
+
+    /**
+     *  Returns whether a capability is enabled, only queries OpenGL if the state is not known.
+     *  @param cap the capability.
+     */
+    bool GLStateCache::IsEnabled(GLenum cap)
+    {
+        auto capIndex = GetCapIndex(cap);
+        if (capIndex < NUM_CAPS && capStates_[capIndex] != -1) {
+            statistics_.redundantCalls_ += 1;
+            return capStates_[capIndex] == 1;
+        }
+
+        auto enabled = glIsEnabled(cap) == GL_TRUE;
+        if (capIndex < NUM_CAPS) capStates_[capIndex] = enabled ? 1 : 0;
+        statistics_.calls_ += 1;
+        return enabled;
+    }
+
+    /** Returns the index of a tracked capability or NUM_CAPS if it is not tracked. */
+    std::size_t GLStateCache::GetCapIndex(GLenum cap)
+    {
+        switch (cap) {
+        case GL_CULL_FACE: return 0;
+        case GL_DEPTH_TEST: return 1;
+        case GL_BLEND: return 2;
+        case GL_SCISSOR_TEST: return 3;
+        case GL_STENCIL_TEST: return 4;
+        case GL_FRAMEBUFFER_SRGB: return 5;
+        default: return NUM_CAPS;
+        }
+    }
+}
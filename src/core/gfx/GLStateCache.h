@@ -0,0 +1,80 @@
+/**
+ * @file   GLStateCache.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of a cache for OpenGL binding and enable state.
+ */
+
+#pragma once
+
+#include "core/main.h"
+#include "core/open_gl_fwd.h"
+#include <array>
+#include <limits>
+
+namespace viscom {
+
+    /** Number of state changes passed to OpenGL and skipped by the state cache. */
+    struct GLStateStatistics
+    {
+        /** The number of calls passed to OpenGL. */
+        std::size_t calls_ = 0;
+        /** The number of calls skipped because the state was already set. */
+        std::size_t redundantCalls_ = 0;
+    };
+
+    /**
+     *  Tracks the current program, vertex array, indirect buffer binding, 2D texture bindings and the most common
+     *  enable bits, so redundant calls can be skipped. Framework code sets this state only through the cache.
+     *  Applications commonly change the tracked state directly between framework draws, so every framework draw
+     *  (MeshRenderable, RenderQueue::Flush, FullscreenQuad::Draw) invalidates the cache when it starts and only
+     *  redundant calls inside one draw are skipped. The framework also invalidates the cache at the start of every
+     *  draw callback (ClearBuffer, DrawFrame, Draw2D, PostDraw). Framework draws unbind their vertex array object
+     *  afterwards, so direct buffer binds cannot change it.
+     */
+    class GLStateCache
+    {
+    public:
+        static void Invalidate();
+
+        static void UseProgram(GLuint program);
+        static void BindVertexArray(GLuint vao);
+        static void BindBuffer(GLenum target, GLuint buffer);
+        static void BindTexture(GLuint unit, GLenum target, GLuint texture);
+        static void Enable(GLenum cap) { SetEnabled(cap, true); }
+        static void Disable(GLenum cap) { SetEnabled(cap, false); }
+        static void SetEnabled(GLenum cap, bool enable);
+        static bool IsEnabled(GLenum cap);
+
+        /** Returns the statistics accumulated since the last call to ResetStatistics() (e.g., once per frame). */
+        static const GLStateStatistics& GetStatistics() noexcept { return statistics_; }
+        static void ResetStatistics() noexcept { statistics_ = GLStateStatistics{}; }
+
+        /** The number of texture units tracked. */
+        static constexpr std::size_t MAX_TEXTURE_UNITS = 32;
+
+    private:
+        /** Marks a binding as unknown. */
+        static constexpr GLuint UNKNOWN_BINDING = std::numeric_limits<GLuint>::max();
+        /** The enable bits tracked. */
+        static constexpr std::size_t NUM_CAPS = 6;
+
+        static std::size_t GetCapIndex(GLenum cap);
+
+        /** The current program. */
+        static GLuint program_;
+        /** The current vertex array object. */
+        static GLuint vao_;
+        /** The current draw indirect buffer. */
+        static GLuint drawIndirectBuffer_;
+        /** The current active texture unit. */
+        static GLuint activeTextureUnit_;
+        /** The 2D texture bound to each unit. */
+        static std::array<GLuint, MAX_TEXTURE_UNITS> textures2D_;
+        /** The state of each enable bit (-1 if unknown). */
+        static std::array<int, NUM_CAPS> capStates_;
+        /** The statistics. */
+        static GLStateStatistics statistics_;
+    };
+}
@@ -9,7 +9,9 @@
 #include "GPUProgram.h"
 #include <iostream>
 #include "core/ApplicationNodeInternal.h"
+#include "core/gfx/GLStateCache.h"
 #include "core/gfx/Shader.h"
+#include "core/gfx/UniformBuffers.h"
 #include "core/open_gl.h"
 #include "core/utils/utils.h"
 
@@ -51,6 +53,7 @@ namespace viscom {
         if (this->program_ != 0) {
             glDeleteProgram(this->program_);
             this->program_ = 0;
+            GLStateCache::Invalidate();
         }
     }
 
@@ -98,6 +101,7 @@ namespace viscom {
         for (const auto& shader : shaders) {
             glDetachShader(program, shaderAccessor(shader));
         }
+        StandardUniforms::BindUniformBlocks(program);
         return program;
     }
 
@@ -149,6 +153,11 @@ namespace viscom {
         return result;
     }
 
+    bool GPUProgram::HasUniformBlock(const std::string& name) const
+    {
+        return glGetUniformBlockIndex(program_, name.c_str()) != GL_INVALID_INDEX;
+    }
+
     void GPUProgram::LoadProgram(viscom::function_view<std::unique_ptr<Shader>(const std::string&, const ApplicationNodeInternal*)> createShader)
     {
         ShaderList oldShaders = std::move(shaders_);
@@ -53,6 +53,9 @@ namespace viscom {
         std::vector<GLint> getAttributeLocations(const std::initializer_list<std::string>& names) const;
         std::vector<GLint> GetAttributeLocations(const std::vector<std::string>& names) const;
 
+        /** Returns whether the program uses a uniform block. */
+        bool HasUniformBlock(const std::string& name) const;
+
     protected:
         virtual void Load(std::optional<std::vector<std::uint8_t>>& data) override;
         virtual void LoadFromMemory(const void* data, std::size_t size) override;
@@ -0,0 +1,161 @@
+/**
+ * @file   RenderGraph.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of a graph of render passes with shared transient frame buffers.
+ */
+
+#include "RenderGraph.h"
+#include "core/open_gl.h"
+#include <algorithm>
+#include <cassert>
+
+namespace viscom {
+
+    namespace {
+        bool IsEqual(const FrameBufferDescriptor& left, const FrameBufferDescriptor& right)
+        {
+            if (left.numSamples_ != right.numSamples_ || left.numLayers_ != right.numLayers_
+                || left.texDesc_.size() != right.texDesc_.size() || left.rbDesc_.size() != right.rbDesc_.size()) return false;
+            for (std::size_t i = 0; i < left.texDesc_.size(); ++i) {
+                if (left.texDesc_[i].internalFormat_ != right.texDesc_[i].internalFormat_
+                    || left.texDesc_[i].texType_ != right.texDesc_[i].texType_) return false;
+            }
+            for (std::size_t i = 0; i < left.rbDesc_.size(); ++i) {
+                if (left.rbDesc_[i].internalFormat_ != right.rbDesc_[i].internalFormat_) return false;
+            }
+            return true;
+        }
+    }
+
+    /**
+     *  Adds a pass rendering to a transient frame buffer.
+     *  @param name the name of the pass.
+     *  @param inputs the textures read by the pass, rendered by earlier passes.
+     *  @param targetDesc the descriptor of the frame buffer to render to.
+     *  @param sizeDivisor the divisor of the full size for the frame buffer (e.g., 2 for half resolution).
+     *  @param passFunction the function drawing the pass.
+     *  @return the index of the pass.
+     */
+    std::size_t RenderGraph::AddPass(const std::string& name, const std::vector<RenderGraphResource>& inputs,
+        const FrameBufferDescriptor& targetDesc, unsigned int sizeDivisor, PassFunction passFunction)
+    {
+        Pass pass;
+        pass.name_ = name;
+        pass.inputs_ = inputs;
+        pass.targetDesc_ = targetDesc;
+        pass.sizeDivisor_ = glm::max(sizeDivisor, 1U);
+        pass.passFunction_ = std::move(passFunction);
+        for ([[maybe_unused]] const auto& input : inputs) {
+            assert(input.pass_ < passes_.size() && !passes_[input.pass_].isOutput_);
+        }
+        passes_.emplace_back(std::move(pass));
+        compiled_ = false;
+        return passes_.size() - 1;
+    }
+
+    /**
+     *  Adds a pass rendering to the output frame buffer. Only passes output passes depend on are executed.
+     *  @param name the name of the pass.
+     *  @param inputs the textures read by the pass, rendered by earlier passes.
+     *  @param passFunction the function drawing the pass.
+     *  @return the index of the pass.
+     */
+    std::size_t RenderGraph::AddOutputPass(const std::string& name, const std::vector<RenderGraphResource>& inputs, PassFunction passFunction)
+    {
+        auto pass = AddPass(name, inputs, FrameBufferDescriptor{}, 1, std::move(passFunction));
+        passes_[pass].isOutput_ = true;
+        return pass;
+    }
+
+    /**
+     *  Marks a texture as used after Execute() (e.g., in Draw2D), so its pass is executed and its frame buffer is not
+     *  shared with later passes. The texture is valid until the next call to Execute().
+     *  @param resource the texture.
+     */
+    void RenderGraph::KeepResource(const RenderGraphResource& resource)
+    {
+        assert(resource.pass_ < passes_.size() && !passes_[resource.pass_].isOutput_);
+        passes_[resource.pass_].isKept_ = true;
+        compiled_ = false;
+    }
+
+    /** Determines the passes to execute and assigns shared frame buffers, called by Execute() if needed. */
+    void RenderGraph::Compile()
+    {
+        // inputs always reference earlier passes, so one backwards sweep finds all passes an output depends on.
+        for (auto& pass : passes_) pass.executed_ = pass.isOutput_ || pass.isKept_;
+        for (auto p = passes_.size(); p > 0; --p) {
+            if (!passes_[p - 1].executed_) continue;
+            for (const auto& input : passes_[p - 1].inputs_) passes_[input.pass_].executed_ = true;
+        }
+
+        std::vector<std::size_t> lastUse(passes_.size(), 0);
+        for (std::size_t p = 0; p < passes_.size(); ++p) {
+            if (!passes_[p].executed_) continue;
+            lastUse[p] = passes_[p].isKept_ ? passes_.size() : p;
+            for (const auto& input : passes_[p].inputs_) lastUse[input.pass_] = glm::max(lastUse[input.pass_], p);
+        }
+
+        statistics_ = RenderGraphStatistics{};
+        statistics_.numPasses_ = passes_.size();
+        sharedFrameBuffers_.clear();
+        for (std::size_t p = 0; p < passes_.size(); ++p) {
+            auto& pass = passes_[p];
+            if (!pass.executed_) {
+                statistics_.culledPasses_ += 1;
+                continue;
+            }
+            if (pass.isOutput_) continue;
+
+            statistics_.numTargets_ += 1;
+            auto shared = std::find_if(sharedFrameBuffers_.begin(), sharedFrameBuffers_.end(), [&pass, p](const SharedFrameBuffer& fb) {
+                return fb.lastUse_ < p && fb.sizeDivisor_ == pass.sizeDivisor_ && IsEqual(fb.desc_, pass.targetDesc_);
+            });
+            if (shared == sharedFrameBuffers_.end()) shared = sharedFrameBuffers_.insert(shared, SharedFrameBuffer{ pass.targetDesc_, pass.sizeDivisor_, 0 });
+            shared->lastUse_ = lastUse[p];
+            pass.frameBuffer_ = static_cast<std::size_t>(shared - sharedFrameBuffers_.begin());
+        }
+        statistics_.numPhysicalTargets_ = sharedFrameBuffers_.size();
+
+        frameBuffers_.clear();
+        currentFrameBuffers_ = nullptr;
+        compiled_ = true;
+    }
+
+    /**
+     *  Executes all passes needed for the output passes.
+     *  @param output the frame buffer the output passes render to.
+     *  @param size the full size of the transient frame buffers (e.g., GetViewportQuadSize() of the current window).
+     */
+    void RenderGraph::Execute(const FrameBuffer& output, const glm::uvec2& size)
+    {
+        if (!compiled_) Compile();
+
+        auto& frameBuffers = frameBuffers_[std::make_pair(size.x, size.y)];
+        for (auto i = frameBuffers.size(); i < sharedFrameBuffers_.size(); ++i) {
+            auto fbSize = glm::max(size / sharedFrameBuffers_[i].sizeDivisor_, glm::uvec2{ 1 });
+            frameBuffers.emplace_back(fbSize.x, fbSize.y, sharedFrameBuffers_[i].desc_);
+            frameBuffers.back().SetStandardViewport(0, 0, fbSize.x, fbSize.y);
+        }
+        currentFrameBuffers_ = &frameBuffers;
+
+        for (const auto& pass : passes_) {
+            if (!pass.executed_) continue;
+            const auto& target = pass.isOutput_ ? output : frameBuffers[pass.frameBuffer_];
+            target.DrawToFBO([this, &pass, &target]() { pass.passFunction_(*this, target); });
+        }
+    }
+
+    /**
+     *  Returns a texture rendered by a pass. Valid while executing later passes, kept textures stay valid until the
+     *  next call to Execute().
+     *  @param resource the texture.
+     */
+    GLuint RenderGraph::GetTexture(const RenderGraphResource& resource) const
+    {
+        assert(currentFrameBuffers_ && passes_[resource.pass_].executed_ && !passes_[resource.pass_].isOutput_);
+        return (*currentFrameBuffers_)[passes_[resource.pass_].frameBuffer_].GetTextures()[resource.texture_];
+    }
+}
@@ -0,0 +1,121 @@
+/**
+ * @file   RenderGraph.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of a graph of render passes with shared transient frame buffers.
+ */
+
+#pragma once
+
+#include "core/main.h"
+#include "FrameBuffer.h"
+#include <map>
+
+namespace viscom {
+
+    /** Handle of a texture rendered by a pass of a RenderGraph. */
+    struct RenderGraphResource
+    {
+        /** The index of the pass rendering the texture. */
+        std::size_t pass_;
+        /** The index of the texture in the passes frame buffer descriptor. */
+        std::size_t texture_;
+    };
+
+    /** Statistics of a compiled RenderGraph. */
+    struct RenderGraphStatistics
+    {
+        /** The number of passes added. */
+        std::size_t numPasses_ = 0;
+        /** The number of passes skipped because no output depends on them. */
+        std::size_t culledPasses_ = 0;
+        /** The number of frame buffers rendered to by the executed passes (without the output). */
+        std::size_t numTargets_ = 0;
+        /** The number of frame buffers allocated for each size, after aliasing targets with disjoint lifetimes. */
+        std::size_t numPhysicalTargets_ = 0;
+    };
+
+    /**
+     *  A declarative chain of render passes, e.g., for post-processing. Each pass reads textures of earlier passes and
+     *  renders either to its own transient frame buffer or to the output frame buffer given to Execute().
+     *  Compile() skips passes no output depends on and lets passes with equal frame buffer descriptors share a frame
+     *  buffer if their lifetimes (from rendering to the last pass reading it) do not overlap. The frame buffers are
+     *  also shared between all windows of the same size, as windows are drawn one after another.
+     *  Contents of transient frame buffers are undefined at the start of each pass, so passes need to clear them.
+     *
+     *  Usage:
+     *  auto scene = graph.AddPass("scene", {}, sceneDesc, 1, [](const RenderGraph&, const FrameBuffer&) { ... });
+     *  auto bright = graph.AddPass("bright", { { scene, 0 } }, brightDesc, 2, [](const RenderGraph& g, const FrameBuffer&) { ... g.GetTexture({ scene, 0 }) ... });
+     *  graph.AddOutputPass("composite", { { scene, 0 }, { bright, 0 } }, [](const RenderGraph& g, const FrameBuffer&) { ... });
+     *  graph.Compile();
+     *  graph.Execute(fbo, GetViewportQuadSize(windowId)); // in DrawFrame
+     */
+    class RenderGraph
+    {
+    public:
+        /** The function drawing a pass, the target is already bound. */
+        using PassFunction = std::function<void(const RenderGraph&, const FrameBuffer&)>;
+
+        std::size_t AddPass(const std::string& name, const std::vector<RenderGraphResource>& inputs,
+            const FrameBufferDescriptor& targetDesc, unsigned int sizeDivisor, PassFunction passFunction);
+        std::size_t AddOutputPass(const std::string& name, const std::vector<RenderGraphResource>& inputs, PassFunction passFunction);
+        void KeepResource(const RenderGraphResource& resource);
+
+        void Compile();
+        void Execute(const FrameBuffer& output, const glm::uvec2& size);
+        void ReleaseFrameBuffers() { frameBuffers_.clear(); currentFrameBuffers_ = nullptr; }
+
+        GLuint GetTexture(const RenderGraphResource& resource) const;
+        bool IsPassExecuted(std::size_t pass) const { return passes_[pass].executed_; }
+        const RenderGraphStatistics& GetStatistics() const noexcept { return statistics_; }
+
+    private:
+        /** A render pass. */
+        struct Pass
+        {
+            /** The name of the pass (for debugging). */
+            std::string name_;
+            /** The textures read by the pass. */
+            std::vector<RenderGraphResource> inputs_;
+            /** The descriptor of the passes frame buffer. */
+            FrameBufferDescriptor targetDesc_;
+            /** The divisor of the full size for the passes frame buffer. */
+            unsigned int sizeDivisor_ = 1;
+            /** The draw function. */
+            PassFunction passFunction_;
+            /** Flag if the pass renders to the output. */
+            bool isOutput_ = false;
+            /** Flag if a texture of the pass is used after execution. */
+            bool isKept_ = false;
+            /** Flag if the pass is executed (set by Compile). */
+            bool executed_ = false;
+            /** The index of the shared frame buffer of the pass (set by Compile). */
+            std::size_t frameBuffer_ = 0;
+        };
+
+        /** A frame buffer shared by passes. */
+        struct SharedFrameBuffer
+        {
+            /** The descriptor of the frame buffer. */
+            FrameBufferDescriptor desc_;
+            /** The divisor of the full size. */
+            unsigned int sizeDivisor_;
+            /** The last pass using the frame buffer so far. */
+            std::size_t lastUse_;
+        };
+
+        /** The passes in declaration (and execution) order. */
+        std::vector<Pass> passes_;
+        /** The shared frame buffers (set by Compile). */
+        std::vector<SharedFrameBuffer> sharedFrameBuffers_;
+        /** The frame buffers for each full size. */
+        std::map<std::pair<unsigned int, unsigned int>, std::vector<FrameBuffer>> frameBuffers_;
+        /** The frame buffers of the current (or last) execution. */
+        const std::vector<FrameBuffer>* currentFrameBuffers_ = nullptr;
+        /** Flag if the graph has been compiled after the last change. */
+        bool compiled_ = false;
+        /** The statistics. */
+        RenderGraphStatistics statistics_;
+    };
+}
@@ -0,0 +1,138 @@
+/**
+ * @file   RenderTargetPool.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of a pool for frame buffer textures and render buffers.
+ */
+
+#include "RenderTargetPool.h"
+#include "GLStateCache.h"
+#include "core/open_gl.h"
+
+namespace viscom {
+
+    namespace {
+        /** Returns the format and type used to allocate a texture without immutable storage. */
+        std::pair<GLenum, GLenum> GetUploadFormat(GLenum internalFormat)
+        {
+            switch (internalFormat) {
+            case GL_DEPTH_COMPONENT: case GL_DEPTH_COMPONENT16: case GL_DEPTH_COMPONENT24: case GL_DEPTH_COMPONENT32:
+            case GL_DEPTH_COMPONENT32F:
+                return std::make_pair(GL_DEPTH_COMPONENT, GL_FLOAT);
+            case GL_DEPTH_STENCIL: case GL_DEPTH24_STENCIL8:
+                return std::make_pair(GL_DEPTH_STENCIL, GL_UNSIGNED_INT_24_8);
+            case GL_DEPTH32F_STENCIL8:
+                return std::make_pair(GL_DEPTH_STENCIL, GL_FLOAT_32_UNSIGNED_INT_24_8_REV);
+            case GL_STENCIL_INDEX: case GL_STENCIL_INDEX1: case GL_STENCIL_INDEX4: case GL_STENCIL_INDEX8:
+            case GL_STENCIL_INDEX16:
+                return std::make_pair(GL_STENCIL_INDEX, GL_UNSIGNED_BYTE);
+            default:
+                return std::make_pair(GL_RGBA, GL_FLOAT);
+            }
+        }
+    }
+
+    RenderTargetPoolBookkeeping RenderTargetPool::bookkeeping_{ &RenderTargetPool::Allocate, &RenderTargetPool::Delete,
+        RenderTargetPool::DEFAULT_MAX_POOLED_BYTES };
+
+    /** Enables pooling with the default limit (and resets the statistics). */
+    void RenderTargetPool::InitializeStatic()
+    {
+        bookkeeping_.SetMaxPooledBytes(DEFAULT_MAX_POOLED_BYTES);
+        bookkeeping_.ResetStatistics();
+    }
+
+    /** Deletes all released targets. Targets released afterwards (e.g., by destroying the nodes) are deleted directly. */
+    void RenderTargetPool::CleanUpStatic()
+    {
+        bookkeeping_.Trim();
+        bookkeeping_.SetMaxPooledBytes(0);
+    }
+
+    /**
+     *  Returns a target with uninitialized contents, either a released one or a newly allocated one.
+     *  @param target GL_RENDERBUFFER or the texture type (GL_TEXTURE_2D, GL_TEXTURE_2D_MULTISAMPLE, ...).
+     *  @param internalFormat the internal format.
+     *  @param width the width.
+     *  @param height the height.
+     *  @param samples the number of samples (1 for non multisampled targets).
+     *  @param layers the number of layers of array textures (1 for other targets).
+     *  @return the OpenGL name of the texture or render buffer.
+     */
+    GLuint RenderTargetPool::Acquire(GLenum target, GLenum internalFormat, unsigned int width, unsigned int height,
+        unsigned int samples, unsigned int layers)
+    {
+        return bookkeeping_.Acquire(TargetKey{ target, internalFormat, width, height, samples, layers });
+    }
+
+    /**
+     *  Returns a target to the pool. It is deleted if the pool is full.
+     *  @param target GL_RENDERBUFFER or the texture type the target was acquired with.
+     *  @param name the OpenGL name of the target.
+     */
+    void RenderTargetPool::Release(GLenum target, GLuint name)
+    {
+        bookkeeping_.Release(target, name);
+    }
+
+    /** Deletes all released targets, e.g., after the window sizes changed. */
+    void RenderTargetPool::Trim()
+    {
+        bookkeeping_.Trim();
+    }
+
+    /**
+     *  Sets the maximum of video memory kept by released targets, released targets exceeding it are deleted.
+     *  @param maxPooledBytes the maximum in bytes.
+     */
+    void RenderTargetPool::SetMaxPooledBytes(std::size_t maxPooledBytes)
+    {
+        bookkeeping_.SetMaxPooledBytes(maxPooledBytes);
+    }
+
+    GLuint RenderTargetPool::Allocate(const TargetKey& key)
+    {
+        auto[target, internalFormat, width, height, samples, layers] = key;
+        GLuint name = 0;
+        if (target == GL_RENDERBUFFER) {
+            glGenRenderbuffers(1, &name);
+            glBindRenderbuffer(GL_RENDERBUFFER, name);
+            if (samples == 1) glRenderbufferStorage(GL_RENDERBUFFER, internalFormat, width, height);
+            else glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, internalFormat, width, height);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        } else {
+            glGenTextures(1, &name);
+            GLStateCache::BindTexture(0, target, name);
+            auto hasStorageMultisample = GLEW_VERSION_4_3 || GLEW_ARB_texture_storage_multisample;
+            if (target == GL_TEXTURE_2D_MULTISAMPLE) {
+                if (hasStorageMultisample) glTexStorage2DMultisample(target, samples, internalFormat, width, height, GL_TRUE);
+                else glTexImage2DMultisample(target, samples, internalFormat, width, height, GL_TRUE);
+            } else if (target == GL_TEXTURE_2D_MULTISAMPLE_ARRAY) {
+                if (hasStorageMultisample) glTexStorage3DMultisample(target, samples, internalFormat, width, height, layers, GL_TRUE);
+                else glTexImage3DMultisample(target, samples, internalFormat, width, height, layers, GL_TRUE);
+            } else if (GLEW_VERSION_4_2 || GLEW_ARB_texture_storage) {
+                if (target == GL_TEXTURE_2D_ARRAY) glTexStorage3D(target, 1, internalFormat, width, height, layers);
+                else glTexStorage2D(target, 1, internalFormat, width, height);
+            } else {
+                auto[format, type] = GetUploadFormat(internalFormat);
+                if (target == GL_TEXTURE_2D_ARRAY) {
+                    glTexImage3D(target, 0, internalFormat, width, height, layers, 0, format, type, nullptr);
+                } else if (target == GL_TEXTURE_CUBE_MAP) {
+                    for (GLenum face = 0; face < 6; ++face) glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, internalFormat, width, height, 0, format, type, nullptr);
+                } else glTexImage2D(target, 0, internalFormat, width, height, 0, format, type, nullptr);
+            }
+        }
+
+        return name;
+    }
+
+    void RenderTargetPool::Delete(GLenum target, GLuint name)
+    {
+        if (target == GL_RENDERBUFFER) glDeleteRenderbuffers(1, &name);
+        else {
+            glDeleteTextures(1, &name);
+            GLStateCache::Invalidate();
+        }
+    }
+}
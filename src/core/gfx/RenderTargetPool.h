@@ -0,0 +1,48 @@
+/**
+ * @file   RenderTargetPool.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of a pool for frame buffer textures and render buffers.
+ */
+
+#pragma once
+
+#include "core/main.h"
+#include "RenderTargetPoolBookkeeping.h"
+
+namespace viscom {
+
+    /**
+     *  Allocates the textures and render buffers of frame buffers. Textures use immutable storage (glTexStorage2D)
+     *  where available. Released targets are kept and handed out again for requests with the same target, format,
+     *  size, number of samples and layers, so re-creating frame buffers (e.g., in CreateOffscreenBuffers or for
+     *  copies) does not allocate video memory again. The memory of released targets is bounded by SetMaxPooledBytes().
+     */
+    class RenderTargetPool
+    {
+    public:
+        static void InitializeStatic();
+        static void CleanUpStatic();
+
+        static GLuint Acquire(GLenum target, GLenum internalFormat, unsigned int width, unsigned int height,
+            unsigned int samples, unsigned int layers = 1);
+        static void Release(GLenum target, GLuint name);
+        static void Trim();
+
+        static void SetMaxPooledBytes(std::size_t maxPooledBytes);
+        static const RenderTargetPoolStatistics& GetStatistics() noexcept { return bookkeeping_.GetStatistics(); }
+
+        /** The default maximum of video memory kept by released targets. */
+        static constexpr std::size_t DEFAULT_MAX_POOLED_BYTES = 256 * 1024 * 1024;
+
+    private:
+        using TargetKey = RenderTargetPoolBookkeeping::TargetKey;
+
+        static GLuint Allocate(const TargetKey& key);
+        static void Delete(GLenum target, GLuint name);
+
+        /** The released and allocated targets. */
+        static RenderTargetPoolBookkeeping bookkeeping_;
+    };
+}
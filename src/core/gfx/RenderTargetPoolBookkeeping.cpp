@@ -0,0 +1,156 @@
+/**
+ * @file   RenderTargetPoolBookkeeping.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of the bookkeeping of the RenderTargetPool.
+ */
+
+#include "RenderTargetPoolBookkeeping.h"
+#include "core/open_gl.h"
+#include <algorithm>
+#include <cassert>
+
+namespace viscom {
+
+    /**
+     *  Constructor.
+     *  @param allocateTarget allocates a target for a key.
+     *  @param deleteTarget deletes a target.
+     *  @param maxPooledBytes the maximum of video memory kept by released targets.
+     */
+    RenderTargetPoolBookkeeping::RenderTargetPoolBookkeeping(AllocateFunction allocateTarget, DeleteFunction deleteTarget,
+        std::size_t maxPooledBytes) :
+        allocateTarget_{ allocateTarget },
+        deleteTarget_{ deleteTarget },
+        maxPooledBytes_{ maxPooledBytes }
+    {
+    }
+
+    /**
+     *  Returns a released target with the same key or allocates a new one.
+     *  @param key the target, format, size, number of samples and layers.
+     *  @return the name of the target.
+     */
+    GLuint RenderTargetPoolBookkeeping::Acquire(const TargetKey& key)
+    {
+        auto pooled = pooledTargets_.find(key);
+        if (pooled != pooledTargets_.end()) {
+            auto name = pooled->second;
+            pooledTargets_.erase(pooled);
+            statistics_.pooledBytes_ -= GetSizeInBytes(key);
+            statistics_.hits_ += 1;
+            return name;
+        }
+
+        statistics_.misses_ += 1;
+        auto name = allocateTarget_(key);
+        allocatedTargets_.emplace(std::make_pair(std::get<0>(key), name), key);
+        statistics_.numTargets_ += 1;
+        statistics_.allocatedBytes_ += GetSizeInBytes(key);
+        return name;
+    }
+
+    /**
+     *  Keeps a target for reuse or deletes it if the released targets would exceed the maximum.
+     *  @param target GL_RENDERBUFFER or the texture type the target was acquired with.
+     *  @param name the name of the target (0 is ignored).
+     */
+    void RenderTargetPoolBookkeeping::Release(GLenum target, GLuint name)
+    {
+        if (name == 0) return;
+        auto allocated = allocatedTargets_.find(std::make_pair(target, name));
+        assert(allocated != allocatedTargets_.end());
+        if (allocated == allocatedTargets_.end()) return;
+
+        auto key = allocated->second;
+        auto size = GetSizeInBytes(key);
+        if (statistics_.pooledBytes_ + size > maxPooledBytes_) Delete(key, name);
+        else {
+            pooledTargets_.emplace(key, name);
+            statistics_.pooledBytes_ += size;
+        }
+    }
+
+    /** Deletes all released targets. */
+    void RenderTargetPoolBookkeeping::Trim()
+    {
+        for (const auto& pooled : pooledTargets_) Delete(pooled.first, pooled.second);
+        pooledTargets_.clear();
+        statistics_.pooledBytes_ = 0;
+    }
+
+    /**
+     *  Sets the maximum of video memory kept by released targets, the largest released targets are deleted until
+     *  the rest fits.
+     *  @param maxPooledBytes the maximum in bytes.
+     */
+    void RenderTargetPoolBookkeeping::SetMaxPooledBytes(std::size_t maxPooledBytes)
+    {
+        maxPooledBytes_ = maxPooledBytes;
+        while (statistics_.pooledBytes_ > maxPooledBytes_) {
+            auto largest = pooledTargets_.begin();
+            for (auto it = pooledTargets_.begin(); it != pooledTargets_.end(); ++it) {
+                if (GetSizeInBytes(it->first) > GetSizeInBytes(largest->first)) largest = it;
+            }
+            statistics_.pooledBytes_ -= GetSizeInBytes(largest->first);
+            Delete(largest->first, largest->second);
+            pooledTargets_.erase(largest);
+        }
+    }
+
+    /** Resets the numbers of hits and misses. */
+    void RenderTargetPoolBookkeeping::ResetStatistics() noexcept
+    {
+        statistics_.hits_ = 0;
+        statistics_.misses_ = 0;
+    }
+
+    /**
+     *  Estimates the bytes per pixel (and sample) the driver allocates for an internal format. Three channel formats
+     *  are counted with the padding to four channels most drivers use (except for 32 bit channels).
+     *  @param internalFormat the internal format.
+     */
+    std::size_t RenderTargetPoolBookkeeping::GetBytesPerPixel(GLenum internalFormat)
+    {
+        switch (internalFormat) {
+        case GL_R8: case GL_R8_SNORM: case GL_R8I: case GL_R8UI: case GL_STENCIL_INDEX8:
+            return 1;
+        case GL_RG8: case GL_RG8_SNORM: case GL_RG8I: case GL_RG8UI:
+        case GL_R16: case GL_R16_SNORM: case GL_R16F: case GL_R16I: case GL_R16UI:
+        case GL_RGB565: case GL_RGB5_A1: case GL_RGBA4: case GL_DEPTH_COMPONENT16: case GL_STENCIL_INDEX16:
+            return 2;
+        case GL_RGB16: case GL_RGB16_SNORM: case GL_RGB16F: case GL_RGB16I: case GL_RGB16UI:
+        case GL_RGBA16: case GL_RGBA16_SNORM: case GL_RGBA16F: case GL_RGBA16I: case GL_RGBA16UI:
+        case GL_RG32F: case GL_RG32I: case GL_RG32UI: case GL_DEPTH32F_STENCIL8:
+            return 8;
+        case GL_RGB32F: case GL_RGB32I: case GL_RGB32UI:
+            return 12;
+        case GL_RGBA32F: case GL_RGBA32I: case GL_RGBA32UI:
+            return 16;
+        default:
+            // 8 bit RGB(A), 16 bit RG, packed formats, 32 bit single channel and 24/32 bit depth formats.
+            return 4;
+        }
+    }
+
+    /**
+     *  Estimates the video memory of a target.
+     *  @param key the target, format, size, number of samples and layers.
+     */
+    std::size_t RenderTargetPoolBookkeeping::GetSizeInBytes(const TargetKey& key)
+    {
+        auto[target, internalFormat, width, height, samples, layers] = key;
+        auto numLayers = target == GL_TEXTURE_CUBE_MAP ? std::size_t{ 6 } : std::size_t{ std::max(layers, 1U) };
+        return GetBytesPerPixel(internalFormat) * width * height * std::max(samples, 1U) * numLayers;
+    }
+
+    void RenderTargetPoolBookkeeping::Delete(const TargetKey& key, GLuint name)
+    {
+        auto target = std::get<0>(key);
+        deleteTarget_(target, name);
+        allocatedTargets_.erase(std::make_pair(target, name));
+        statistics_.numTargets_ -= 1;
+        statistics_.allocatedBytes_ -= GetSizeInBytes(key);
+    }
+}
@@ -0,0 +1,79 @@
+/**
+ * @file   RenderTargetPoolBookkeeping.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of the bookkeeping of the RenderTargetPool.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "core/open_gl_fwd.h"
+#include <map>
+#include <tuple>
+
+namespace viscom {
+
+    /** Allocation statistics of the RenderTargetPool. */
+    struct RenderTargetPoolStatistics
+    {
+        /** The number of requests served by a released target. */
+        std::size_t hits_ = 0;
+        /** The number of requests that allocated a new target. */
+        std::size_t misses_ = 0;
+        /** The number of targets currently allocated (in use or pooled). */
+        std::size_t numTargets_ = 0;
+        /** The estimated video memory of all allocated targets in bytes. */
+        std::size_t allocatedBytes_ = 0;
+        /** The estimated video memory of the released targets kept for reuse in bytes. */
+        std::size_t pooledBytes_ = 0;
+    };
+
+    /**
+     *  The bookkeeping of the RenderTargetPool: matches requests to released targets, tracks the allocated targets and
+     *  their estimated memory and decides which released targets are deleted. Does not call OpenGL itself, targets
+     *  are allocated and deleted by the functions passed to the constructor.
+     */
+    class RenderTargetPoolBookkeeping
+    {
+    public:
+        /** Target (GL_RENDERBUFFER or a texture type), internal format, width, height, number of samples and layers. */
+        using TargetKey = std::tuple<GLenum, GLenum, unsigned int, unsigned int, unsigned int, unsigned int>;
+        /** Allocates a target and returns its name. */
+        using AllocateFunction = GLuint(*)(const TargetKey& key);
+        /** Deletes a target. */
+        using DeleteFunction = void(*)(GLenum target, GLuint name);
+
+        RenderTargetPoolBookkeeping(AllocateFunction allocateTarget, DeleteFunction deleteTarget, std::size_t maxPooledBytes);
+
+        GLuint Acquire(const TargetKey& key);
+        void Release(GLenum target, GLuint name);
+        void Trim();
+
+        void SetMaxPooledBytes(std::size_t maxPooledBytes);
+        std::size_t GetMaxPooledBytes() const noexcept { return maxPooledBytes_; }
+        void ResetStatistics() noexcept;
+        const RenderTargetPoolStatistics& GetStatistics() const noexcept { return statistics_; }
+
+        static std::size_t GetBytesPerPixel(GLenum internalFormat);
+        static std::size_t GetSizeInBytes(const TargetKey& key);
+
+    private:
+        void Delete(const TargetKey& key, GLuint name);
+
+        /** Allocates targets. */
+        AllocateFunction allocateTarget_;
+        /** Deletes targets. */
+        DeleteFunction deleteTarget_;
+        /** The released targets. */
+        std::multimap<TargetKey, GLuint> pooledTargets_;
+        /** The keys of all allocated targets by target and name. */
+        std::map<std::pair<GLenum, GLuint>, TargetKey> allocatedTargets_;
+        /** The maximum of video memory kept by released targets. */
+        std::size_t maxPooledBytes_;
+        /** The statistics. */
+        RenderTargetPoolStatistics statistics_;
+    };
+}
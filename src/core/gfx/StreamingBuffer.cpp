@@ -0,0 +1,225 @@
+/**
+ * @file   StreamingBuffer.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of a ring buffer for streaming data to the GPU.
+ */
+
+#include "StreamingBuffer.h"
+#include "core/open_gl.h"
+#include <cstring>
+
+namespace viscom {
+
+    namespace {
+        std::size_t AlignOffset(std::size_t offset, std::size_t alignment)
+        {
+            return ((offset + alignment - 1) / alignment) * alignment;
+        }
+    }
+
+    /**
+     *  Constructor.
+     *  @param frameSize the initial size of the region available for each frame.
+     *  @param numFrames the number of frames that can be in flight.
+     */
+    StreamingBuffer::StreamingBuffer(std::size_t frameSize, std::size_t numFrames) :
+        frameSize_{ frameSize },
+        numFrames_{ numFrames },
+        fences_(numFrames, nullptr)
+    {
+        CreateBuffer();
+    }
+
+    /** Move constructor. */
+    StreamingBuffer::StreamingBuffer(StreamingBuffer&& rhs) noexcept :
+        buffer_{ rhs.buffer_ },
+        frameSize_{ rhs.frameSize_ },
+        numFrames_{ rhs.numFrames_ },
+        currentFrame_{ rhs.currentFrame_ },
+        head_{ rhs.head_ },
+        mappedData_{ rhs.mappedData_ },
+        fences_{ std::move(rhs.fences_) },
+        retiredBuffers_{ std::move(rhs.retiredBuffers_) }
+    {
+        rhs.buffer_ = 0;
+        rhs.mappedData_ = nullptr;
+    }
+
+    /** Move assignment operator. */
+    StreamingBuffer& StreamingBuffer::operator=(StreamingBuffer&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            this->~StreamingBuffer();
+            buffer_ = rhs.buffer_;
+            frameSize_ = rhs.frameSize_;
+            numFrames_ = rhs.numFrames_;
+            currentFrame_ = rhs.currentFrame_;
+            head_ = rhs.head_;
+            mappedData_ = rhs.mappedData_;
+            fences_ = std::move(rhs.fences_);
+            retiredBuffers_ = std::move(rhs.retiredBuffers_);
+            rhs.buffer_ = 0;
+            rhs.mappedData_ = nullptr;
+        }
+        return *this;
+    }
+
+    /** Destructor. */
+    StreamingBuffer::~StreamingBuffer()
+    {
+        DeleteRetiredBuffers();
+        DeleteFences();
+        if (buffer_ == 0) return;
+        if (mappedData_) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &buffer_);
+    }
+
+    /**
+     *  Makes sure the next uploads of the current frame fit into the current buffer object, so they can be used with
+     *  a single binding of GetBuffer().
+     *  @param size the total size of the next uploads including the padding needed for their alignments.
+     */
+    void StreamingBuffer::Reserve(std::size_t size)
+    {
+        if (head_ + size > GetFrameEnd()) Grow(size);
+    }
+
+    /**
+     *  Copies data to the region of the current frame.
+     *  @param data the data to upload.
+     *  @param size the size of the data in bytes.
+     *  @param alignment the alignment of the offset (e.g., the vertex size or GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT).
+     *  @return the offset of the data in the buffer.
+     */
+    std::size_t StreamingBuffer::Upload(const void* data, std::size_t size, std::size_t alignment)
+    {
+        auto offset = AlignOffset(head_, alignment);
+        if (size == 0) return offset;
+        if (offset + size > GetFrameEnd()) {
+            Grow(size + alignment);
+            offset = AlignOffset(head_, alignment);
+        }
+
+        if (mappedData_) std::memcpy(mappedData_ + offset, data, size);
+        else {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+            glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+
+        head_ = offset + size;
+        return offset;
+    }
+
+    /**
+     *  Finishes the current frame: its region is protected by a fence and the next region is used, waiting for the
+     *  GPU if it still reads from it. Buffer objects replaced during the frame are deleted, so all ranges have to be
+     *  bound again. Call exactly once per frame after all draws using the data of the frame were issued.
+     */
+    void StreamingBuffer::NextFrame()
+    {
+        DeleteRetiredBuffers();
+
+        if (!mappedData_) {
+            // orphan only between frames, draws of the last frames keep the old storage alive.
+            auto bufferSize = frameSize_ * numFrames_;
+            if (head_ + frameSize_ > bufferSize) {
+                glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+                glBufferData(GL_COPY_WRITE_BUFFER, bufferSize, nullptr, GL_STREAM_DRAW);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                head_ = 0;
+            }
+            return;
+        }
+
+        if (fences_[currentFrame_]) glDeleteSync(fences_[currentFrame_]);
+        fences_[currentFrame_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        currentFrame_ = (currentFrame_ + 1) % numFrames_;
+        WaitForFence(currentFrame_);
+        head_ = currentFrame_ * frameSize_;
+    }
+
+    /** Returns the end of the space the current frame can use in the current buffer object. */
+    std::size_t StreamingBuffer::GetFrameEnd() const noexcept
+    {
+        if (mappedData_) return (currentFrame_ + 1) * frameSize_;
+        return frameSize_ * numFrames_;
+    }
+
+    void StreamingBuffer::CreateBuffer()
+    {
+        auto bufferSize = frameSize_ * numFrames_;
+        glGenBuffers(1, &buffer_);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+        if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) {
+            GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+            glBufferStorage(GL_COPY_WRITE_BUFFER, bufferSize, nullptr, flags);
+            mappedData_ = static_cast<std::uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, bufferSize, flags));
+            if (!mappedData_) {
+                LOG(WARNING) << "Could not map streaming buffer persistently, using orphaning instead.";
+                glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+                glDeleteBuffers(1, &buffer_);
+                glGenBuffers(1, &buffer_);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, buffer_);
+                glBufferData(GL_COPY_WRITE_BUFFER, bufferSize, nullptr, GL_STREAM_DRAW);
+            }
+        }
+        else glBufferData(GL_COPY_WRITE_BUFFER, bufferSize, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        head_ = mappedData_ ? currentFrame_ * frameSize_ : 0;
+    }
+
+    void StreamingBuffer::DeleteRetiredBuffers()
+    {
+        for (auto& retired : retiredBuffers_) {
+            if (retired.second) {
+                glBindBuffer(GL_COPY_WRITE_BUFFER, retired.first);
+                glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            }
+            // pending draws keep the storage alive.
+            glDeleteBuffers(1, &retired.first);
+        }
+        retiredBuffers_.clear();
+    }
+
+    void StreamingBuffer::DeleteFences()
+    {
+        for (auto& fence : fences_) {
+            if (fence) glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    void StreamingBuffer::WaitForFence(std::size_t frame)
+    {
+        if (!fences_[frame]) return;
+
+        auto result = glClientWaitSync(fences_[frame], 0, 0);
+        while (result == GL_TIMEOUT_EXPIRED) result = glClientWaitSync(fences_[frame], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        glDeleteSync(fences_[frame]);
+        fences_[frame] = nullptr;
+    }
+
+    /**
+     *  Replaces the buffer by one with larger regions. The old buffer object is kept until the end of the frame, as
+     *  ranges of it may still be bound for draws of the current frame. The fences stay valid, as they only track the
+     *  commands of the last frames.
+     *  @param minFrameSize the minimum size of the region of a frame.
+     */
+    void StreamingBuffer::Grow(std::size_t minFrameSize)
+    {
+        retiredBuffers_.emplace_back(buffer_, mappedData_ != nullptr);
+        buffer_ = 0;
+        mappedData_ = nullptr;
+        frameSize_ = glm::max(2 * frameSize_, minFrameSize);
+        CreateBuffer();
+    }
+}
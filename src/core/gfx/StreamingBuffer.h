@@ -0,0 +1,72 @@
+/**
+ * @file   StreamingBuffer.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of a ring buffer for streaming data to the GPU.
+ */
+
+#pragma once
+
+#include <utility>
+#include "core/main.h"
+#include "core/open_gl_fwd.h"
+
+namespace viscom {
+
+    /**
+     *  A buffer for data that is written once and used by the GPU only in the current frame (vertex data, uniform
+     *  blocks, ...). Data is appended to the region of the current frame and the regions of the last frames are kept
+     *  alive with fences, so the buffer never needs to be re-specified. If persistent mapping is available
+     *  (OpenGL 4.4 or ARB_buffer_storage) data is copied directly to the mapped memory, otherwise it is written with
+     *  glBufferSubData and the buffer is orphaned in NextFrame() when the ring is full.
+     *
+     *  Data uploaded in the current frame stays valid until NextFrame(). If a frame needs more space than available
+     *  the buffer object is replaced by a larger one and the old one is kept until the end of the frame, so ranges
+     *  bound earlier in the frame stay valid, but GetBuffer() has to be bound after uploading. Data that has to be in
+     *  the same buffer object (e.g., vertices and indices of one draw) needs a Reserve() before uploading.
+     *  NextFrame() has to be called exactly once per frame.
+     */
+    class StreamingBuffer
+    {
+    public:
+        explicit StreamingBuffer(std::size_t frameSize, std::size_t numFrames = 3);
+        StreamingBuffer(const StreamingBuffer&) = delete;
+        StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+        StreamingBuffer(StreamingBuffer&&) noexcept;
+        StreamingBuffer& operator=(StreamingBuffer&&) noexcept;
+        ~StreamingBuffer();
+
+        void Reserve(std::size_t size);
+        std::size_t Upload(const void* data, std::size_t size, std::size_t alignment = 1);
+        void NextFrame();
+
+        GLuint GetBuffer() const noexcept { return buffer_; }
+        bool IsPersistentlyMapped() const noexcept { return mappedData_ != nullptr; }
+
+    private:
+        std::size_t GetFrameEnd() const noexcept;
+        void CreateBuffer();
+        void DeleteRetiredBuffers();
+        void DeleteFences();
+        void WaitForFence(std::size_t frame);
+        void Grow(std::size_t minFrameSize);
+
+        /** The buffer object. */
+        GLuint buffer_ = 0;
+        /** The size of the region of a single frame. */
+        std::size_t frameSize_;
+        /** The number of frames (regions) in the buffer. */
+        std::size_t numFrames_;
+        /** The frame (region) currently written. */
+        std::size_t currentFrame_ = 0;
+        /** The next free offset in the buffer. */
+        std::size_t head_ = 0;
+        /** The persistently mapped buffer memory (nullptr if not available). */
+        std::uint8_t* mappedData_ = nullptr;
+        /** The fences for each frame that signal when the GPU does not use its region anymore. */
+        std::vector<GLsync> fences_;
+        /** Buffer objects replaced in the current frame (and whether they are mapped), deleted in NextFrame(). */
+        std::vector<std::pair<GLuint, bool>> retiredBuffers_;
+    };
+}
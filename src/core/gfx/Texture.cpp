@@ -12,6 +12,7 @@
 #include <stb_image.h>
 #include "core/ApplicationNodeInternal.h"
 #include "core/resources/ResourceManager.h"
+#include "core/gfx/GLStateCache.h"
 #include "core/open_gl.h"
 
 namespace viscom {
@@ -31,21 +32,21 @@ namespace viscom {
         // Bind Texture and Set Filtering Levels
         glGenTextures(1, &textureId_);
         auto e = glGetError();
-        glBindTexture(GL_TEXTURE_2D, textureId_);
+        GLStateCache::BindTexture(0, GL_TEXTURE_2D, textureId_);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        GLStateCache::BindTexture(0, GL_TEXTURE_2D, 0);
     }
 
     /** Destructor. */
     Texture::~Texture() noexcept
     {
         if (textureId_ != 0) {
-            glBindTexture(GL_TEXTURE_2D, 0);
             glDeleteTextures(1, &textureId_);
             textureId_ = 0;
+            GLStateCache::Invalidate();
         }
     }
 
@@ -65,7 +66,7 @@ namespace viscom {
         if (stbi_is_hdr(fullFilename.c_str()) != 0) image = LoadImageHDR(fullFilename);
         else image = LoadImageLDR(fullFilename, sRGB_);
 
-        glBindTexture(GL_TEXTURE_2D, textureId_);
+        GLStateCache::BindTexture(0, GL_TEXTURE_2D, textureId_);
         glTexImage2D(GL_TEXTURE_2D, 0, descriptor_.internalFormat_, width_, height_, 0, descriptor_.format_, descriptor_.type_, image.first);
 
         if (data.has_value()) {
@@ -84,7 +85,7 @@ namespace viscom {
         }
 
         stbi_image_free(image.first);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        GLStateCache::BindTexture(0, GL_TEXTURE_2D, 0);
     }
 
     void Texture::LoadFromMemory(const void* data, std::size_t size)
@@ -99,9 +100,9 @@ namespace viscom {
         sRGB_ = *reinterpret_cast<const bool*>(dataptr);
         dataptr += sizeof(bool);
 
-        glBindTexture(GL_TEXTURE_2D, textureId_);
+        GLStateCache::BindTexture(0, GL_TEXTURE_2D, textureId_);
         glTexImage2D(GL_TEXTURE_2D, 0, descriptor_.internalFormat_, width_, height_, 0, descriptor_.format_, descriptor_.type_, dataptr);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        GLStateCache::BindTexture(0, GL_TEXTURE_2D, 0);
     }
 
     std::pair<void*, std::size_t> Texture::LoadImageLDR(const std::string& filename, bool useSRGB)
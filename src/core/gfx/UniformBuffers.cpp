@@ -0,0 +1,159 @@
+/**
+ * @file   UniformBuffers.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of uniform buffer objects and the frameworks standard uniform blocks.
+ */
+
+#include "UniformBuffers.h"
+#include "core/open_gl.h"
+
+namespace viscom {
+
+    std::unique_ptr<StreamingBuffer> StandardUniforms::uniformStream_;
+    std::size_t StandardUniforms::uniformAlignment_ = 256;
+    GLuint StandardUniforms::numRenderLayers_ = 1;
+    PerLayerUniforms StandardUniforms::perLayer_;
+
+    /**
+     *  Constructor.
+     *  @param size the size of the buffer in bytes.
+     *  @param bindingPoint the uniform buffer binding point to use.
+     */
+    UniformBuffer::UniformBuffer(std::size_t size, GLuint bindingPoint) :
+        ubo_{ 0 },
+        size_{ size },
+        bindingPoint_{ bindingPoint }
+    {
+        glGenBuffers(1, &ubo_);
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+        glBufferData(GL_UNIFORM_BUFFER, size_, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    /** Move constructor. */
+    UniformBuffer::UniformBuffer(UniformBuffer&& rhs) noexcept :
+        ubo_{ rhs.ubo_ },
+        size_{ rhs.size_ },
+        bindingPoint_{ rhs.bindingPoint_ }
+    {
+        rhs.ubo_ = 0;
+    }
+
+    /** Move assignment operator. */
+    UniformBuffer& UniformBuffer::operator=(UniformBuffer&& rhs) noexcept
+    {
+        if (this != &rhs) {
+            this->~UniformBuffer();
+            ubo_ = rhs.ubo_;
+            size_ = rhs.size_;
+            bindingPoint_ = rhs.bindingPoint_;
+            rhs.ubo_ = 0;
+        }
+        return *this;
+    }
+
+    /** Destructor. */
+    UniformBuffer::~UniformBuffer()
+    {
+        if (ubo_ != 0) glDeleteBuffers(1, &ubo_);
+        ubo_ = 0;
+    }
+
+    /**
+     *  Uploads data to the buffer.
+     *  @param data the data to upload.
+     *  @param size the size of the data in bytes.
+     *  @param offset the offset in the buffer to write to.
+     */
+    void UniformBuffer::UploadData(const void* data, std::size_t size, std::size_t offset) const
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo_);
+        glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    void UniformBuffer::BindBuffer() const
+    {
+        glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint_, ubo_);
+    }
+
+    void UniformBuffer::BindBufferRange(std::size_t offset, std::size_t size) const
+    {
+        glBindBufferRange(GL_UNIFORM_BUFFER, bindingPoint_, ubo_, offset, size);
+    }
+
+    /** Creates the standard uniform buffers, needs a valid OpenGL context. */
+    void StandardUniforms::InitializeStatic()
+    {
+        GLint alignment = 256;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        uniformAlignment_ = static_cast<std::size_t>(glm::max(alignment, 1));
+        uniformStream_ = std::make_unique<StreamingBuffer>(STREAMING_FRAME_SIZE);
+    }
+
+    /** Releases the standard uniform buffers while the OpenGL context is still valid. */
+    void StandardUniforms::CleanUpStatic()
+    {
+        uniformStream_.reset();
+    }
+
+    /**
+     *  Binds the standard uniform blocks of a program to their binding points.
+     *  @param program the linked program.
+     */
+    void StandardUniforms::BindUniformBlocks(GLuint program)
+    {
+        auto perFrameIndex = glGetUniformBlockIndex(program, PER_FRAME_UNIFORM_BLOCK);
+        if (perFrameIndex != GL_INVALID_INDEX) glUniformBlockBinding(program, perFrameIndex, PER_FRAME_UNIFORM_BINDING);
+        auto perDrawIndex = glGetUniformBlockIndex(program, PER_DRAW_UNIFORM_BLOCK);
+        if (perDrawIndex != GL_INVALID_INDEX) glUniformBlockBinding(program, perDrawIndex, PER_DRAW_UNIFORM_BINDING);
+        auto perLayerIndex = glGetUniformBlockIndex(program, PER_LAYER_UNIFORM_BLOCK);
+        if (perLayerIndex != GL_INVALID_INDEX) glUniformBlockBinding(program, perLayerIndex, PER_LAYER_UNIFORM_BINDING);
+    }
+
+    /** Starts a new frame in the streaming buffer, call exactly once per frame before anything is drawn. */
+    void StandardUniforms::NextFrame()
+    {
+        if (uniformStream_) uniformStream_->NextFrame();
+    }
+
+    /**
+     *  Uploads the per-frame uniforms and binds them.
+     *  @param perFrame the per-frame uniforms of the current window.
+     */
+    void StandardUniforms::SetPerFrame(const PerFrameUniforms& perFrame)
+    {
+        UploadAndBind(&perFrame, sizeof(PerFrameUniforms), PER_FRAME_UNIFORM_BINDING);
+    }
+
+    /**
+     *  Writes the per-draw uniforms to the streaming buffer and binds them.
+     *  @param modelMatrix the model matrix.
+     *  @param normalMatrix the normal matrix.
+     */
+    void StandardUniforms::SetPerDraw(const glm::mat4& modelMatrix, const glm::mat3& normalMatrix)
+    {
+        PerDrawUniforms perDraw{ modelMatrix, glm::mat4(normalMatrix) };
+        UploadAndBind(&perDraw, sizeof(PerDrawUniforms), PER_DRAW_UNIFORM_BINDING);
+    }
+
+    /**
+     *  Uploads the per-layer uniforms and binds them. The following framework draws are instanced for all layers.
+     *  @param perLayer the view projection matrices of all layers.
+     */
+    void StandardUniforms::SetPerLayer(const PerLayerUniforms& perLayer)
+    {
+        numRenderLayers_ = static_cast<GLuint>(glm::max(perLayer.numLayers_, 1));
+        perLayer_ = perLayer;
+        UploadAndBind(&perLayer, sizeof(PerLayerUniforms), PER_LAYER_UNIFORM_BINDING);
+    }
+
+    void StandardUniforms::UploadAndBind(const void* data, std::size_t size, GLuint bindingPoint)
+    {
+        if (!uniformStream_) return;
+        auto offset = uniformStream_->Upload(data, size, uniformAlignment_);
+        glBindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, uniformStream_->GetBuffer(), offset, size);
+    }
+}
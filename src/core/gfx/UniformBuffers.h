@@ -0,0 +1,140 @@
+/**
+ * @file   UniformBuffers.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of uniform buffer objects and the frameworks standard uniform blocks.
+ */
+
+#pragma once
+
+#include "core/main.h"
+#include "core/open_gl_fwd.h"
+#include "StreamingBuffer.h"
+
+namespace viscom {
+
+    /**
+     *  Contents of the per-frame uniform block (std140 layout), updated once per window before DrawFrame:
+     *  layout(std140) uniform PerFrameUniforms { mat4 viewMatrix; mat4 projectionMatrix; mat4 viewProjectionMatrix; vec4 viewport; float time; float elapsedTime; };
+     */
+    struct PerFrameUniforms
+    {
+        glm::mat4 viewMatrix_;
+        glm::mat4 projectionMatrix_;
+        glm::mat4 viewProjectionMatrix_;
+        /** The windows viewport on the total screen (position and size in pixels). */
+        glm::vec4 viewport_;
+        float time_;
+        float elapsedTime_;
+        float padding_[2];
+    };
+
+    /**
+     *  Contents of the per-draw uniform block (std140 layout), written for every draw by MeshRenderable:
+     *  layout(std140) uniform PerDrawUniforms { mat4 modelMatrix; mat4 normalMatrix; };
+     */
+    struct PerDrawUniforms
+    {
+        glm::mat4 modelMatrix_;
+        /** The normal matrix (only the upper 3x3 part is used). */
+        glm::mat4 normalMatrix_;
+    };
+
+    /**
+     *  Contents of the per-layer uniform block (std140 layout) for rendering all windows of a node in one pass into
+     *  layered frame buffers, set once per frame:
+     *  layout(std140) uniform PerLayerUniforms { mat4 layerViewProjectionMatrices[8]; int numLayers; };
+     *  The block is set for every window (with a single layer if windows are drawn separately). Framework draws are
+     *  instanced numLayers times, shaders select the layer gl_InstanceID % numLayers with gl_Layer in the vertex
+     *  shader (see resources/shader/layeredRendering.glsl).
+     */
+    struct PerLayerUniforms
+    {
+        /** The maximum number of layers. */
+        static constexpr std::size_t MAX_LAYERS = 8;
+
+        std::array<glm::mat4, MAX_LAYERS> viewProjectionMatrices_;
+        int numLayers_;
+        int padding_[3];
+    };
+
+    /** A buffer object for uniform blocks bound to a fixed binding point. */
+    class UniformBuffer
+    {
+    public:
+        UniformBuffer(std::size_t size, GLuint bindingPoint);
+        UniformBuffer(const UniformBuffer&) = delete;
+        UniformBuffer& operator=(const UniformBuffer&) = delete;
+        UniformBuffer(UniformBuffer&&) noexcept;
+        UniformBuffer& operator=(UniformBuffer&&) noexcept;
+        ~UniformBuffer();
+
+        void UploadData(const void* data, std::size_t size, std::size_t offset = 0) const;
+        void BindBuffer() const;
+        void BindBufferRange(std::size_t offset, std::size_t size) const;
+
+        GLuint GetBuffer() const noexcept { return ubo_; }
+        GLuint GetBindingPoint() const noexcept { return bindingPoint_; }
+        std::size_t GetSize() const noexcept { return size_; }
+
+    private:
+        /** The buffer object. */
+        GLuint ubo_;
+        /** The size of the buffer in bytes. */
+        std::size_t size_;
+        /** The binding point the buffer is bound to. */
+        GLuint bindingPoint_;
+    };
+
+    /**
+     *  The frameworks standard uniform blocks. Every GPUProgram gets its PerFrameUniforms, PerDrawUniforms and
+     *  PerLayerUniforms blocks bound to PER_FRAME_UNIFORM_BINDING, PER_DRAW_UNIFORM_BINDING and
+     *  PER_LAYER_UNIFORM_BINDING on link. The data of the blocks is written to a StreamingBuffer and bound as ranges.
+     */
+    class StandardUniforms
+    {
+    public:
+        static void InitializeStatic();
+        static void CleanUpStatic();
+
+        static void BindUniformBlocks(GLuint program);
+        static void NextFrame();
+        static void SetPerFrame(const PerFrameUniforms& perFrame);
+        static void SetPerDraw(const glm::mat4& modelMatrix, const glm::mat3& normalMatrix);
+        static void SetPerLayer(const PerLayerUniforms& perLayer);
+        /** Returns the number of layers framework draws are instanced for (set by SetPerLayer()). */
+        static GLuint GetNumRenderLayers() noexcept { return numRenderLayers_; }
+        /** Returns the per-layer uniforms set last (e.g., to cull against all layers). */
+        static const PerLayerUniforms& GetPerLayer() noexcept { return perLayer_; }
+        /** Returns the streaming buffer for other data used only in the current frame (e.g., instance attributes). */
+        static StreamingBuffer& GetStreamingBuffer() { return *uniformStream_; }
+
+        /** The name of the per-frame uniform block. */
+        static constexpr const char* PER_FRAME_UNIFORM_BLOCK = "PerFrameUniforms";
+        /** The name of the per-draw uniform block. */
+        static constexpr const char* PER_DRAW_UNIFORM_BLOCK = "PerDrawUniforms";
+        /** The name of the per-layer uniform block. */
+        static constexpr const char* PER_LAYER_UNIFORM_BLOCK = "PerLayerUniforms";
+        /** The binding point of the per-frame uniform block. */
+        static constexpr GLuint PER_FRAME_UNIFORM_BINDING = 0;
+        /** The binding point of the per-draw uniform block. */
+        static constexpr GLuint PER_DRAW_UNIFORM_BINDING = 1;
+        /** The binding point of the per-layer uniform block. */
+        static constexpr GLuint PER_LAYER_UNIFORM_BINDING = 2;
+        /** The initial size of the streaming buffer region for one frame. */
+        static constexpr std::size_t STREAMING_FRAME_SIZE = 1024 * 1024;
+
+    private:
+        static void UploadAndBind(const void* data, std::size_t size, GLuint bindingPoint);
+
+        /** The streaming buffer for all standard uniform blocks. */
+        static std::unique_ptr<StreamingBuffer> uniformStream_;
+        /** The alignment of uniform buffer ranges. */
+        static std::size_t uniformAlignment_;
+        /** The number of layers of the current per-layer uniforms. */
+        static GLuint numRenderLayers_;
+        /** The current per-layer uniforms. */
+        static PerLayerUniforms perLayer_;
+    };
+}
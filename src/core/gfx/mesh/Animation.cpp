@@ -103,6 +103,9 @@ namespace viscom {
     ///
     /// \return New animation
     ///
+    /// \see AnimationClip for a view on a time range that does not copy any
+    ///      frames.
+    ///
     Animation Animation::GetSubSequence(Time start, Time end) const
     {
         assert(start < end && "Start time must be less then stop time");
@@ -140,6 +143,20 @@ namespace viscom {
     /// \return Transform of this bone/node.
     ///
     glm::mat4 Animation::ComputePoseAtTime(std::size_t id, Time time) const
+    {
+        return ComputeBoneTransformAtTime(id, time).GetMatrix();
+    }
+
+    ///
+    /// Computes the decomposed transformation of a given bone/node, at a given
+    /// time. Channels without frames keep the identity transform.
+    ///
+    /// \param Index of the bone/node
+    /// \param Desired time
+    ///
+    /// \return Translation, rotation and scaling of this bone/node.
+    ///
+    BoneTransform Animation::ComputeBoneTransformAtTime(std::size_t id, Time time) const
     {
         time = glm::clamp(time, 0.0f, duration_);
 
@@ -149,21 +166,19 @@ namespace viscom {
         const auto& rotationFrames = channel.rotationFrames_;
         const auto& scalingFrames = channel.scalingFrames_;
 
-        glm::quat rotation;
-        glm::vec3 translation;
-        glm::vec3 scale;
+        BoneTransform result;
 
         // There is just one frame
         if (positionFrames.size() == 1) {
-            translation = positionFrames[0].second;
+            result.translation_ = positionFrames[0].second;
         }
 
         if (rotationFrames.size() == 1) {
-            rotation = rotationFrames[0].second;
+            result.rotation_ = rotationFrames[0].second;
         }
 
         if (scalingFrames.size() == 1) {
-            scale = scalingFrames[0].second;
+            result.scale_ = scalingFrames[0].second;
         }
 
         // There is more than one frame -> interpolate
@@ -171,30 +186,36 @@ namespace viscom {
             auto frameIndex = FindFrameAtTimeStamp(positionFrames, time);
             auto nextFrameIndex = (frameIndex + 1) % positionFrames.size();
 
-            translation = InterpolateFrames(positionFrames[frameIndex], positionFrames[nextFrameIndex], time).second;
+            result.translation_ = InterpolateFrames(positionFrames[frameIndex], positionFrames[nextFrameIndex], time).second;
         }
 
         if (rotationFrames.size() > 1) {
             auto frameIndex = FindFrameAtTimeStamp(rotationFrames, time);
             auto nextFrameIndex = (frameIndex + 1) % rotationFrames.size();
 
-            rotation = InterpolateFrames(rotationFrames[frameIndex], rotationFrames[nextFrameIndex], time).second;
+            result.rotation_ = InterpolateFrames(rotationFrames[frameIndex], rotationFrames[nextFrameIndex], time).second;
         }
 
         if (scalingFrames.size() > 1) {
             auto frameIndex = FindFrameAtTimeStamp(scalingFrames, time);
             auto nextFrameIndex = (frameIndex + 1) % scalingFrames.size();
 
-            scale = InterpolateFrames(scalingFrames[frameIndex], scalingFrames[nextFrameIndex], time).second;
+            result.scale_ = InterpolateFrames(scalingFrames[frameIndex], scalingFrames[nextFrameIndex], time).second;
         }
 
+        return result;
+    }
 
-        glm::mat4 poseTransform = glm::mat4_cast(rotation);
-        poseTransform[0] *= scale.x;
-        poseTransform[1] *= scale.y;
-        poseTransform[2] *= scale.z;
-        poseTransform[3] = glm::vec4(translation, 1);
-        return poseTransform;
+    ///
+    /// Computes the local transformations of all bones/nodes at a given time.
+    ///
+    /// \param Desired time
+    /// \param Pose to write to, needs to have one entry per channel.
+    ///
+    void Animation::ComputePoseAtTime(Time time, Pose& pose) const
+    {
+        assert(pose.size() >= channels_.size() && "Pose buffer is too small.");
+        for (std::size_t c = 0; c < channels_.size(); ++c) pose[c] = ComputeBoneTransformAtTime(c, time);
     }
 
     void Animation::Write(std::ostream& ofs) const
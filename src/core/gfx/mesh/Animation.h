@@ -15,6 +15,7 @@
 #include "core/utils/serializationHelper.h"
 #include <assimp/scene.h>
 #include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
 #include <glm/vec3.hpp>
 
 namespace viscom {
@@ -33,6 +34,22 @@ namespace viscom {
         std::vector<std::pair<Time, glm::vec3>> scalingFrames_;
     };
 
+    /**
+     *  Decomposed local transform of a bone/ node etc.
+     *  Poses are blended in this representation and converted to matrices only at the end.
+     */
+    struct BoneTransform
+    {
+        glm::vec3 translation_ = glm::vec3{ 0.0f };
+        glm::quat rotation_ = glm::quat{ 1.0f, 0.0f, 0.0f, 0.0f };
+        glm::vec3 scale_ = glm::vec3{ 1.0f };
+
+        glm::mat4 GetMatrix() const;
+    };
+
+    /** A pose holds one local transform for each bone. */
+    using Pose = std::vector<BoneTransform>;
+
     /** An animation for a model. */
     class Animation
     {
@@ -44,10 +61,13 @@ namespace viscom {
         float GetDuration() const;
         const std::vector<Channel>& GetChannels() const;
         const Channel& GetChannel(std::size_t id) const;
+        bool HasFrames(std::size_t id) const;
 
         Animation GetSubSequence(Time start, Time end) const;
 
         glm::mat4 ComputePoseAtTime(std::size_t id, Time time) const;
+        BoneTransform ComputeBoneTransformAtTime(std::size_t id, Time time) const;
+        void ComputePoseAtTime(Time time, Pose& pose) const;
 
         void Write(std::ostream& ofs) const;
         bool Read(std::istream& ifs);
@@ -63,6 +83,16 @@ namespace viscom {
         float duration_ = 0;
     };
 
+    inline glm::mat4 BoneTransform::GetMatrix() const
+    {
+        glm::mat4 result = glm::mat4_cast(rotation_);
+        result[0] *= scale_.x;
+        result[1] *= scale_.y;
+        result[2] *= scale_.z;
+        result[3] = glm::vec4(translation_, 1.0f);
+        return result;
+    }
+
     inline float Animation::GetFramesPerSecond() const { return framesPerSecond_; }
 
     inline float Animation::GetDuration() const { return duration_; }
@@ -71,4 +101,11 @@ namespace viscom {
 
     inline const Channel& Animation::GetChannel(std::size_t id) const { return channels_.at(id); }
 
+    /** Checks if a channel is animated, i.e., has at least one position, rotation or scaling frame. */
+    inline bool Animation::HasFrames(std::size_t id) const
+    {
+        const auto& channel = channels_.at(id);
+        return !channel.positionFrames_.empty() || !channel.rotationFrames_.empty() || !channel.scalingFrames_.empty();
+    }
+
 } // namespace get
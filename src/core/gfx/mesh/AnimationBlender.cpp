@@ -0,0 +1,333 @@
+/**
+ * @file   AnimationBlender.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of a layered animation blending engine.
+ */
+
+#include "AnimationBlender.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <glm/glm.hpp>
+
+namespace viscom {
+
+    namespace {
+        /** Scales of additive reference poses at or below this are treated as 0. */
+        constexpr float MIN_REFERENCE_SCALE = 1e-6f;
+    }
+
+    /**
+     *  Constructor with the identity transform as rest pose.
+     *  @param numBones the number of bones each computed pose has (see Mesh::GetNumberOfBones(), or Mesh::GetNumberOfAnimationChannels() to include animated nodes).
+     */
+    AnimationBlender::AnimationBlender(std::size_t numBones) :
+        AnimationBlender(Pose(numBones))
+    {
+    }
+
+    /**
+     *  Constructor.
+     *  @param restPose the local transform of each bone when no layer animates it (e.g., the first frame of an
+     *                  animation from Animation::ComputePoseAtTime()), its size is the number of bones of each computed pose.
+     */
+    AnimationBlender::AnimationBlender(const Pose& restPose) :
+        numBones_{ restPose.size() },
+        restPose_{ restPose },
+        blendedPose_(restPose.size())
+    {
+    }
+
+    /**
+     *  Adds a new layer on top of the existing ones. This allocates all pose buffers needed by the layer.
+     *  @param mode the blend mode of the layer.
+     *  @return the index of the new layer.
+     */
+    std::size_t AnimationBlender::AddLayer(AnimationBlendMode mode)
+    {
+        Layer layer;
+        layer.mode_ = mode;
+        layer.mask_.resize(numBones_, 1.0f);
+        layer.currentPose_.resize(numBones_);
+        layer.previousPose_.resize(numBones_);
+        if (mode == AnimationBlendMode::Additive) {
+            layer.current_.referencePose_.resize(numBones_);
+            layer.previous_.referencePose_.resize(numBones_);
+        }
+        layers_.emplace_back(std::move(layer));
+        return layers_.size() - 1;
+    }
+
+    /**
+     *  Plays a complete animation on a layer (without fading).
+     *  @param layer the layer index.
+     *  @param animation the animation to play.
+     *  @param loop flag if the animation should loop.
+     */
+    void AnimationBlender::Play(std::size_t layer, const Animation* animation, bool loop)
+    {
+        Play(layer, animation, 0.0f, animation->GetDuration(), loop);
+    }
+
+    /**
+     *  Plays a clip (time range) of an animation on a layer (without fading).
+     *  @param layer the layer index.
+     *  @param animation the animation to play.
+     *  @param start the start time of the clip in animation ticks.
+     *  @param end the end time of the clip in animation ticks.
+     *  @param loop flag if the clip should loop.
+     */
+    void AnimationBlender::Play(std::size_t layer, const Animation* animation, Time start, Time end, bool loop)
+    {
+        Play(layer, AnimationClip{ animation, start, end }, loop);
+    }
+
+    /**
+     *  Plays a clip on a layer (without fading).
+     *  @param layer the layer index.
+     *  @param clip the clip to play.
+     *  @param loop flag if the clip should loop.
+     */
+    void AnimationBlender::Play(std::size_t layer, const AnimationClip& clip, bool loop)
+    {
+        auto& l = layers_[layer];
+        StartClip(l.current_, clip, loop, l.mode_);
+        l.previous_.clip_ = AnimationClip{};
+        l.fadeTime_ = 0.0f;
+        l.fadeDuration_ = 0.0f;
+    }
+
+    /**
+     *  Cross-fades from the clip currently played on a layer to a new clip.
+     *  @param layer the layer index.
+     *  @param animation the animation to fade to.
+     *  @param start the start time of the clip in animation ticks.
+     *  @param end the end time of the clip in animation ticks.
+     *  @param fadeDuration the duration of the fade in seconds.
+     *  @param loop flag if the new clip should loop.
+     */
+    void AnimationBlender::CrossFade(std::size_t layer, const Animation* animation, Time start, Time end, float fadeDuration, bool loop)
+    {
+        CrossFade(layer, AnimationClip{ animation, start, end }, fadeDuration, loop);
+    }
+
+    /**
+     *  Cross-fades from the clip currently played on a layer to a new clip.
+     *  @param layer the layer index.
+     *  @param clip the clip to fade to.
+     *  @param fadeDuration the duration of the fade in seconds.
+     *  @param loop flag if the new clip should loop.
+     */
+    void AnimationBlender::CrossFade(std::size_t layer, const AnimationClip& clip, float fadeDuration, bool loop)
+    {
+        auto& l = layers_[layer];
+        if (!l.current_.clip_.IsValid() || fadeDuration <= 0.0f) {
+            Play(layer, clip, loop);
+            return;
+        }
+
+        // swapping keeps the preallocated reference poses of both clips.
+        std::swap(l.current_, l.previous_);
+        StartClip(l.current_, clip, loop, l.mode_);
+        l.fadeTime_ = 0.0f;
+        l.fadeDuration_ = fadeDuration;
+    }
+
+    /**
+     *  Stops all clips played on a layer.
+     *  @param layer the layer index.
+     */
+    void AnimationBlender::Stop(std::size_t layer)
+    {
+        auto& l = layers_[layer];
+        l.current_.clip_ = AnimationClip{};
+        l.previous_.clip_ = AnimationClip{};
+        l.fadeTime_ = 0.0f;
+        l.fadeDuration_ = 0.0f;
+    }
+
+    void AnimationBlender::SetLayerWeight(std::size_t layer, float weight)
+    {
+        layers_[layer].weight_ = glm::clamp(weight, 0.0f, 1.0f);
+    }
+
+    void AnimationBlender::SetLayerSpeed(std::size_t layer, float speed)
+    {
+        layers_[layer].speed_ = speed;
+    }
+
+    /**
+     *  Sets per bone weights for a layer. Bones with weight 0 are not influenced by the layer.
+     *  @param layer the layer index.
+     *  @param mask the weights for each bone (missing entries are treated as 0).
+     */
+    void AnimationBlender::SetLayerBoneMask(std::size_t layer, const std::vector<float>& mask)
+    {
+        auto& l = layers_[layer];
+        for (std::size_t b = 0; b < numBones_; ++b) l.mask_[b] = b < mask.size() ? glm::clamp(mask[b], 0.0f, 1.0f) : 0.0f;
+        l.useMask_ = true;
+    }
+
+    void AnimationBlender::ClearLayerBoneMask(std::size_t layer)
+    {
+        layers_[layer].useMask_ = false;
+    }
+
+    /**
+     *  Advances all clips and fades.
+     *  @param elapsedTime the time elapsed since the last update in seconds.
+     */
+    void AnimationBlender::Update(double elapsedTime)
+    {
+        for (auto& l : layers_) {
+            if (l.current_.clip_.IsValid()) {
+                AdvanceClip(l.current_, static_cast<Time>(elapsedTime) * l.current_.clip_.GetFramesPerSecond() * l.speed_);
+            }
+
+            if (l.fadeDuration_ > 0.0f) {
+                if (l.previous_.clip_.IsValid()) {
+                    AdvanceClip(l.previous_, static_cast<Time>(elapsedTime) * l.previous_.clip_.GetFramesPerSecond() * l.speed_);
+                }
+                l.fadeTime_ += static_cast<float>(elapsedTime);
+                if (l.fadeTime_ >= l.fadeDuration_) {
+                    l.previous_.clip_ = AnimationClip{};
+                    l.fadeTime_ = 0.0f;
+                    l.fadeDuration_ = 0.0f;
+                }
+            }
+        }
+    }
+
+    /**
+     *  Computes the blended local pose of all layers.
+     *  @param pose the pose to write to, needs to have GetNumberOfBones() entries.
+     */
+    void AnimationBlender::ComputeLocalPose(Pose& pose)
+    {
+        assert(pose.size() >= numBones_ && "Pose buffer is too small.");
+        std::copy(restPose_.begin(), restPose_.end(), pose.begin());
+
+        for (auto& l : layers_) {
+            if (!l.current_.clip_.IsValid() || l.weight_ <= 0.0f) continue;
+
+            SampleClip(l.current_, l.mode_, l.currentPose_);
+            if (l.fadeDuration_ > 0.0f && l.previous_.clip_.IsValid()) {
+                SampleClip(l.previous_, l.mode_, l.previousPose_);
+                BlendPoses(l.previousPose_, l.currentPose_, l.fadeTime_ / l.fadeDuration_, nullptr, l.currentPose_);
+            }
+
+            const auto* mask = l.useMask_ ? &l.mask_ : nullptr;
+            if (l.mode_ == AnimationBlendMode::Additive) AddPose(l.currentPose_, l.weight_, mask, pose);
+            else BlendPoses(pose, l.currentPose_, l.weight_, mask, pose);
+        }
+    }
+
+    /**
+     *  Computes the blended local pose of all layers as matrices.
+     *  @param pose the matrices to write to, needs to have GetNumberOfBones() entries.
+     */
+    void AnimationBlender::ComputeLocalPose(std::vector<glm::mat4>& pose)
+    {
+        assert(pose.size() >= numBones_ && "Pose buffer is too small.");
+        ComputeLocalPose(blendedPose_);
+        for (std::size_t b = 0; b < numBones_; ++b) pose[b] = blendedPose_[b].GetMatrix();
+    }
+
+    /**
+     *  Blends two poses. The result may be the same buffer as one of the inputs.
+     *  @param pose0 the first pose.
+     *  @param pose1 the second pose.
+     *  @param weight the weight of the second pose.
+     *  @param mask optional per bone weights multiplied with weight.
+     *  @param result the blended pose.
+     */
+    void AnimationBlender::BlendPoses(const Pose& pose0, const Pose& pose1, float weight, const std::vector<float>* mask, Pose& result)
+    {
+        auto numBones = glm::min(glm::min(pose0.size(), pose1.size()), result.size());
+        for (std::size_t b = 0; b < numBones; ++b) {
+            auto w = mask ? weight * (*mask)[b] : weight;
+            if (w <= 0.0f) {
+                result[b] = pose0[b];
+                continue;
+            }
+
+            const auto& t0 = pose0[b];
+            const auto& t1 = pose1[b];
+            BoneTransform blended;
+            blended.translation_ = glm::mix(t0.translation_, t1.translation_, w);
+            blended.rotation_ = glm::slerp(t0.rotation_, t1.rotation_, w);
+            blended.scale_ = glm::mix(t0.scale_, t1.scale_, w);
+            result[b] = blended;
+        }
+    }
+
+    /**
+     *  Adds a pose (relative to its reference pose) to another one.
+     *  @param additivePose the pose difference to add.
+     *  @param weight the weight of the additive pose.
+     *  @param mask optional per bone weights multiplied with weight.
+     *  @param result the pose to add to.
+     */
+    void AnimationBlender::AddPose(const Pose& additivePose, float weight, const std::vector<float>* mask, Pose& result)
+    {
+        auto numBones = glm::min(additivePose.size(), result.size());
+        const glm::quat identity{ 1.0f, 0.0f, 0.0f, 0.0f };
+        for (std::size_t b = 0; b < numBones; ++b) {
+            auto w = mask ? weight * (*mask)[b] : weight;
+            if (w <= 0.0f) continue;
+
+            const auto& delta = additivePose[b];
+            result[b].translation_ += w * delta.translation_;
+            result[b].rotation_ = glm::normalize(glm::slerp(identity, delta.rotation_, w) * result[b].rotation_);
+            result[b].scale_ *= glm::mix(glm::vec3{ 1.0f }, delta.scale_, w);
+        }
+    }
+
+    void AnimationBlender::StartClip(ClipState& state, const AnimationClip& clip, bool loop, AnimationBlendMode mode) const
+    {
+        state.clip_ = clip;
+        state.time_ = 0.0f;
+        state.loop_ = loop;
+
+        if (mode == AnimationBlendMode::Additive) {
+            auto numChannels = glm::min(numBones_, clip.GetNumberOfChannels());
+            for (std::size_t b = 0; b < numChannels; ++b) state.referencePose_[b] = clip.ComputeBoneTransformAtTime(b, 0.0f);
+            for (std::size_t b = numChannels; b < numBones_; ++b) state.referencePose_[b] = restPose_[b];
+        }
+    }
+
+    void AnimationBlender::AdvanceClip(ClipState& state, Time deltaTicks) const
+    {
+        auto length = state.clip_.GetDuration();
+        state.time_ += deltaTicks;
+        if (length <= 0.0f) state.time_ = 0.0f;
+        else if (state.loop_) {
+            state.time_ = std::fmod(state.time_, length);
+            if (state.time_ < 0.0f) state.time_ += length;
+        }
+        else state.time_ = glm::clamp(state.time_, 0.0f, length);
+    }
+
+    void AnimationBlender::SampleClip(const ClipState& state, AnimationBlendMode mode, Pose& pose) const
+    {
+        auto numChannels = glm::min(numBones_, state.clip_.GetNumberOfChannels());
+        for (std::size_t b = 0; b < numChannels; ++b) pose[b] = state.clip_.ComputeBoneTransformAtTime(b, state.time_);
+        for (std::size_t b = numChannels; b < numBones_; ++b) pose[b] = restPose_[b];
+
+        if (mode == AnimationBlendMode::Additive) {
+            for (std::size_t b = 0; b < numBones_; ++b) {
+                const auto& reference = state.referencePose_[b];
+                pose[b].translation_ -= reference.translation_;
+                pose[b].rotation_ = pose[b].rotation_ * glm::inverse(reference.rotation_);
+                // a bone scaled to 0 in the reference has no relative scale, so the layer does not scale it.
+                for (glm::vec3::length_type i = 0; i < 3; ++i) {
+                    if (glm::abs(reference.scale_[i]) > MIN_REFERENCE_SCALE) pose[b].scale_[i] /= reference.scale_[i];
+                    else pose[b].scale_[i] = 1.0f;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,115 @@
+/**
+ * @file   AnimationBlender.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of a layered animation blending engine.
+ */
+
+#pragma once
+
+#include "AnimationClip.h"
+
+namespace viscom {
+
+    /** Defines how a layer is combined with the layers below. */
+    enum class AnimationBlendMode
+    {
+        /** The layers pose replaces the pose below (weighted). */
+        Override,
+        /** The layers difference to its reference pose is added to the pose below (weighted). */
+        Additive
+    };
+
+    /**
+     *  Blends poses of several animations. The blender holds a stack of layers, each playing a clip (a time range
+     *  of an animation) and optionally cross-fading from the clip played before. All pose buffers are allocated when
+     *  layers are added, so starting clips, cross-fades and computing poses do not allocate. Layers are blended onto
+     *  the rest pose given to the constructor, bones no layer animates keep it.
+     */
+    class AnimationBlender
+    {
+    public:
+        explicit AnimationBlender(std::size_t numBones);
+        explicit AnimationBlender(const Pose& restPose);
+
+        std::size_t AddLayer(AnimationBlendMode mode = AnimationBlendMode::Override);
+        std::size_t GetNumberOfLayers() const noexcept { return layers_.size(); }
+        std::size_t GetNumberOfBones() const noexcept { return numBones_; }
+        const Pose& GetRestPose() const noexcept { return restPose_; }
+
+        void Play(std::size_t layer, const Animation* animation, bool loop = true);
+        void Play(std::size_t layer, const Animation* animation, Time start, Time end, bool loop = true);
+        void Play(std::size_t layer, const AnimationClip& clip, bool loop = true);
+        void CrossFade(std::size_t layer, const Animation* animation, Time start, Time end, float fadeDuration, bool loop = true);
+        void CrossFade(std::size_t layer, const AnimationClip& clip, float fadeDuration, bool loop = true);
+        void Stop(std::size_t layer);
+
+        void SetLayerWeight(std::size_t layer, float weight);
+        float GetLayerWeight(std::size_t layer) const { return layers_[layer].weight_; }
+        void SetLayerSpeed(std::size_t layer, float speed);
+        void SetLayerBoneMask(std::size_t layer, const std::vector<float>& mask);
+        void ClearLayerBoneMask(std::size_t layer);
+        bool IsFading(std::size_t layer) const { return layers_[layer].fadeDuration_ > 0.0f; }
+
+        void Update(double elapsedTime);
+        void ComputeLocalPose(Pose& pose);
+        void ComputeLocalPose(std::vector<glm::mat4>& pose);
+
+        static void BlendPoses(const Pose& pose0, const Pose& pose1, float weight, const std::vector<float>* mask, Pose& result);
+        static void AddPose(const Pose& additivePose, float weight, const std::vector<float>* mask, Pose& result);
+
+    private:
+        /** Playback state of a clip. */
+        struct ClipState
+        {
+            /** The clip played (invalid if nothing is played). */
+            AnimationClip clip_;
+            /** Current time relative to the clips start (in animation ticks). */
+            Time time_ = 0.0f;
+            /** Flag if the clip loops. */
+            bool loop_ = true;
+            /** The reference pose for additive layers (sampled at the clips start). */
+            Pose referencePose_;
+        };
+
+        struct Layer
+        {
+            /** The blend mode of the layer. */
+            AnimationBlendMode mode_ = AnimationBlendMode::Override;
+            /** The layers weight. */
+            float weight_ = 1.0f;
+            /** The layers playback speed. */
+            float speed_ = 1.0f;
+            /** The clip currently played. */
+            ClipState current_;
+            /** The clip faded out. */
+            ClipState previous_;
+            /** Time since the cross-fade started (in seconds). */
+            float fadeTime_ = 0.0f;
+            /** Duration of the cross-fade (in seconds), 0 if no fade is active. */
+            float fadeDuration_ = 0.0f;
+            /** Flag if a bone mask is used. */
+            bool useMask_ = false;
+            /** Per bone weights of this layer. */
+            std::vector<float> mask_;
+            /** Pose buffer for the current clip. */
+            Pose currentPose_;
+            /** Pose buffer for the faded out clip. */
+            Pose previousPose_;
+        };
+
+        void StartClip(ClipState& state, const AnimationClip& clip, bool loop, AnimationBlendMode mode) const;
+        void AdvanceClip(ClipState& state, Time deltaTicks) const;
+        void SampleClip(const ClipState& state, AnimationBlendMode mode, Pose& pose) const;
+
+        /** The number of bones in each pose. */
+        std::size_t numBones_;
+        /** The local transforms of all bones not animated by a layer. */
+        Pose restPose_;
+        /** The blending layers (bottom to top). */
+        std::vector<Layer> layers_;
+        /** Pose buffer used when computing matrices. */
+        Pose blendedPose_;
+    };
+}
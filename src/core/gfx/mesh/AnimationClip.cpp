@@ -0,0 +1,83 @@
+/**
+ * @file   AnimationClip.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of a non-owning view on a time range of an animation.
+ */
+
+#include "AnimationClip.h"
+
+#include <cassert>
+#include <glm/glm.hpp>
+
+namespace viscom {
+
+    /**
+     *  Constructor, creates a clip covering the whole animation.
+     *  @param animation the animation referenced.
+     */
+    AnimationClip::AnimationClip(const Animation* animation) noexcept :
+        animation_{ animation },
+        start_{ 0.0f },
+        end_{ animation->GetDuration() }
+    {
+    }
+
+    /**
+     *  Constructor.
+     *  @param animation the animation referenced.
+     *  @param start the start time of the clip in the animation.
+     *  @param end the end time of the clip in the animation.
+     */
+    AnimationClip::AnimationClip(const Animation* animation, Time start, Time end) noexcept :
+        animation_{ animation },
+        start_{ glm::clamp(start, 0.0f, animation->GetDuration()) },
+        end_{ glm::clamp(end, start_, animation->GetDuration()) }
+    {
+        assert(start <= end && "Start time must not be after end time.");
+    }
+
+    /**
+     *  Returns a clip of this clip. Times are relative to this clips start and clamped to it, an end before the start
+     *  results in an empty clip.
+     *  @param start the start time of the new clip.
+     *  @param end the end time of the new clip.
+     */
+    AnimationClip AnimationClip::GetSubClip(Time start, Time end) const noexcept
+    {
+        auto subStart = glm::clamp(start, 0.0f, GetDuration());
+        auto subEnd = glm::clamp(end, subStart, GetDuration());
+        return AnimationClip{ animation_, start_ + subStart, start_ + subEnd };
+    }
+
+    /**
+     *  Computes the transformation of a given bone/node, at a given time.
+     *  @param id index of the bone/node.
+     *  @param time the time relative to the clips start.
+     */
+    glm::mat4 AnimationClip::ComputePoseAtTime(std::size_t id, Time time) const
+    {
+        return ComputeBoneTransformAtTime(id, time).GetMatrix();
+    }
+
+    /**
+     *  Computes the decomposed transformation of a given bone/node, at a given time.
+     *  @param id index of the bone/node.
+     *  @param time the time relative to the clips start.
+     */
+    BoneTransform AnimationClip::ComputeBoneTransformAtTime(std::size_t id, Time time) const
+    {
+        return animation_->ComputeBoneTransformAtTime(id, start_ + glm::clamp(time, 0.0f, GetDuration()));
+    }
+
+    /**
+     *  Computes the local transformations of all bones/nodes at a given time.
+     *  @param time the time relative to the clips start.
+     *  @param pose the pose to write to, needs to have one entry per channel.
+     */
+    void AnimationClip::ComputePoseAtTime(Time time, Pose& pose) const
+    {
+        animation_->ComputePoseAtTime(start_ + glm::clamp(time, 0.0f, GetDuration()), pose);
+    }
+}
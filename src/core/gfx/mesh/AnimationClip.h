@@ -0,0 +1,50 @@
+/**
+ * @file   AnimationClip.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of a non-owning view on a time range of an animation.
+ */
+
+#pragma once
+
+#include "Animation.h"
+
+namespace viscom {
+
+    /**
+     *  A clip is a view on a time range of an animation. In contrast to Animation::GetSubSequence() no frames are
+     *  copied, the clip samples its parent animation directly. Creating clips does not allocate, so they can be cut at
+     *  runtime. Times passed to a clip are relative to the clips start (as for a sub-sequence).
+     *  The parent animation needs to outlive all clips referencing it.
+     */
+    class AnimationClip
+    {
+    public:
+        AnimationClip() noexcept = default;
+        explicit AnimationClip(const Animation* animation) noexcept;
+        AnimationClip(const Animation* animation, Time start, Time end) noexcept;
+
+        const Animation* GetAnimation() const noexcept { return animation_; }
+        Time GetStart() const noexcept { return start_; }
+        Time GetEnd() const noexcept { return end_; }
+        float GetDuration() const noexcept { return end_ - start_; }
+        float GetFramesPerSecond() const { return animation_->GetFramesPerSecond(); }
+        std::size_t GetNumberOfChannels() const { return animation_->GetChannels().size(); }
+        bool IsValid() const noexcept { return animation_ != nullptr; }
+
+        AnimationClip GetSubClip(Time start, Time end) const noexcept;
+
+        glm::mat4 ComputePoseAtTime(std::size_t id, Time time) const;
+        BoneTransform ComputeBoneTransformAtTime(std::size_t id, Time time) const;
+        void ComputePoseAtTime(Time time, Pose& pose) const;
+
+    private:
+        /** The animation referenced. */
+        const Animation* animation_ = nullptr;
+        /** Start time of the clip in the parent animation. */
+        Time start_ = 0.0f;
+        /** End time of the clip in the parent animation. */
+        Time end_ = 0.0f;
+    };
+}
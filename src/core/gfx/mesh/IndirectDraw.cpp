@@ -0,0 +1,51 @@
+/**
+ * @file   IndirectDraw.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of the CPU side data of indirect draws (MeshRenderable::DrawIndirect).
+ */
+
+#include "IndirectDraw.h"
+#include <algorithm>
+
+namespace viscom {
+
+    /**
+     *  Sorts the items by their textures, so all items of a multi draw are consecutive. Items with equal textures
+     *  keep their order.
+     *  @param items the items to sort.
+     */
+    void SortIndirectDrawItems(std::vector<IndirectDrawItem>& items)
+    {
+        std::stable_sort(items.begin(), items.end(), [](const IndirectDrawItem& left, const IndirectDrawItem& right) {
+            return left.textures_ < right.textures_;
+        });
+    }
+
+    /**
+     *  Builds one indirect draw command and one per-draw data entry for each item. The base instance of command i is i,
+     *  so the instanced draw index attribute selects the per-draw data (works without ARB_shader_draw_parameters).
+     *  Each command draws one instance per layer, the draw index attribute uses the number of layers as divisor.
+     *  @param items the items to draw.
+     *  @param nodeMatrices the world matrix of each node.
+     *  @param nodeNormalMatrices the normal matrix of each node.
+     *  @param numLayers the number of layers rendered at once (see StandardUniforms::GetNumRenderLayers()).
+     *  @param commands the draw commands, resized to the number of items.
+     *  @param drawData the per-draw data, resized to the number of items.
+     */
+    void BuildIndirectDrawCommands(const std::vector<IndirectDrawItem>& items, const std::vector<glm::mat4>& nodeMatrices,
+        const std::vector<glm::mat3>& nodeNormalMatrices, GLuint numLayers, std::vector<DrawElementsIndirectCommand>& commands,
+        std::vector<IndirectDrawData>& drawData)
+    {
+        commands.resize(items.size());
+        drawData.resize(items.size());
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            const auto& item = items[i];
+            commands[i] = DrawElementsIndirectCommand{ item.numIndices_, numLayers, item.firstIndex_, 0, static_cast<GLuint>(i) };
+            drawData[i].modelMatrix_ = nodeMatrices[item.node_];
+            drawData[i].normalMatrix_ = glm::mat4(nodeNormalMatrices[item.node_]);
+            drawData[i].materialIndex_ = item.materialIndex_;
+        }
+    }
+}
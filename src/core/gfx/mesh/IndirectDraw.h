@@ -0,0 +1,57 @@
+/**
+ * @file   IndirectDraw.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of the CPU side data of indirect draws (MeshRenderable::DrawIndirect).
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+#include "core/open_gl_fwd.h"
+
+namespace viscom {
+
+    /** Layout of a single command in a GL_DRAW_INDIRECT_BUFFER for glMultiDrawElementsIndirect. */
+    struct DrawElementsIndirectCommand
+    {
+        GLuint count_;
+        GLuint instanceCount_;
+        GLuint firstIndex_;
+        GLint baseVertex_;
+        GLuint baseInstance_;
+    };
+
+    /** Per-draw data of indirect draws as stored in the shader storage buffer (std430 layout). */
+    struct IndirectDrawData
+    {
+        glm::mat4 modelMatrix_;
+        glm::mat4 normalMatrix_;
+        std::uint32_t materialIndex_;
+        std::uint32_t padding_[3];
+    };
+
+    /** A visible sub-mesh to draw indirectly. */
+    struct IndirectDrawItem
+    {
+        /** The node the sub-mesh belongs to. */
+        std::size_t node_;
+        /** The number of indices of the sub-mesh. */
+        GLuint numIndices_;
+        /** The offset of the first index of the sub-mesh. */
+        GLuint firstIndex_;
+        /** The material index of the sub-mesh. */
+        std::uint32_t materialIndex_;
+        /** The diffuse and bump texture of the sub-mesh (0 if none), textures cannot change inside a multi draw. */
+        std::pair<GLuint, GLuint> textures_;
+    };
+
+    void SortIndirectDrawItems(std::vector<IndirectDrawItem>& items);
+    void BuildIndirectDrawCommands(const std::vector<IndirectDrawItem>& items, const std::vector<glm::mat4>& nodeMatrices,
+        const std::vector<glm::mat3>& nodeNormalMatrices, GLuint numLayers, std::vector<DrawElementsIndirectCommand>& commands,
+        std::vector<IndirectDrawData>& drawData);
+}
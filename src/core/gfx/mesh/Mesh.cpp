@@ -8,14 +8,18 @@
 
 #include "Mesh.h"
 #include "SceneMeshNode.h"
+#include "Skinning.h"
 #include "assimp_convert_helpers.h"
 #include "core/ApplicationNodeInternal.h"
+#include "core/gfx/GLStateCache.h"
 #include "core/gfx/Material.h"
 #include "core/open_gl.h"
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <cassert>
 #include <iostream>
+#include <numeric>
 #ifndef __APPLE_CC__
 #include <filesystem>
 #include <fstream>
@@ -64,6 +68,12 @@ namespace viscom {
         if (!Load(filename, binFilename, GetAppNode())) LoadAssimpMeshFromFile(filename, binFilename, GetAppNode());
 
         rootNode_->FlattenNodeTree(nodes_);
+        nodeParents_.resize(nodes_.size());
+        nodeLocalTransforms_.resize(nodes_.size());
+        for (std::size_t i = 0; i < nodes_.size(); ++i) {
+            nodeParents_[i] = nodes_[i]->GetParent() == nullptr ? std::numeric_limits<std::size_t>::max() : nodes_[i]->GetParent()->GetNodeIndex();
+            nodeLocalTransforms_[i] = nodes_[i]->GetLocalTransform();
+        }
 
         glGenBuffers(1, &indexBuffer_);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer_);
@@ -243,17 +253,35 @@ namespace viscom {
             currentMeshIndexOffset += static_cast<unsigned int>(indices[i].size()); //-V127
         }
 
+        // Reorder bones so that parents precede their children (needs to be done before animations use the bone map).
+        SortBoneHierarchy(scene->mRootNode, bones, boneWeights);
+
+        // Animated nodes that are no bones get channels after all bones.
+        auto animationChannels = bones;
+        for (auto a = 0U; a < scene->mNumAnimations; ++a) {
+            for (auto c = 0U; c < scene->mAnimations[a]->mNumChannels; ++c) {
+                animationChannels.emplace(scene->mAnimations[a]->mChannels[c]->mNodeName.C_Str(), static_cast<unsigned int>(animationChannels.size()));
+            }
+        }
+        numAnimationChannels_ = animationChannels.size();
+
         // Loading animations
         if (scene->HasAnimations()) {
             for (auto a = 0U; a < scene->mNumAnimations; ++a) {
-                animations_.emplace_back(scene->mAnimations[a], bones);
+                animations_.emplace_back(scene->mAnimations[a], animationChannels);
             }
         }
 
         // Parse parent information for each bone.
         boneParent_.resize(bones.size(), std::numeric_limits<std::size_t>::max());
+        boneParentTransforms_.resize(bones.size(), glm::mat4(1.0f));
         // Root node has a parent index of max value of size_t
         ParseBoneHierarchy(bones, scene->mRootNode, std::numeric_limits<std::size_t>::max(), glm::mat4(1.0f));
+#ifndef NDEBUG
+        for (std::size_t b = 0; b < boneParent_.size(); ++b) {
+            assert((boneParent_[b] == std::numeric_limits<std::size_t>::max() || boneParent_[b] < b) && "Bones are not sorted hierarchically.");
+        }
+#endif
 
         // Iterate all weights for each vertex
         for (auto& weights : boneWeights) {
@@ -284,6 +312,14 @@ namespace viscom {
 
         rootNode_ = std::make_unique<SceneMeshNode>(scene->mRootNode, nullptr, bones);
 
+        std::vector<const SceneMeshNode*> nodes;
+        rootNode_->FlattenNodeTree(nodes);
+        nodeAnimationChannels_.resize(nodes.size(), -1);
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            auto channel = animationChannels.find(nodes[i]->GetName());
+            if (channel != animationChannels.end()) nodeAnimationChannels_[i] = static_cast<int>(channel->second);
+        }
+
         rootNode_->GenerateBoundingBoxes(*this);
 
         GenerateBoneBoundingBoxes();
@@ -306,10 +342,10 @@ namespace viscom {
             texture = std::move(node->GetTextureManager().GetResource(texFilename));
         }
 
-        glBindTexture(GL_TEXTURE_2D, texture->getTextureId());
+        GLStateCache::BindTexture(0, GL_TEXTURE_2D, texture->getTextureId());
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glBindTexture(GL_TEXTURE_2D, 0);
+        GLStateCache::BindTexture(0, GL_TEXTURE_2D, 0);
 
         return std::move(texture);
     }
@@ -336,6 +372,10 @@ namespace viscom {
         serializeHelper::writeVV(ofs, indexVectors_);
         serializeHelper::writeV(ofs, inverseBindPoseMatrices_);
         serializeHelper::writeV(ofs, boneParent_);
+        serializeHelper::writeV(ofs, boneParentTransforms_);
+        serializeHelper::writeV(ofs, boneLevelOffsets_);
+        serializeHelper::write(ofs, numAnimationChannels_);
+        serializeHelper::writeV(ofs, nodeAnimationChannels_);
 
         serializeHelper::writeV(ofs, indices_);
 
@@ -392,6 +432,10 @@ namespace viscom {
         serializeHelper::readVV(ifs, indexVectors_);
         serializeHelper::readV(ifs, inverseBindPoseMatrices_);
         serializeHelper::readV(ifs, boneParent_);
+        serializeHelper::readV(ifs, boneParentTransforms_);
+        serializeHelper::readV(ifs, boneLevelOffsets_);
+        serializeHelper::read(ifs, numAnimationChannels_);
+        serializeHelper::readV(ifs, nodeAnimationChannels_);
 
         serializeHelper::readV(ifs, indices_);
 
@@ -436,14 +480,14 @@ namespace viscom {
     ///
     /// This function walks the hierarchy of bones and does two things:
     /// - set the parent of each bone into `boneParent_`
-    /// - update the boneOffsetMatrices_, so each matrix also includes the
-    ///   transformations of the child bones.
+    /// - set the transformations of the nodes between each bone and its parent
+    ///   bone that are no bones into `boneParentTransforms_`.
     ///
     /// \param map from name of bone to index in boneOffsetMatrices_
     /// \param current node in
     /// \param index of the parent in boneOffsetMatrices_
-    /// \param Matrix including all transformations from the parents of the
-    ///        current node.
+    /// \param Matrix including all transformations of the nodes that are no
+    ///        bones since the parent bone (or the root node).
     ///
     void Mesh::ParseBoneHierarchy(const std::map<std::string, unsigned int>& bones, const aiNode* node,
         std::size_t parent, glm::mat4 parentMatrix)
@@ -453,8 +497,12 @@ namespace viscom {
             // This node is a bone. Set the parent for this node to the current parent
             // node.
             boneParent_[bone->second] = parent;
-            // Set the new parent
+            boneParentTransforms_[bone->second] = parentMatrix;
+            // Set the new parent, the bones own transformation comes from the pose.
             parent = bone->second;
+            parentMatrix = glm::mat4(1.0f);
+        } else {
+            parentMatrix = parentMatrix * AiMatrixToGLM(node->mTransformation);
         }
 
         for (auto i = 0U; i < node->mNumChildren; ++i) {
@@ -462,6 +510,236 @@ namespace viscom {
         }
     }
 
+    namespace {
+        /** Collects the depth (number of bone ancestors) and the pre-order index of each bone in the node hierarchy. */
+        void CollectBoneDepths(const std::map<std::string, unsigned int>& bones, const aiNode* node, std::size_t depth,
+            std::vector<std::pair<std::size_t, std::size_t>>& depthAndOrder, std::size_t& orderCounter)
+        {
+            auto bone = bones.find(node->mName.C_Str());
+            if (bone != bones.end()) depthAndOrder[bone->second] = std::make_pair(depth++, orderCounter++);
+
+            for (auto i = 0U; i < node->mNumChildren; ++i) {
+                CollectBoneDepths(bones, node->mChildren[i], depth, depthAndOrder, orderCounter);
+            }
+        }
+    }
+
+    ///
+    /// Reorders all bones by their depth in the hierarchy (and by pre-order inside each depth),
+    /// so parents always precede their children and all bones of one depth level are stored
+    /// contiguously. This updates the bone map, the inverse bind pose matrices and the bone
+    /// indices of all vertex weights and fills `boneLevelOffsets_`.
+    ///
+    /// \param root node of the scene
+    /// \param map from name of bone to index in inverseBindPoseMatrices_
+    /// \param bone indices and weights for each vertex
+    ///
+    void Mesh::SortBoneHierarchy(const aiNode* rootNode, std::map<std::string, unsigned int>& bones,
+        std::vector<std::vector<std::pair<unsigned int, float>>>& boneWeights)
+    {
+        boneLevelOffsets_.clear();
+        if (bones.empty()) return;
+
+        // bones not found in the hierarchy are treated as roots and sorted to the end of the first level.
+        std::vector<std::pair<std::size_t, std::size_t>> depthAndOrder(bones.size(),
+            std::make_pair(std::size_t{ 0 }, std::numeric_limits<std::size_t>::max()));
+        std::size_t orderCounter = 0;
+        CollectBoneDepths(bones, rootNode, 0, depthAndOrder, orderCounter);
+
+        std::vector<unsigned int> sortedBones(bones.size());
+        std::iota(sortedBones.begin(), sortedBones.end(), 0U);
+        std::stable_sort(sortedBones.begin(), sortedBones.end(),
+            [&depthAndOrder](unsigned int left, unsigned int right) { return depthAndOrder[left] < depthAndOrder[right]; });
+
+        std::vector<unsigned int> newBoneIndex(bones.size());
+        std::vector<glm::mat4> inverseBindPoseMatrices(bones.size());
+        for (std::size_t i = 0; i < sortedBones.size(); ++i) {
+            newBoneIndex[sortedBones[i]] = static_cast<unsigned int>(i);
+            inverseBindPoseMatrices[i] = inverseBindPoseMatrices_[sortedBones[i]];
+
+            if (i == 0 || depthAndOrder[sortedBones[i]].first != depthAndOrder[sortedBones[i - 1]].first) {
+                boneLevelOffsets_.push_back(i);
+            }
+        }
+        boneLevelOffsets_.push_back(sortedBones.size());
+        inverseBindPoseMatrices_ = std::move(inverseBindPoseMatrices);
+
+        for (auto& bone : bones) bone.second = newBoneIndex[bone.second];
+        for (auto& weights : boneWeights) {
+            // vertices of meshes without bones have a single zero weight for bone 0.
+            for (auto& weight : weights) if (weight.second > 0.0f) weight.first = newBoneIndex[weight.first];
+        }
+    }
+
+    /**
+     *  Computes the global transformations of all bones in a single linear pass over the hierarchy. Transformations of
+     *  nodes between bones that are no bones (e.g., an armature node) are included.
+     *  @param localPose the local transformation of each bone (e.g., from Animation::ComputePoseAtTime).
+     *  @param globalPose the buffer to write the global transformations to, needs to have GetNumberOfBones() entries.
+     */
+    void Mesh::ComputeGlobalBoneTransforms(const std::vector<glm::mat4>& localPose, std::vector<glm::mat4>& globalPose) const
+    {
+        assert(localPose.size() >= GetNumberOfBones() && globalPose.size() >= GetNumberOfBones());
+        for (std::size_t b = 0; b < boneParent_.size(); ++b) {
+            if (boneParent_[b] == std::numeric_limits<std::size_t>::max()) globalPose[b] = boneParentTransforms_[b] * localPose[b];
+            else globalPose[b] = globalPose[boneParent_[b]] * boneParentTransforms_[b] * localPose[b];
+        }
+    }
+
+    /**
+     *  Computes the skinning matrices (as used by shaders and SkinVertices) of all bones.
+     *  @param localPose the local transformation of each bone.
+     *  @param skinningMatrices the buffer to write the skinning matrices to, needs to have GetNumberOfBones() entries.
+     */
+    void Mesh::ComputeSkinningMatrices(const std::vector<glm::mat4>& localPose, std::vector<glm::mat4>& skinningMatrices) const
+    {
+        ComputeGlobalBoneTransforms(localPose, skinningMatrices);
+        for (std::size_t b = 0; b < inverseBindPoseMatrices_.size(); ++b) {
+            skinningMatrices[b] = globalInverse_ * skinningMatrices[b] * inverseBindPoseMatrices_[b];
+        }
+    }
+
+    /**
+     *  Computes the local transformations of all nodes (in GetNodes() order) from an animation pose.
+     *  Nodes without animation channel and nodes whose channel has no frames in the animation keep their static
+     *  transformation (Animation::ComputePoseAtTime returns the identity for these channels).
+     *  @param animation the animation the pose was computed from.
+     *  @param pose the local transformation of each animation channel (see GetNumberOfAnimationChannels()).
+     *  @param localTransforms the buffer to write the local transformations to, needs to have GetNodes().size() entries.
+     */
+    void Mesh::ComputeNodeLocalTransforms(const Animation& animation, const std::vector<glm::mat4>& pose,
+        std::vector<glm::mat4>& localTransforms) const
+    {
+        assert(pose.size() >= numAnimationChannels_ && localTransforms.size() >= nodeLocalTransforms_.size());
+        for (std::size_t i = 0; i < nodeLocalTransforms_.size(); ++i) {
+            auto channel = nodeAnimationChannels_[i];
+            if (channel == -1 || !animation.HasFrames(channel)) localTransforms[i] = nodeLocalTransforms_[i];
+            else localTransforms[i] = pose[channel];
+        }
+    }
+
+    /**
+     *  Computes the world transformations of all nodes (in GetNodes() order) in a single linear pass.
+     *  @param modelMatrix the model matrix of the mesh.
+     *  @param localTransforms the local transformation of each node (e.g., GetNodeLocalTransforms()).
+     *  @param worldTransforms the buffer to write the world transformations to, needs to have GetNodes().size() entries.
+     */
+    void Mesh::ComputeNodeWorldTransforms(const glm::mat4& modelMatrix, const std::vector<glm::mat4>& localTransforms,
+        std::vector<glm::mat4>& worldTransforms) const
+    {
+        assert(localTransforms.size() >= nodeParents_.size() && worldTransforms.size() >= nodeParents_.size());
+        for (std::size_t i = 0; i < nodeParents_.size(); ++i) {
+            const auto& parentTransform = nodeParents_[i] == std::numeric_limits<std::size_t>::max() ? modelMatrix : worldTransforms[nodeParents_[i]];
+            worldTransforms[i] = parentTransform * localTransforms[i];
+        }
+    }
+
+    /**
+     *  Skins the meshes vertices on the CPU (e.g., for picking on animated meshes).
+     *  @param skinningMatrices the skinning matrix for each bone (as used in shaders).
+     *  @param positions the buffer to write the skinned positions to, needs to have GetVertices().size() entries.
+     */
+    void Mesh::SkinVertices(const std::vector<glm::mat4>& skinningMatrices, std::vector<glm::vec3>& positions) const
+    {
+        assert(skinningMatrices.size() >= GetNumberOfBones() && positions.size() >= vertices_.size());
+        SkinPositions(vertices_.data(), boneOffsetMatrixIndices_.data(), boneWeights_.data(), vertices_.size(),
+            skinningMatrices.data(), positions.data());
+    }
+
+    /**
+     *  Skins the meshes vertices and normals on the CPU.
+     *  @param skinningMatrices the skinning matrix for each bone (as used in shaders).
+     *  @param positions the buffer to write the skinned positions to, needs to have GetVertices().size() entries.
+     *  @param normals the buffer to write the skinned normals to, needs to have GetNormals().size() entries.
+     */
+    void Mesh::SkinVertices(const std::vector<glm::mat4>& skinningMatrices, std::vector<glm::vec3>& positions, std::vector<glm::vec3>& normals) const
+    {
+        assert(skinningMatrices.size() >= GetNumberOfBones() && positions.size() >= vertices_.size() && normals.size() >= vertices_.size());
+        SkinPositionsAndNormals(vertices_.data(), normals_.data(), boneOffsetMatrixIndices_.data(), boneWeights_.data(),
+            vertices_.size(), skinningMatrices.data(), positions.data(), normals.data());
+    }
+
+    /**
+     *  Returns the bounding box of the animated mesh, computed from the transformed bone bounding boxes.
+     *  This is a lot cheaper than skinning all vertices and can be updated every frame for culling.
+     *  @param skinningMatrices the skinning matrix for each bone (as used in shaders).
+     */
+    math::AABB3<float> Mesh::GetAnimatedBoundingBox(const std::vector<glm::mat4>& skinningMatrices) const
+    {
+        assert(skinningMatrices.size() >= boneBoundingBoxes_.size());
+        return ComputeSkinnedBoundingBox(boneBoundingBoxes_, skinningMatrices.data());
+    }
+
+    /**
+     *  Picks the closest triangle hit by a ray (on the CPU, no GPU read back needed).
+     *  @param origin the rays origin in world space.
+     *  @param direction the rays direction in world space.
+     *  @param nodeWorldTransforms the world transform of each node (see ComputeNodeWorldTransforms).
+     *  @param result the closest hit, only written if the mesh was hit.
+     *  @param maxDistance the maximum distance along the ray (in multiples of direction).
+     *  @return whether the mesh was hit.
+     */
+    bool Mesh::Pick(const glm::vec3& origin, const glm::vec3& direction, const std::vector<glm::mat4>& nodeWorldTransforms,
+        MeshPickResult& result, float maxDistance) const
+    {
+        assert(nodeWorldTransforms.size() >= nodes_.size());
+        std::call_once(subMeshBVHsBuilt_, [this]() { BuildSubMeshBVHs(); });
+
+        bool found = false;
+        for (std::size_t n = 0; n < nodes_.size(); ++n) {
+            if (nodes_[n]->GetNumberOfSubMeshes() == 0) continue;
+
+            // the ray parameter is invariant under affine transformations, so distances stay in world space.
+            auto worldToNode = glm::inverse(nodeWorldTransforms[n]);
+            auto localOrigin = glm::vec3(worldToNode * glm::vec4(origin, 1.0f));
+            auto localDirection = glm::vec3(worldToNode * glm::vec4(direction, 0.0f));
+            for (std::size_t i = 0; i < nodes_[n]->GetNumberOfSubMeshes(); ++i) {
+                auto subMeshId = nodes_[n]->GetSubMeshID(i);
+                TriangleHit hit;
+                if (!subMeshBVHs_[subMeshId].Intersect(localOrigin, localDirection, maxDistance, hit)) continue;
+
+                maxDistance = hit.distance_;
+                result.node_ = n;
+                result.subMesh_ = subMeshId;
+                result.triangle_ = hit.triangle_;
+                result.barycentrics_ = hit.barycentrics_;
+                result.distance_ = hit.distance_;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    /**
+     *  Picks the closest triangle of the mesh in its static pose.
+     *  @param pickRay the pick ray as start and end point (see CameraHelper::GetPickRay), distances are in world units.
+     *  @param modelMatrix the model matrix of the mesh.
+     *  @param result the closest hit, only written if the mesh was hit.
+     *  @return whether the mesh was hit.
+     */
+    bool Mesh::Pick(const math::Line3<float>& pickRay, const glm::mat4& modelMatrix, MeshPickResult& result) const
+    {
+        std::vector<glm::mat4> nodeWorldTransforms(nodes_.size());
+        ComputeNodeWorldTransforms(modelMatrix, nodeLocalTransforms_, nodeWorldTransforms);
+        return Pick(pickRay[0], glm::normalize(pickRay[1] - pickRay[0]), nodeWorldTransforms, result);
+    }
+
+    /** Returns the triangle BVH of a sub-mesh (in sub-mesh space). */
+    const TriangleBVH& Mesh::GetSubMeshBVH(std::size_t subMeshIndex) const
+    {
+        std::call_once(subMeshBVHsBuilt_, [this]() { BuildSubMeshBVHs(); });
+        return subMeshBVHs_[subMeshIndex];
+    }
+
+    void Mesh::BuildSubMeshBVHs() const
+    {
+        subMeshBVHs_.clear();
+        subMeshBVHs_.reserve(subMeshes_.size());
+        for (const auto& subMesh : subMeshes_) {
+            subMeshBVHs_.emplace_back(vertices_, indices_.data() + subMesh.GetIndexOffset(), subMesh.GetNumberOfTriangles());
+        }
+    }
+
     ///
     /// Generate all BoundingBoxes for the bones.
     ///
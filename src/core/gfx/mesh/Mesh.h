@@ -10,12 +10,14 @@
 
 #include "Animation.h"
 #include "SubMesh.h"
+#include "TriangleBVH.h"
 #include "core/gfx/Material.h"
 #include "core/main.h"
 #include "core/math/aabb.h"
 #include "core/open_gl_fwd.h"
 #include "core/resources/Resource.h"
 #include "core/utils/serializationHelper.h"
+#include <mutex>
 
 struct aiNode;
 
@@ -28,6 +30,21 @@ namespace viscom {
     class Texture;
     class TextureManager;
 
+    /** Result of picking a mesh with a ray. */
+    struct MeshPickResult
+    {
+        /** The node (in Mesh::GetNodes() order) the sub-mesh hit is referenced by. */
+        std::size_t node_ = 0;
+        /** The sub-mesh hit. */
+        std::size_t subMesh_ = 0;
+        /** The triangle hit in the sub-mesh, its first index is at GetIndexOffset() + 3 * triangle_. */
+        std::size_t triangle_ = 0;
+        /** The barycentric coordinates of the hit with respect to the second and third vertex. */
+        glm::vec2 barycentrics_{ 0.0f };
+        /** The distance along the ray (in multiples of the rays direction). */
+        float distance_ = std::numeric_limits<float>::max();
+    };
+
     /**
      * Helper class for loading an OpenGL texture from file.
      */
@@ -52,6 +69,10 @@ namespace viscom {
         const std::vector<SubMesh>& GetSubMeshes() const noexcept { return subMeshes_; }
         const std::vector<const SceneMeshNode*>& GetNodes() const noexcept { return nodes_; }
         const SceneMeshNode* GetRootNode() const noexcept { return rootNode_.get(); }
+        /** Returns the parent index of each node (in GetNodes() order, the root has the max value of size_t). */
+        const std::vector<std::size_t>& GetNodeParents() const noexcept { return nodeParents_; }
+        /** Returns the static local transformation of each node (in GetNodes() order). */
+        const std::vector<glm::mat4>& GetNodeLocalTransforms() const noexcept { return nodeLocalTransforms_; }
 
         const std::vector<glm::vec3>& GetVertices() const noexcept { return vertices_; }
         const std::vector<glm::vec3>& GetNormals() const noexcept { return normals_; }
@@ -67,6 +88,7 @@ namespace viscom {
         GLuint GetIndexBuffer() const noexcept { return indexBuffer_; }
 
         const Animation* GetAnimation(std::size_t animationIndex = 0) const { return &animations_[animationIndex]; }
+        std::size_t GetNumberOfMaterials() const noexcept { return materials_.size(); }
         const Material* GetMaterial(std::size_t materialIndex) const { return &materials_[materialIndex]; }
         const MaterialTextures* GetMaterialTexture(std::size_t materialIndex) const { return &materialTextures_[materialIndex]; }
 
@@ -74,15 +96,36 @@ namespace viscom {
         const std::vector<math::AABB3<float>>& GetBoneBoundingBoxes() const noexcept { return boneBoundingBoxes_; }
         std::size_t GetParentBone(std::size_t boneIndex) const { return boneParent_[boneIndex]; }
         std::size_t GetNumberOfBones() const noexcept { return inverseBindPoseMatrices_.size(); }
+        /** Returns the number of animation channels, i.e., all bones followed by all animated nodes that are no bones. */
+        std::size_t GetNumberOfAnimationChannels() const noexcept { return numAnimationChannels_; }
+        /** Returns the number of depth levels in the bone hierarchy. */
+        std::size_t GetNumberOfBoneLevels() const noexcept { return boneLevelOffsets_.empty() ? 0 : boneLevelOffsets_.size() - 1; }
+        /** Returns the index range [first, second) of all bones in a depth level. Bones of one level are independent of each other. */
+        std::pair<std::size_t, std::size_t> GetBoneLevel(std::size_t level) const { return std::make_pair(boneLevelOffsets_[level], boneLevelOffsets_[level + 1]); }
 
         glm::mat4 GetGlobalInverse() const { return globalInverse_; }
 
+        void ComputeNodeLocalTransforms(const Animation& animation, const std::vector<glm::mat4>& pose,
+            std::vector<glm::mat4>& localTransforms) const;
+        void ComputeNodeWorldTransforms(const glm::mat4& modelMatrix, const std::vector<glm::mat4>& localTransforms,
+            std::vector<glm::mat4>& worldTransforms) const;
+        void ComputeGlobalBoneTransforms(const std::vector<glm::mat4>& localPose, std::vector<glm::mat4>& globalPose) const;
+        void ComputeSkinningMatrices(const std::vector<glm::mat4>& localPose, std::vector<glm::mat4>& skinningMatrices) const;
+        void SkinVertices(const std::vector<glm::mat4>& skinningMatrices, std::vector<glm::vec3>& positions) const;
+        void SkinVertices(const std::vector<glm::mat4>& skinningMatrices, std::vector<glm::vec3>& positions, std::vector<glm::vec3>& normals) const;
+        math::AABB3<float> GetAnimatedBoundingBox(const std::vector<glm::mat4>& skinningMatrices) const;
+
+        bool Pick(const glm::vec3& origin, const glm::vec3& direction, const std::vector<glm::mat4>& nodeWorldTransforms,
+            MeshPickResult& result, float maxDistance = std::numeric_limits<float>::max()) const;
+        bool Pick(const math::Line3<float>& pickRay, const glm::mat4& modelMatrix, MeshPickResult& result) const;
+        const TriangleBVH& GetSubMeshBVH(std::size_t subMeshIndex) const;
+
     protected:
         virtual void Load(std::optional<std::vector<std::uint8_t>>& data) override;
         virtual void LoadFromMemory(const void* data, std::size_t size) override;
 
     private:
-        using VersionableSerializerType = serializeHelper::VersionableSerializer<'V', 'M', 'E', 'S', 1000>;
+        using VersionableSerializerType = serializeHelper::VersionableSerializer<'V', 'M', 'E', 'S', 1003>;
 
         std::shared_ptr<const Texture> LoadTexture(const std::string& relFilename, ApplicationNodeInternal* node) const;
         void LoadAssimpMeshFromFile(const std::string& filename, const std::string& binFilename, ApplicationNodeInternal* node);
@@ -92,10 +135,13 @@ namespace viscom {
         bool Load(const std::string& filename, const std::string& binFilename, ApplicationNodeInternal* node);
         bool Read(std::istream& ifs, TextureManager& texMan);
 
+        void SortBoneHierarchy(const aiNode* rootNode, std::map<std::string, unsigned int>& bones,
+            std::vector<std::vector<std::pair<unsigned int, float>>>& boneWeights);
         void ParseBoneHierarchy(const std::map<std::string, unsigned int>& bones, const aiNode* node,
             std::size_t parent, glm::mat4 parentMatrix);
 
         void GenerateBoneBoundingBoxes();
+        void BuildSubMeshBVHs() const;
 
         /** Filename of this mesh. */
         std::string filename_;
@@ -126,6 +172,16 @@ namespace viscom {
         *  boneOffsetMatrices_
         */
         std::vector<std::size_t> boneParent_;
+        /**
+         *  Transformation of the nodes between a bone and its parent bone (or the root node for root bones) that are
+         *  no bones, e.g., an armature node. Applied between the global transformation of the parent and the bone.
+         */
+        std::vector<glm::mat4> boneParentTransforms_;
+        /**
+         *  Bones are sorted by their depth in the hierarchy, so parents always precede their children.
+         *  Stores the index of the first bone of each depth level (and the number of bones as last entry).
+         */
+        std::vector<std::size_t> boneLevelOffsets_;
 
         /** Holds all the indices used by the sub-meshes. */
         std::vector<unsigned int> indices_;
@@ -138,6 +194,14 @@ namespace viscom {
         std::vector<SubMesh> subMeshes_;
         /** Nodes in this mesh. */
         std::vector<const SceneMeshNode*> nodes_;
+        /** Parent index of each node in nodes_. */
+        std::vector<std::size_t> nodeParents_;
+        /** Static local transformation of each node in nodes_. */
+        std::vector<glm::mat4> nodeLocalTransforms_;
+        /** Animation channel of each node in nodes_ (-1 if the node is not animated). */
+        std::vector<int> nodeAnimationChannels_;
+        /** Number of animation channels (bones first, then animated nodes that are no bones). */
+        std::size_t numAnimationChannels_ = 0;
         /** Animations of this mesh */
         std::vector<Animation> animations_;
 
@@ -148,6 +212,11 @@ namespace viscom {
         /** AABB for all bones */
         std::vector<math::AABB3<float>> boneBoundingBoxes_;
 
+        /** Triangle BVHs for picking (in sub-mesh space), built on first use. */
+        mutable std::vector<TriangleBVH> subMeshBVHs_;
+        /** Flag to build the triangle BVHs only once. */
+        mutable std::once_flag subMeshBVHsBuilt_;
+
         /** Holds the OpenGL index buffer. */
         GLuint indexBuffer_;
     };
@@ -9,16 +9,42 @@
 
 #include "SceneMeshNode.h"
 #include "SubMesh.h"
+#include "core/gfx/GLStateCache.h"
 #include "core/gfx/Material.h"
 #include "core/gfx/Texture.h"
+#include "core/math/math.h"
+#include "core/math/transforms.h"
 #include "core/open_gl.h"
 #include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <numeric>
 
 #include "MeshRenderable.h"
+#include "RenderQueue.h"
 
 namespace viscom {
 
+    namespace {
+        /** A material as stored in the shader storage buffer for indirect drawing (std430 layout). */
+        struct IndirectMaterialData
+        {
+            glm::vec4 ambientAlpha_;
+            glm::vec4 diffuseSpecularExponent_;
+            glm::vec4 specularRefraction_;
+            float bumpMultiplier_;
+            float padding_[3];
+        };
+
+        /** Returns the diffuse and bump texture ids of a sub-mesh (0 if none). */
+        std::pair<GLuint, GLuint> GetSubMeshTextures(const Mesh* mesh, const SubMesh* subMesh)
+        {
+            auto matTex = mesh->GetMaterialTexture(subMesh->GetMaterialIndex());
+            return std::make_pair(matTex->diffuseTex ? matTex->diffuseTex->getTextureId() : 0,
+                matTex->bumpTex ? matTex->bumpTex->getTextureId() : 0);
+        }
+    }
+
     /**
      * Constructor.
      * @param renderMesh the Mesh to use for rendering.
@@ -30,6 +56,25 @@ namespace viscom {
         vao_(0),
         drawProgram_(program)
     {
+        const auto& nodes = mesh_->GetNodes();
+        const auto& nodeParents = mesh_->GetNodeParents();
+        subTreeSubMeshCounts_.resize(nodes.size(), 0);
+        subTreeEnds_.resize(nodes.size());
+        // nodes are in pre-order, so all children are processed before their parent.
+        for (auto i = nodes.size(); i > 0; --i) {
+            subTreeSubMeshCounts_[i - 1] += nodes[i - 1]->GetNumberOfSubMeshes();
+            subTreeEnds_[i - 1] = glm::max(subTreeEnds_[i - 1], i);
+            auto parent = nodeParents[i - 1];
+            if (parent == std::numeric_limits<std::size_t>::max()) continue;
+            subTreeSubMeshCounts_[parent] += subTreeSubMeshCounts_[i - 1];
+            subTreeEnds_[parent] = glm::max(subTreeEnds_[parent], subTreeEnds_[i - 1]);
+        }
+        nodeWorldMatrices_.resize(nodes.size());
+        nodeNormalMatrices_.resize(nodes.size());
+        nodeModelMatrices_.resize(nodes.size());
+        nodeModelNormalMatrices_.resize(nodes.size());
+
+        if (GLEW_VERSION_4_3) CreateIndirectBuffers();
     }
 
     /**
@@ -41,6 +86,18 @@ namespace viscom {
         vbo_ = 0;
         if (vao_ != 0) glDeleteVertexArrays(1, &vao_);
         vao_ = 0;
+        if (drawIndexBuffer_ != 0) glDeleteBuffers(1, &drawIndexBuffer_);
+        drawIndexBuffer_ = 0;
+        if (indirectBuffer_ != 0) glDeleteBuffers(1, &indirectBuffer_);
+        indirectBuffer_ = 0;
+        if (drawDataBuffer_ != 0) glDeleteBuffers(1, &drawDataBuffer_);
+        drawDataBuffer_ = 0;
+        if (materialBuffer_ != 0) glDeleteBuffers(1, &materialBuffer_);
+        materialBuffer_ = 0;
+        if (instanceVao_ != 0) glDeleteVertexArrays(1, &instanceVao_);
+        instanceVao_ = 0;
+        // the names can be reused by new objects.
+        GLStateCache::Invalidate();
     }
 
     /**
@@ -52,12 +109,52 @@ namespace viscom {
         vbo_(orig.vbo_),
         vao_(orig.vao_),
         drawProgram_(orig.drawProgram_),
-        uniformLocations_(std::move(orig.uniformLocations_))
+        uniformLocations_(std::move(orig.uniformLocations_)),
+        usesPerDrawBlock_(orig.usesPerDrawBlock_),
+        subTreeSubMeshCounts_(std::move(orig.subTreeSubMeshCounts_)),
+        subTreeEnds_(std::move(orig.subTreeEnds_)),
+        cachedModelMatrix_(orig.cachedModelMatrix_),
+        nodeTransformsValid_(orig.nodeTransformsValid_),
+        nodeWorldMatrices_(std::move(orig.nodeWorldMatrices_)),
+        nodeNormalMatrices_(std::move(orig.nodeNormalMatrices_)),
+        nodeModelTransformsValid_(orig.nodeModelTransformsValid_),
+        nodeModelMatrices_(std::move(orig.nodeModelMatrices_)),
+        nodeModelNormalMatrices_(std::move(orig.nodeModelNormalMatrices_)),
+        customNodeLocalTransforms_(std::move(orig.customNodeLocalTransforms_)),
+        customNodeBoundingBoxes_(std::move(orig.customNodeBoundingBoxes_)),
+        customSubMeshBoundingBoxes_(std::move(orig.customSubMeshBoundingBoxes_)),
+        statistics_(orig.statistics_),
+        drawIndexLocation_(orig.drawIndexLocation_),
+        drawIndexBuffer_(orig.drawIndexBuffer_),
+        indirectBuffer_(orig.indirectBuffer_),
+        drawDataBuffer_(orig.drawDataBuffer_),
+        materialBuffer_(orig.materialBuffer_),
+        indirectCommands_(std::move(orig.indirectCommands_)),
+        indirectDrawData_(std::move(orig.indirectDrawData_)),
+        indirectDrawItems_(std::move(orig.indirectDrawItems_)),
+        instanceMatrixLocation_(orig.instanceMatrixLocation_),
+        instanceVao_(orig.instanceVao_),
+        instanceBoxes_(std::move(orig.instanceBoxes_)),
+        instanceVisibility_(std::move(orig.instanceVisibility_)),
+        instanceLayerVisibility_(std::move(orig.instanceLayerVisibility_)),
+        cullingFrusta_(std::move(orig.cullingFrusta_)),
+        visibleInstances_(std::move(orig.visibleInstances_)),
+        occlusionBuffer_(orig.occlusionBuffer_),
+        occluderCandidates_(std::move(orig.occluderCandidates_)),
+        occluders_(std::move(orig.occluders_)),
+        occludersBuffer_(orig.occludersBuffer_)
     {
         orig.mesh_ = nullptr;
         orig.vbo_ = 0;
         orig.vao_ = 0;
         orig.drawProgram_ = nullptr;
+        orig.drawIndexLocation_ = -1;
+        orig.drawIndexBuffer_ = 0;
+        orig.indirectBuffer_ = 0;
+        orig.drawDataBuffer_ = 0;
+        orig.materialBuffer_ = 0;
+        orig.instanceMatrixLocation_ = -1;
+        orig.instanceVao_ = 0;
     }
 
     /**
@@ -73,54 +170,646 @@ namespace viscom {
             vao_ = orig.vao_;
             drawProgram_ = orig.drawProgram_;
             uniformLocations_ = std::move(orig.uniformLocations_);
+            usesPerDrawBlock_ = orig.usesPerDrawBlock_;
+            subTreeSubMeshCounts_ = std::move(orig.subTreeSubMeshCounts_);
+            subTreeEnds_ = std::move(orig.subTreeEnds_);
+            cachedModelMatrix_ = orig.cachedModelMatrix_;
+            nodeTransformsValid_ = orig.nodeTransformsValid_;
+            nodeWorldMatrices_ = std::move(orig.nodeWorldMatrices_);
+            nodeNormalMatrices_ = std::move(orig.nodeNormalMatrices_);
+            nodeModelTransformsValid_ = orig.nodeModelTransformsValid_;
+            nodeModelMatrices_ = std::move(orig.nodeModelMatrices_);
+            nodeModelNormalMatrices_ = std::move(orig.nodeModelNormalMatrices_);
+            customNodeLocalTransforms_ = std::move(orig.customNodeLocalTransforms_);
+            customNodeBoundingBoxes_ = std::move(orig.customNodeBoundingBoxes_);
+            customSubMeshBoundingBoxes_ = std::move(orig.customSubMeshBoundingBoxes_);
+            statistics_ = orig.statistics_;
+            drawIndexLocation_ = orig.drawIndexLocation_;
+            drawIndexBuffer_ = orig.drawIndexBuffer_;
+            indirectBuffer_ = orig.indirectBuffer_;
+            drawDataBuffer_ = orig.drawDataBuffer_;
+            materialBuffer_ = orig.materialBuffer_;
+            indirectCommands_ = std::move(orig.indirectCommands_);
+            indirectDrawData_ = std::move(orig.indirectDrawData_);
+            indirectDrawItems_ = std::move(orig.indirectDrawItems_);
+            instanceMatrixLocation_ = orig.instanceMatrixLocation_;
+            instanceVao_ = orig.instanceVao_;
+            instanceBoxes_ = std::move(orig.instanceBoxes_);
+            instanceVisibility_ = std::move(orig.instanceVisibility_);
+            instanceLayerVisibility_ = std::move(orig.instanceLayerVisibility_);
+            cullingFrusta_ = std::move(orig.cullingFrusta_);
+            visibleInstances_ = std::move(orig.visibleInstances_);
+            occlusionBuffer_ = orig.occlusionBuffer_;
+            occluderCandidates_ = std::move(orig.occluderCandidates_);
+            occluders_ = std::move(orig.occluders_);
+            occludersBuffer_ = orig.occludersBuffer_;
             orig.mesh_ = nullptr;
             orig.vbo_ = 0;
             orig.vao_ = 0;
             orig.drawProgram_ = nullptr;
+            orig.drawIndexLocation_ = -1;
+            orig.drawIndexBuffer_ = 0;
+            orig.indirectBuffer_ = 0;
+            orig.drawDataBuffer_ = 0;
+            orig.materialBuffer_ = 0;
+            orig.instanceMatrixLocation_ = -1;
+            orig.instanceVao_ = 0;
         }
         return *this;
     }
 
+    /**
+     *  Draws the whole mesh.
+     *  @param modelMatrix the model matrix of the mesh.
+     *  @param overrideBump if true the bump multiplier uniform is not set from the material.
+     */
     void MeshRenderable::Draw(const glm::mat4& modelMatrix, bool overrideBump) const
     {
-        glUseProgram(drawProgram_->getProgramId());
-        glBindVertexArray(vao_);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-        DrawNode(modelMatrix, mesh_->GetRootNode(), overrideBump);
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        UpdateNodeTransforms(modelMatrix);
+        // the application may have changed the state with direct OpenGL calls since the last framework draw.
+        GLStateCache::Invalidate();
+        GLStateCache::UseProgram(drawProgram_->getProgramId());
+        GLStateCache::BindVertexArray(vao_);
+        SetIdentityInstanceMatrix(instanceMatrixLocation_);
+        SetLayerDivisor(drawIndexLocation_, 1);
+        ForEachVisibleSubMesh(nullptr, [this, overrideBump](std::size_t node, const SubMesh* subMesh) {
+            DrawSubMesh(nodeWorldMatrices_[node], nodeNormalMatrices_[node], subMesh, overrideBump);
+        });
+        GLStateCache::BindVertexArray(0);
+    }
+
+    /**
+     *  Draws all parts of the mesh inside a view frustum. Sub-trees of the scene are skipped when their bounding box is
+     *  outside, so each window (or projector) only draws what it sees.
+     *  @param modelMatrix the model matrix of the mesh.
+     *  @param viewProjection the view projection matrix of the current window (CameraHelper::GetViewPerspectiveMatrix()).
+     *  @param overrideBump if true the bump multiplier uniform is not set from the material.
+     */
+    void MeshRenderable::Draw(const glm::mat4& modelMatrix, const glm::mat4& viewProjection, bool overrideBump) const
+    {
+        UpdateNodeTransforms(modelMatrix);
+        const auto& frusta = GetCullingFrusta(viewProjection);
+        GLStateCache::Invalidate();
+        GLStateCache::UseProgram(drawProgram_->getProgramId());
+        GLStateCache::BindVertexArray(vao_);
+        SetIdentityInstanceMatrix(instanceMatrixLocation_);
+        SetLayerDivisor(drawIndexLocation_, 1);
+        ForEachVisibleSubMesh(&frusta, [this, overrideBump](std::size_t node, const SubMesh* subMesh) {
+            DrawSubMesh(nodeWorldMatrices_[node], nodeNormalMatrices_[node], subMesh, overrideBump);
+        });
+        GLStateCache::BindVertexArray(0);
     }
 
-    void MeshRenderable::DrawNode(const glm::mat4& modelMatrix, const SceneMeshNode* node, bool overrideBump) const
+    /**
+     *  Draws the whole mesh with a single glMultiDrawElementsIndirect per set of textures. The matrices and materials
+     *  are read from shader storage buffers (see class description). Falls back to Draw() if the context is older
+     *  than OpenGL 4.3 or the shader has no draw index attribute.
+     *  @param modelMatrix the model matrix of the mesh.
+     */
+    void MeshRenderable::DrawIndirect(const glm::mat4& modelMatrix) const
     {
-        auto localMatrix = node->GetLocalTransform() * modelMatrix;
-        for (std::size_t i = 0; i < node->GetNumberOfSubMeshes(); ++i) {
-            const auto* submesh = &mesh_->GetSubMeshes()[node->GetSubMeshID(i)];
-            DrawSubMesh(localMatrix, submesh, overrideBump);
+        if (!IsIndirectDrawingAvailable()) {
+            Draw(modelMatrix);
+            return;
         }
-        for (std::size_t i = 0; i < node->GetNumberOfNodes(); ++i) DrawNode(localMatrix, node->GetChild(i), overrideBump);
+
+        UpdateNodeTransforms(modelMatrix);
+        indirectDrawItems_.clear();
+        ForEachVisibleSubMesh(nullptr, [this](std::size_t node, const SubMesh* subMesh) { AddIndirectDrawItem(node, subMesh); });
+        DrawIndirectSubMeshes();
     }
 
-    void MeshRenderable::DrawSubMesh(const glm::mat4& modelMatrix, const SubMesh* subMesh, bool overrideBump) const
+    /**
+     *  Draws all parts of the mesh inside a view frustum with indirect draw calls (see DrawIndirect(const glm::mat4&)).
+     *  @param modelMatrix the model matrix of the mesh.
+     *  @param viewProjection the view projection matrix of the current window (CameraHelper::GetViewPerspectiveMatrix()).
+     */
+    void MeshRenderable::DrawIndirect(const glm::mat4& modelMatrix, const glm::mat4& viewProjection) const
     {
-        glUniformMatrix4fv(uniformLocations_[0], 1, GL_FALSE, glm::value_ptr(modelMatrix));
-        glUniformMatrix3fv(uniformLocations_[1], 1, GL_FALSE, glm::value_ptr(glm::inverseTranspose(glm::mat3(modelMatrix))));
+        if (!IsIndirectDrawingAvailable()) {
+            Draw(modelMatrix, viewProjection);
+            return;
+        }
+
+        UpdateNodeTransforms(modelMatrix);
+        const auto& frusta = GetCullingFrusta(viewProjection);
+        indirectDrawItems_.clear();
+        ForEachVisibleSubMesh(&frusta, [this](std::size_t node, const SubMesh* subMesh) { AddIndirectDrawItem(node, subMesh); });
+        DrawIndirectSubMeshes();
+    }
+
+    /**
+     *  Draws the mesh once for each instance matrix. Each sub-mesh is drawn with a single instanced draw call, so the
+     *  node hierarchy is only traversed once. Falls back to one Draw() per instance if the shader has no instance
+     *  matrix attribute.
+     *  @param instanceMatrices the model matrix of each instance.
+     *  @param overrideBump if true the bump multiplier uniform is not set from the material.
+     */
+    void MeshRenderable::DrawInstanced(const std::vector<glm::mat4>& instanceMatrices, bool overrideBump) const
+    {
+        DrawInstances(instanceMatrices, overrideBump);
+    }
+
+    /**
+     *  Draws all instances of the mesh whose bounding box is inside a view frustum (see DrawInstanced(const std::vector<glm::mat4>&, bool)).
+     *  The instances are culled as a batch on the CPU before uploading.
+     *  @param instanceMatrices the model matrix of each instance.
+     *  @param viewProjection the view projection matrix of the current window (CameraHelper::GetViewPerspectiveMatrix()).
+     *  @param overrideBump if true the bump multiplier uniform is not set from the material.
+     */
+    void MeshRenderable::DrawInstanced(const std::vector<glm::mat4>& instanceMatrices, const glm::mat4& viewProjection, bool overrideBump) const
+    {
+        const auto* rootNode = mesh_->GetRootNode();
+        if (!rootNode->IsBoundingBoxValid()) {
+            DrawInstances(instanceMatrices, overrideBump);
+            return;
+        }
+
+        // the root nodes box is in model space.
+        instanceBoxes_.resize(instanceMatrices.size());
+        for (std::size_t i = 0; i < instanceMatrices.size(); ++i) instanceBoxes_.Set(i, math::transformAABB(GetNodeBoundingBox(0), instanceMatrices[i]));
+        const auto& frusta = GetCullingFrusta(viewProjection);
+        math::CullAABBs(frusta[0], instanceBoxes_, instanceVisibility_);
+        for (std::size_t i = 1; i < frusta.size(); ++i) {
+            math::CullAABBs(frusta[i], instanceBoxes_, instanceLayerVisibility_);
+            for (std::size_t j = 0; j < instanceVisibility_.size(); ++j) instanceVisibility_[j] |= instanceLayerVisibility_[j];
+        }
+
+        visibleInstances_.clear();
+        for (std::size_t i = 0; i < instanceMatrices.size(); ++i) {
+            if (math::IsVisible(instanceVisibility_, i)) visibleInstances_.push_back(instanceMatrices[i]);
+        }
+        statistics_.culledInstances_ += instanceMatrices.size() - visibleInstances_.size();
+        DrawInstances(visibleInstances_, overrideBump);
+    }
+
+    /**
+     *  Adds all sub-meshes of the mesh to a render queue instead of drawing them directly.
+     *  @param queue the render queue.
+     *  @param modelMatrix the model matrix of the mesh.
+     *  @param overrideBump if true the bump multiplier uniform is not set from the material.
+     */
+    void MeshRenderable::Enqueue(RenderQueue& queue, const glm::mat4& modelMatrix, bool overrideBump) const
+    {
+        UpdateNodeTransforms(modelMatrix);
+        ForEachVisibleSubMesh(nullptr, [this, &queue, overrideBump](std::size_t node, const SubMesh* subMesh) {
+            EnqueueSubMesh(queue, node, subMesh, overrideBump);
+        });
+    }
+
+    /**
+     *  Adds all sub-meshes of the mesh inside a view frustum to a render queue.
+     *  @param queue the render queue.
+     *  @param modelMatrix the model matrix of the mesh.
+     *  @param viewProjection the view projection matrix of the current window (CameraHelper::GetViewPerspectiveMatrix()).
+     *  @param overrideBump if true the bump multiplier uniform is not set from the material.
+     */
+    void MeshRenderable::Enqueue(RenderQueue& queue, const glm::mat4& modelMatrix, const glm::mat4& viewProjection, bool overrideBump) const
+    {
+        UpdateNodeTransforms(modelMatrix);
+        const auto& frusta = GetCullingFrusta(viewProjection);
+        ForEachVisibleSubMesh(&frusta, [this, &queue, overrideBump](std::size_t node, const SubMesh* subMesh) {
+            EnqueueSubMesh(queue, node, subMesh, overrideBump);
+        });
+    }
+
+    /**
+     *  Sets the node transformations used for drawing (e.g., from an animation) until the next call or until
+     *  ClearNodeTransforms(). Drawing with a different model matrix keeps the node transformations, DrawInstanced()
+     *  uses them in model space. The bounding boxes for culling are recomputed for the new pose. Call once per frame
+     *  before drawing all windows.
+     *  @param modelMatrix the model matrix of the mesh.
+     *  @param nodeLocalTransforms the local transformation of each node (see Mesh::ComputeNodeLocalTransforms).
+     */
+    void MeshRenderable::SetNodeTransforms(const glm::mat4& modelMatrix, const std::vector<glm::mat4>& nodeLocalTransforms)
+    {
+        customNodeLocalTransforms_ = nodeLocalTransforms;
+        ComputeCustomBoundingBoxes();
+        ComputeNodeTransforms(modelMatrix, customNodeLocalTransforms_, nodeWorldMatrices_, nodeNormalMatrices_);
+        cachedModelMatrix_ = modelMatrix;
+        nodeTransformsValid_ = true;
+        ComputeNodeTransforms(glm::mat4{ 1.0f }, customNodeLocalTransforms_, nodeModelMatrices_, nodeModelNormalMatrices_);
+        nodeModelTransformsValid_ = true;
+    }
+
+    /** Returns to drawing the static pose of the mesh. */
+    void MeshRenderable::ClearNodeTransforms() noexcept
+    {
+        customNodeLocalTransforms_.clear();
+        nodeTransformsValid_ = false;
+        nodeModelTransformsValid_ = false;
+    }
+
+    /**
+     *  Rasterizes the largest sub-meshes (by the surface area of their bounding boxes) into an occlusion buffer.
+     *  Large walls and floors of architectural models hide most of the scene, so a few of them are enough.
+     *  The occluders themselves are not tested against this buffer when drawing.
+     *  @param occlusionBuffer the occlusion buffer, cleared with the view projection matrix of the current window.
+     *  @param modelMatrix the model matrix of the mesh.
+     *  @param maxOccluders the maximum number of sub-meshes to rasterize.
+     */
+    void MeshRenderable::RasterizeOccluders(math::OcclusionBuffer& occlusionBuffer, const glm::mat4& modelMatrix, std::size_t maxOccluders) const
+    {
+        UpdateNodeTransforms(modelMatrix);
+        const auto& nodes = mesh_->GetNodes();
+        const auto& nodeParents = mesh_->GetNodeParents();
+        occluderCandidates_.clear();
+        for (std::size_t n = 0; n < nodes.size(); ++n) {
+            const auto& parentMatrix = nodeParents[n] == std::numeric_limits<std::size_t>::max() ? cachedModelMatrix_ : nodeWorldMatrices_[nodeParents[n]];
+            for (std::size_t i = 0; i < nodes[n]->GetNumberOfSubMeshes(); ++i) {
+                auto size = math::transformAABB(GetSubMeshBoundingBoxes(n)[i], parentMatrix).Size();
+                auto area = size.x * size.y + size.y * size.z + size.z * size.x;
+                occluderCandidates_.emplace_back(area, n, &mesh_->GetSubMeshes()[nodes[n]->GetSubMeshID(i)]);
+            }
+        }
+
+        auto numOccluders = std::min(maxOccluders, occluderCandidates_.size());
+        std::partial_sort(occluderCandidates_.begin(), occluderCandidates_.begin() + numOccluders, occluderCandidates_.end(),
+            [](const auto& left, const auto& right) { return std::get<0>(left) > std::get<0>(right); });
+        occluders_.clear();
+        occludersBuffer_ = &occlusionBuffer;
+        for (std::size_t i = 0; i < numOccluders; ++i) {
+            auto node = std::get<1>(occluderCandidates_[i]);
+            const auto* subMesh = std::get<2>(occluderCandidates_[i]);
+            occlusionBuffer.RasterizeTriangles(nodeWorldMatrices_[node], mesh_->GetVertices(),
+                mesh_->GetIndices().data() + subMesh->GetIndexOffset(), subMesh->GetNumberOfIndices());
+            occluders_.emplace_back(node, subMesh);
+        }
+    }
+
+    /**
+     *  Checks if the occlusion test has to be skipped for a sub-tree or sub-mesh as it contains an occluder of the
+     *  current occlusion buffer.
+     *  @param firstNode the first node of the sub-tree.
+     *  @param endNode the node after the sub-tree.
+     *  @param subMesh the sub-mesh to check (nullptr to check all sub-meshes of the sub-tree).
+     */
+    bool MeshRenderable::ContainsOccluder(std::size_t firstNode, std::size_t endNode, const SubMesh* subMesh) const
+    {
+        if (occlusionBuffer_ != occludersBuffer_) return false;
+        return std::any_of(occluders_.begin(), occluders_.end(), [firstNode, endNode, subMesh](const auto& occluder) {
+            return occluder.first >= firstNode && occluder.first < endNode && (subMesh == nullptr || occluder.second == subMesh);
+        });
+    }
+
+    /** Returns the local transformation of each node: the ones set by SetNodeTransforms() or the static pose. */
+    const std::vector<glm::mat4>& MeshRenderable::GetNodeLocalTransforms() const
+    {
+        return customNodeLocalTransforms_.empty() ? mesh_->GetNodeLocalTransforms() : customNodeLocalTransforms_;
+    }
+
+    /** Returns the bounding box of a node (in the space of its parent) for the current node transformations. */
+    const math::AABB3<float>& MeshRenderable::GetNodeBoundingBox(std::size_t node) const
+    {
+        return customNodeLocalTransforms_.empty() ? mesh_->GetNodes()[node]->GetBoundingBox() : customNodeBoundingBoxes_[node];
+    }
+
+    /** Returns the bounding boxes of the sub-meshes of a node for the current node transformations. */
+    const std::vector<math::AABB3<float>>& MeshRenderable::GetSubMeshBoundingBoxes(std::size_t node) const
+    {
+        return customNodeLocalTransforms_.empty() ? mesh_->GetNodes()[node]->GetSubMeshBoundingBoxes() : customSubMeshBoundingBoxes_[node];
+    }
+
+    /**
+     *  Computes the bounding boxes of the nodes and sub-meshes for the custom node transformations the same way
+     *  SceneMeshNode does for the static pose: the box of a node contains its sub-meshes and the boxes of its children
+     *  and is transformed by its local transformation into the space of its parent.
+     */
+    void MeshRenderable::ComputeCustomBoundingBoxes()
+    {
+        const auto& nodes = mesh_->GetNodes();
+        const auto& nodeParents = mesh_->GetNodeParents();
+        customNodeBoundingBoxes_.assign(nodes.size(), math::AABB3<float>{});
+        customSubMeshBoundingBoxes_.resize(nodes.size());
+        for (std::size_t n = 0; n < nodes.size(); ++n) {
+            auto& subMeshBoxes = customSubMeshBoundingBoxes_[n];
+            subMeshBoxes.clear();
+            for (std::size_t i = 0; i < nodes[n]->GetNumberOfSubMeshes(); ++i) {
+                const auto& subMeshBox = mesh_->GetSubMeshes()[nodes[n]->GetSubMeshID(i)].GetLocalAABB();
+                subMeshBoxes.push_back(math::transformAABB(subMeshBox, customNodeLocalTransforms_[n]));
+                customNodeBoundingBoxes_[n] = customNodeBoundingBoxes_[n].Union(subMeshBox);
+            }
+        }
+
+        // nodes are in pre-order, so all children are done before their parent.
+        for (auto n = nodes.size(); n-- > 0;) {
+            customNodeBoundingBoxes_[n] = math::transformAABB(customNodeBoundingBoxes_[n], customNodeLocalTransforms_[n]);
+            if (nodeParents[n] != std::numeric_limits<std::size_t>::max()) {
+                customNodeBoundingBoxes_[nodeParents[n]] = customNodeBoundingBoxes_[nodeParents[n]].Union(customNodeBoundingBoxes_[n]);
+            }
+        }
+    }
+
+    /** Computes the node transformations (custom or static pose) if the model matrix changed. */
+    void MeshRenderable::UpdateNodeTransforms(const glm::mat4& modelMatrix) const
+    {
+        if (nodeTransformsValid_ && cachedModelMatrix_ == modelMatrix) return;
+        ComputeNodeTransforms(modelMatrix, GetNodeLocalTransforms(), nodeWorldMatrices_, nodeNormalMatrices_);
+        cachedModelMatrix_ = modelMatrix;
+        nodeTransformsValid_ = true;
+    }
+
+    /** Computes the model space node transformations for instancing (custom or static pose) if not valid. */
+    void MeshRenderable::UpdateNodeModelTransforms() const
+    {
+        if (nodeModelTransformsValid_) return;
+        ComputeNodeTransforms(glm::mat4{ 1.0f }, GetNodeLocalTransforms(), nodeModelMatrices_, nodeModelNormalMatrices_);
+        nodeModelTransformsValid_ = true;
+    }
+
+    void MeshRenderable::ComputeNodeTransforms(const glm::mat4& modelMatrix, const std::vector<glm::mat4>& nodeLocalTransforms,
+        std::vector<glm::mat4>& worldMatrices, std::vector<glm::mat3>& normalMatrices) const
+    {
+        mesh_->ComputeNodeWorldTransforms(modelMatrix, nodeLocalTransforms, worldMatrices);
+        for (std::size_t i = 0; i < worldMatrices.size(); ++i) normalMatrices[i] = glm::inverseTranspose(glm::mat3(worldMatrices[i]));
+    }
+
+    /**
+     *  Returns the view frusta to cull against: the frustum of the view projection matrix or, with layered rendering,
+     *  the frusta of all layers.
+     *  @param viewProjection the view projection matrix of the current window.
+     */
+    const std::vector<math::Frustum<float>>& MeshRenderable::GetCullingFrusta(const glm::mat4& viewProjection) const
+    {
+        cullingFrusta_.clear();
+        auto numLayers = StandardUniforms::GetNumRenderLayers();
+        if (numLayers > 1) {
+            const auto& perLayer = StandardUniforms::GetPerLayer();
+            for (GLuint i = 0; i < numLayers; ++i) cullingFrusta_.push_back(math::extractFrustum(perLayer.viewProjectionMatrices_[i]));
+        }
+        else cullingFrusta_.push_back(math::extractFrustum(viewProjection));
+        return cullingFrusta_;
+    }
+
+    void MeshRenderable::ForEachVisibleSubMesh(const std::vector<math::Frustum<float>>* frusta, function_view<void(std::size_t, const SubMesh*)> fn) const
+    {
+        const auto& nodes = mesh_->GetNodes();
+        const auto& nodeParents = mesh_->GetNodeParents();
+        for (std::size_t n = 0; n < nodes.size();) {
+            const auto* node = nodes[n];
+            // the nodes boxes are in the space of its parent.
+            const auto& parentMatrix = nodeParents[n] == std::numeric_limits<std::size_t>::max() ? cachedModelMatrix_ : nodeWorldMatrices_[nodeParents[n]];
+            if (frusta && !node->IsBoundingBoxValid()) {
+                statistics_.culledSubMeshes_ += subTreeSubMeshCounts_[n];
+                n = subTreeEnds_[n];
+                continue;
+            }
+            if (frusta && !IsBoxVisible(*frusta, GetNodeBoundingBox(n), parentMatrix, subTreeSubMeshCounts_[n],
+                !ContainsOccluder(n, subTreeEnds_[n], nullptr))) {
+                n = subTreeEnds_[n];
+                continue;
+            }
+
+            for (std::size_t i = 0; i < node->GetNumberOfSubMeshes(); ++i) {
+                const auto* subMesh = &mesh_->GetSubMeshes()[node->GetSubMeshID(i)];
+                if (frusta && node->GetNumberOfSubMeshes() > 1
+                    && !IsBoxVisible(*frusta, GetSubMeshBoundingBoxes(n)[i], parentMatrix, 1, !ContainsOccluder(n, n + 1, subMesh))) continue;
+
+                fn(n, subMesh);
+                statistics_.drawnSubMeshes_ += 1;
+            }
+            ++n;
+        }
+    }
+
+    /**
+     *  Tests a bounding box against the view frusta and the occlusion buffer (if set and only a single frustum is
+     *  used) and counts the sub-meshes skipped if it is not visible.
+     *  @param frusta the view frusta, the box is visible if it is inside any of them.
+     *  @param box the bounding box in the space of the parent node.
+     *  @param parentMatrix the world matrix of the parent node.
+     *  @param numSubMeshes the number of sub-meshes inside the box.
+     *  @param testOcclusion if false only the view frustum is tested (e.g., for boxes containing occluders).
+     */
+    bool MeshRenderable::IsBoxVisible(const std::vector<math::Frustum<float>>& frusta, const math::AABB3<float>& box, const glm::mat4& parentMatrix,
+        std::size_t numSubMeshes, bool testOcclusion) const
+    {
+        auto worldBox = math::transformAABB(box, parentMatrix);
+        if (std::none_of(frusta.begin(), frusta.end(), [&worldBox](const auto& frustum) { return math::AABBInFrustumTest(frustum, worldBox); })) {
+            statistics_.culledSubMeshes_ += numSubMeshes;
+            return false;
+        }
+        if (testOcclusion && frusta.size() == 1 && occlusionBuffer_ && !occlusionBuffer_->IsVisible(worldBox)) {
+            statistics_.occludedSubMeshes_ += numSubMeshes;
+            return false;
+        }
+        return true;
+    }
+
+    void MeshRenderable::EnqueueSubMesh(RenderQueue& queue, std::size_t node, const SubMesh* subMesh, bool overrideBump) const
+    {
+        auto matTex = mesh_->GetMaterialTexture(subMesh->GetMaterialIndex());
+        RenderQueueItem item;
+        item.program_ = drawProgram_->getProgramId();
+        item.vao_ = vao_;
+        item.instanceMatrixLocation_ = instanceMatrixLocation_;
+        item.drawIndexLocation_ = drawIndexLocation_;
+        item.uniformLocations_ = &uniformLocations_;
+        item.usesPerDrawBlock_ = usesPerDrawBlock_;
+        item.diffuseTexture_ = matTex->diffuseTex ? matTex->diffuseTex->getTextureId() : 0;
+        item.bumpTexture_ = matTex->bumpTex ? matTex->bumpTex->getTextureId() : 0;
+        item.material_ = mesh_->GetMaterial(subMesh->GetMaterialIndex());
+        item.overrideBump_ = overrideBump;
+        item.modelMatrix_ = nodeWorldMatrices_[node];
+        item.normalMatrix_ = nodeNormalMatrices_[node];
+        item.numIndices_ = subMesh->GetNumberOfIndices();
+        item.indexOffset_ = subMesh->GetIndexOffset();
+        queue.Push(item);
+    }
+
+    void MeshRenderable::DrawSubMesh(const glm::mat4& modelMatrix, const glm::mat3& normalMatrix, const SubMesh* subMesh, bool overrideBump, GLsizei numInstances) const
+    {
+        if (usesPerDrawBlock_) StandardUniforms::SetPerDraw(modelMatrix, normalMatrix);
+        else {
+            glUniformMatrix4fv(uniformLocations_[0], 1, GL_FALSE, glm::value_ptr(modelMatrix));
+            glUniformMatrix3fv(uniformLocations_[1], 1, GL_FALSE, glm::value_ptr(normalMatrix));
+        }
 
         auto mat = mesh_->GetMaterial(subMesh->GetMaterialIndex());
         auto matTex = mesh_->GetMaterialTexture(subMesh->GetMaterialIndex());
         if (matTex->diffuseTex && uniformLocations_.size() > 2) {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, matTex->diffuseTex->getTextureId());
+            GLStateCache::BindTexture(0, GL_TEXTURE_2D, matTex->diffuseTex->getTextureId());
             glUniform1i(uniformLocations_[2], 0);
         }
         if (matTex->bumpTex && uniformLocations_.size() > 3) {
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, matTex->bumpTex->getTextureId());
+            GLStateCache::BindTexture(1, GL_TEXTURE_2D, matTex->bumpTex->getTextureId());
             glUniform1i(uniformLocations_[3], 1);
             if (!overrideBump) glUniform1f(uniformLocations_[4], mat->bumpMultiplier);
         }
 
-        glDrawElements(GL_TRIANGLES, subMesh->GetNumberOfIndices(), GL_UNSIGNED_INT,
-            (static_cast<char*> (nullptr)) + (static_cast<std::size_t>(subMesh->GetIndexOffset()) * sizeof(unsigned int)));
+        // each instance is drawn once for each layer.
+        glDrawElementsInstanced(GL_TRIANGLES, subMesh->GetNumberOfIndices(), GL_UNSIGNED_INT,
+            (static_cast<char*> (nullptr)) + (static_cast<std::size_t>(subMesh->GetIndexOffset()) * sizeof(unsigned int)),
+            numInstances * static_cast<GLsizei>(StandardUniforms::GetNumRenderLayers()));
+        statistics_.drawCalls_ += 1;
+    }
+
+    /** Creates the buffers for indirect drawing, sized for all sub-mesh references of the mesh. */
+    void MeshRenderable::CreateIndirectBuffers()
+    {
+        std::size_t numDraws = 0;
+        for (const auto* node : mesh_->GetNodes()) numDraws += node->GetNumberOfSubMeshes();
+
+        std::vector<std::uint32_t> drawIndices(numDraws);
+        std::iota(drawIndices.begin(), drawIndices.end(), 0U);
+        glGenBuffers(1, &drawIndexBuffer_);
+        glBindBuffer(GL_ARRAY_BUFFER, drawIndexBuffer_);
+        glBufferData(GL_ARRAY_BUFFER, drawIndices.size() * sizeof(std::uint32_t), drawIndices.data(), GL_STATIC_DRAW);
+
+        glGenBuffers(1, &indirectBuffer_);
+        GLStateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer_);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, numDraws * sizeof(DrawElementsIndirectCommand), nullptr, GL_STREAM_DRAW);
+
+        glGenBuffers(1, &drawDataBuffer_);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawDataBuffer_);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, numDraws * sizeof(IndirectDrawData), nullptr, GL_STREAM_DRAW);
+
+        std::vector<IndirectMaterialData> materials(mesh_->GetNumberOfMaterials());
+        for (std::size_t i = 0; i < materials.size(); ++i) {
+            const auto* mat = mesh_->GetMaterial(i);
+            materials[i].ambientAlpha_ = glm::vec4(mat->ambient, mat->alpha);
+            materials[i].diffuseSpecularExponent_ = glm::vec4(mat->diffuse, mat->specularExponent);
+            materials[i].specularRefraction_ = glm::vec4(mat->specular, mat->refraction);
+            materials[i].bumpMultiplier_ = mat->bumpMultiplier;
+        }
+        glGenBuffers(1, &materialBuffer_);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, materialBuffer_);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, materials.size() * sizeof(IndirectMaterialData), materials.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        indirectCommands_.reserve(numDraws);
+        indirectDrawData_.reserve(numDraws);
+        indirectDrawItems_.reserve(numDraws);
+    }
+
+    /**
+     *  Sets the instance matrix attribute to the identity matrix for draws that do not use instancing. The value is
+     *  not part of the vertex array object, so it needs to be set before drawing.
+     *  @param instanceMatrixLocation the location of the instance matrix attribute (-1 if not used).
+     */
+    void MeshRenderable::SetIdentityInstanceMatrix(GLint instanceMatrixLocation)
+    {
+        if (instanceMatrixLocation < 0) return;
+        for (GLuint i = 0; i < 4; ++i) {
+            glVertexAttrib4f(instanceMatrixLocation + i, i == 0 ? 1.0f : 0.0f, i == 1 ? 1.0f : 0.0f, i == 2 ? 1.0f : 0.0f, i == 3 ? 1.0f : 0.0f);
+        }
+    }
+
+    /**
+     *  Sets the divisor of per instance attributes in the currently bound vertex array object to the number of
+     *  layers, so all layers of an instance read the same value.
+     *  @param location the location of the attribute (-1 if not used).
+     *  @param numLocations the number of locations of the attribute (4 for a mat4).
+     */
+    void MeshRenderable::SetLayerDivisor(GLint location, GLuint numLocations)
+    {
+        if (location < 0) return;
+        for (GLuint i = 0; i < numLocations; ++i) glVertexAttribDivisor(location + i, StandardUniforms::GetNumRenderLayers());
+    }
+
+    /** Adds the per instance draw index attribute to the currently bound vertex array object. */
+    void MeshRenderable::SetDrawIndexAttribute(const GPUProgram* program)
+    {
+        drawIndexLocation_ = indirectBuffer_ != 0 ? program->getAttributeLocation("drawIndex") : -1;
+        if (drawIndexLocation_ >= 0) {
+            // the base instance of each command selects the draw index, this works without ARB_shader_draw_parameters.
+            glBindBuffer(GL_ARRAY_BUFFER, drawIndexBuffer_);
+            glEnableVertexAttribArray(drawIndexLocation_);
+            glVertexAttribIPointer(drawIndexLocation_, 1, GL_UNSIGNED_INT, sizeof(std::uint32_t), nullptr);
+            glVertexAttribDivisor(drawIndexLocation_, 1);
+        }
+    }
+
+    /** Enables the per instance matrix attribute in the currently bound vertex array object, the pointers are set by DrawInstances(). */
+    void MeshRenderable::EnableInstanceMatrixAttribute() const
+    {
+        for (GLuint i = 0; i < 4; ++i) {
+            glEnableVertexAttribArray(instanceMatrixLocation_ + i);
+            glVertexAttribDivisor(instanceMatrixLocation_ + i, 1);
+        }
+    }
+
+    void MeshRenderable::DrawInstances(const std::vector<glm::mat4>& instanceMatrices, bool overrideBump) const
+    {
+        if (instanceMatrices.empty()) return;
+        if (instanceMatrixLocation_ < 0) {
+            for (const auto& instanceMatrix : instanceMatrices) Draw(instanceMatrix, overrideBump);
+            statistics_.drawnInstances_ += instanceMatrices.size();
+            return;
+        }
+
+        // the instance matrix is applied in the shader, so the nodes are transformed into model space only.
+        UpdateNodeModelTransforms();
+        auto& stream = StandardUniforms::GetStreamingBuffer();
+        auto offset = stream.Upload(instanceMatrices.data(), instanceMatrices.size() * sizeof(glm::mat4), sizeof(glm::vec4));
+
+        GLStateCache::Invalidate();
+        GLStateCache::UseProgram(drawProgram_->getProgramId());
+        GLStateCache::BindVertexArray(instanceVao_);
+        SetLayerDivisor(instanceMatrixLocation_, 4);
+        glBindBuffer(GL_ARRAY_BUFFER, stream.GetBuffer());
+        for (GLuint i = 0; i < 4; ++i) {
+            glVertexAttribPointer(instanceMatrixLocation_ + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                (static_cast<char*> (nullptr)) + (offset + i * sizeof(glm::vec4)));
+        }
+        auto numInstances = static_cast<GLsizei>(instanceMatrices.size());
+        ForEachVisibleSubMesh(nullptr, [this, overrideBump, numInstances](std::size_t node, const SubMesh* subMesh) {
+            DrawSubMesh(nodeModelMatrices_[node], nodeModelNormalMatrices_[node], subMesh, overrideBump, numInstances);
+        });
+        GLStateCache::BindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        statistics_.drawnInstances_ += instanceMatrices.size();
+    }
+
+    void MeshRenderable::AddIndirectDrawItem(std::size_t node, const SubMesh* subMesh) const
+    {
+        indirectDrawItems_.push_back(IndirectDrawItem{ node, subMesh->GetNumberOfIndices(), subMesh->GetIndexOffset(),
+            static_cast<std::uint32_t>(subMesh->GetMaterialIndex()), GetSubMeshTextures(mesh_, subMesh) });
+    }
+
+    void MeshRenderable::DrawIndirectSubMeshes() const
+    {
+        if (indirectDrawItems_.empty()) return;
+
+        // textures cannot change inside a multi draw, so draws with equal textures are grouped together.
+        SortIndirectDrawItems(indirectDrawItems_);
+        BuildIndirectDrawCommands(indirectDrawItems_, nodeWorldMatrices_, nodeNormalMatrices_, StandardUniforms::GetNumRenderLayers(),
+            indirectCommands_, indirectDrawData_);
+
+        GLStateCache::Invalidate();
+        GLStateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer_);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, indirectCommands_.size() * sizeof(DrawElementsIndirectCommand), indirectCommands_.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, drawDataBuffer_);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, indirectDrawData_.size() * sizeof(IndirectDrawData), indirectDrawData_.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, drawDataBuffer_);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MATERIAL_DATA_BINDING, materialBuffer_);
+
+        GLStateCache::UseProgram(drawProgram_->getProgramId());
+        GLStateCache::BindVertexArray(vao_);
+        SetIdentityInstanceMatrix(instanceMatrixLocation_);
+        SetLayerDivisor(drawIndexLocation_, 1);
+        if (uniformLocations_.size() > 2) glUniform1i(uniformLocations_[2], 0);
+        if (uniformLocations_.size() > 3) glUniform1i(uniformLocations_[3], 1);
+
+        for (std::size_t first = 0; first < indirectDrawItems_.size();) {
+            auto textures = indirectDrawItems_[first].textures_;
+            auto last = first + 1;
+            while (last < indirectDrawItems_.size() && indirectDrawItems_[last].textures_ == textures) ++last;
+
+            if (textures.first != 0 && uniformLocations_.size() > 2) {
+                GLStateCache::BindTexture(0, GL_TEXTURE_2D, textures.first);
+            }
+            if (textures.second != 0 && uniformLocations_.size() > 3) {
+                GLStateCache::BindTexture(1, GL_TEXTURE_2D, textures.second);
+            }
+
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (static_cast<char*> (nullptr)) + (first * sizeof(DrawElementsIndirectCommand)),
+                static_cast<GLsizei>(last - first), 0);
+            statistics_.drawCalls_ += 1;
+            first = last;
+        }
+        GLStateCache::BindVertexArray(0);
+        GLStateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
     }
 }
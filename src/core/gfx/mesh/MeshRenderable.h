@@ -10,11 +10,36 @@
 
 #include "core/main.h"
 #include "Mesh.h"
+#include "IndirectDraw.h"
+#include "core/gfx/GLStateCache.h"
 #include "core/gfx/GPUProgram.h"
+#include "core/gfx/UniformBuffers.h"
+#include "core/math/FrustumCulling.h"
+#include "core/math/OcclusionCulling.h"
+#include "core/utils/function_view.h"
+#include <tuple>
 
 namespace viscom {
 
     class Mesh;
+    class RenderQueue;
+
+    /** Statistics of the draw calls of a MeshRenderable. */
+    struct MeshRenderStatistics
+    {
+        /** The number of sub-meshes drawn. */
+        std::size_t drawnSubMeshes_ = 0;
+        /** The number of sub-meshes skipped by frustum culling. */
+        std::size_t culledSubMeshes_ = 0;
+        /** The number of sub-meshes skipped by occlusion culling. */
+        std::size_t occludedSubMeshes_ = 0;
+        /** The number of draw calls issued. */
+        std::size_t drawCalls_ = 0;
+        /** The number of instances drawn by DrawInstanced(). */
+        std::size_t drawnInstances_ = 0;
+        /** The number of instances skipped by frustum culling in DrawInstanced(). */
+        std::size_t culledInstances_ = 0;
+    };
 
     /**
      *  This class renders a mesh with a specific shader. The shader is assumed to have fixed uniform names:
@@ -26,7 +51,32 @@ namespace viscom {
      *
      *  NOT ALL UNIFORM LOCATIONS NEED TO BE USED!
      *
+     *  If the shader declares the PerDrawUniforms block (see StandardUniforms) the model and normal matrices are
+     *  written to the per-draw uniform buffer ring instead of the matrix uniforms.
+     *
      *  The attribute names are determined by the vertex structure.
+     *
+     *  For DrawIndirect() the shader reads the per-draw data from shader storage buffers instead of the
+     *  matrix uniforms (std430 layout, see DRAW_DATA_BINDING and MATERIAL_DATA_BINDING):
+     *  struct DrawData { mat4 modelMatrix; mat4 normalMatrix; uint materialIndex; };
+     *  struct MaterialData { vec4 ambientAlpha; vec4 diffuseSpecularExponent; vec4 specularRefraction; float bumpMultiplier; };
+     *  The index into the DrawData array is passed as the instanced vertex attribute "drawIndex" (uint).
+     *
+     *  For DrawInstanced() the transformation of each instance is passed as the instanced vertex attribute
+     *  "instanceMatrix" (mat4) and the vertex position is instanceMatrix * modelMatrix * position. The normal
+     *  matrix uniform does not include the instance transformation. Instanced draws use their own vertex array
+     *  object, all other draws set the attribute to the identity matrix.
+     *
+     *  If an occlusion buffer is set, the methods culling against a view projection matrix also skip nodes and
+     *  sub-meshes whose bounding boxes are hidden in it. The buffer has to be cleared with the same view projection
+     *  matrix and filled (e.g., by RasterizeOccluders()) before drawing. Sub-meshes rasterized as occluders into the
+     *  buffer are not tested against it.
+     *
+     *  With layered rendering (see StandardUniforms::GetNumRenderLayers()) every draw is instanced once per layer
+     *  and the per instance attributes use the number of layers as divisor. The shader selects the layer with
+     *  resources/shader/layeredRendering.glsl, the instance index is gl_InstanceID / numLayers. The methods culling
+     *  against a view projection matrix then ignore it and keep everything inside the frustum of any layer (see
+     *  StandardUniforms::GetPerLayer()). The occlusion buffer only covers a single view, so it is not used.
      */
     class MeshRenderable
     {
@@ -40,13 +90,43 @@ namespace viscom {
         MeshRenderable& operator=(MeshRenderable&&) noexcept;
 
         void Draw(const glm::mat4& modelMatrix, bool overrideBump = false) const;
+        void Draw(const glm::mat4& modelMatrix, const glm::mat4& viewProjection, bool overrideBump = false) const;
+
+        void DrawIndirect(const glm::mat4& modelMatrix) const;
+        void DrawIndirect(const glm::mat4& modelMatrix, const glm::mat4& viewProjection) const;
+        bool IsIndirectDrawingAvailable() const noexcept { return drawIndexLocation_ >= 0 && indirectBuffer_ != 0; }
+
+        void DrawInstanced(const std::vector<glm::mat4>& instanceMatrices, bool overrideBump = false) const;
+        void DrawInstanced(const std::vector<glm::mat4>& instanceMatrices, const glm::mat4& viewProjection, bool overrideBump = false) const;
+
+        void Enqueue(RenderQueue& queue, const glm::mat4& modelMatrix, bool overrideBump = false) const;
+        void Enqueue(RenderQueue& queue, const glm::mat4& modelMatrix, const glm::mat4& viewProjection, bool overrideBump = false) const;
+
+        void SetNodeTransforms(const glm::mat4& modelMatrix, const std::vector<glm::mat4>& nodeLocalTransforms);
+        void ClearNodeTransforms() noexcept;
+
+        void RasterizeOccluders(math::OcclusionBuffer& occlusionBuffer, const glm::mat4& modelMatrix, std::size_t maxOccluders = 8) const;
+        /** Sets the occlusion buffer to test against (nullptr to disable occlusion culling). */
+        void SetOcclusionBuffer(const math::OcclusionBuffer* occlusionBuffer) noexcept { occlusionBuffer_ = occlusionBuffer; }
+
+        /** Returns the statistics accumulated since the last call to ResetStatistics() (e.g., once per frame). */
+        const MeshRenderStatistics& GetStatistics() const noexcept { return statistics_; }
+        void ResetStatistics() noexcept { statistics_ = MeshRenderStatistics{}; }
 
         template<class VTX> void NotifyRecompiledShader(const GPUProgram* program);
 
+        static void SetIdentityInstanceMatrix(GLint instanceMatrixLocation);
+        static void SetLayerDivisor(GLint location, GLuint numLocations);
+
+        /** The shader storage buffer binding of the per-draw data used by DrawIndirect(). */
+        static constexpr GLuint DRAW_DATA_BINDING = 0;
+        /** The shader storage buffer binding of the material data used by DrawIndirect(). */
+        static constexpr GLuint MATERIAL_DATA_BINDING = 1;
+
     protected:
         MeshRenderable(const Mesh* renderMesh, GLuint vBuffer, GPUProgram* program);
 
-        void DrawNode(const glm::mat4& modelMatrix, const SceneMeshNode* node, bool overrideBump = false) const;
+        void ForEachVisibleSubMesh(const std::vector<math::Frustum<float>>* frusta, function_view<void(std::size_t, const SubMesh*)> fn) const;
 
     private:
         /** Holds the mesh to render. */
@@ -59,8 +139,96 @@ namespace viscom {
         GPUProgram* drawProgram_;
         /** Holds the standard uniform bindings. */
         std::vector<GLint> uniformLocations_;
+        /** Flag if the shader reads the matrices from the per-draw uniform block. */
+        bool usesPerDrawBlock_ = false;
+        /** Holds the number of sub-meshes in the sub-tree of each node (for the culling statistics). */
+        std::vector<std::size_t> subTreeSubMeshCounts_;
+        /** Holds the index after the last node in the sub-tree of each node (nodes are in pre-order). */
+        std::vector<std::size_t> subTreeEnds_;
+        /** Holds the model matrix the node transformations were computed for. */
+        mutable glm::mat4 cachedModelMatrix_ = glm::mat4{ 1.0f };
+        /** Flag if the cached node transformations are valid. */
+        mutable bool nodeTransformsValid_ = false;
+        /** Holds the world matrix of each node. */
+        mutable std::vector<glm::mat4> nodeWorldMatrices_;
+        /** Holds the normal matrix of each node. */
+        mutable std::vector<glm::mat3> nodeNormalMatrices_;
+        /** Flag if the cached model space node transformations (for instancing) are valid. */
+        mutable bool nodeModelTransformsValid_ = false;
+        /** Holds the model space matrix of each node (the instance matrix is applied in the shader). */
+        mutable std::vector<glm::mat4> nodeModelMatrices_;
+        /** Holds the model space normal matrix of each node. */
+        mutable std::vector<glm::mat3> nodeModelNormalMatrices_;
+        /** Holds the local transformation of each node set by SetNodeTransforms() (empty for the static pose). */
+        std::vector<glm::mat4> customNodeLocalTransforms_;
+        /** Holds the bounding box of each node (in the space of its parent) for the custom node transformations. */
+        std::vector<math::AABB3<float>> customNodeBoundingBoxes_;
+        /** Holds the bounding boxes of the sub-meshes of each node for the custom node transformations. */
+        std::vector<std::vector<math::AABB3<float>>> customSubMeshBoundingBoxes_;
+        /** Holds the draw statistics. */
+        mutable MeshRenderStatistics statistics_;
+
+        /** Holds the location of the draw index attribute (-1 if the shader does not support indirect drawing). */
+        GLint drawIndexLocation_ = -1;
+        /** Holds the buffer with the draw indices (0 to the number of sub-mesh references, one per instance). */
+        GLuint drawIndexBuffer_ = 0;
+        /** Holds the indirect draw command buffer. */
+        GLuint indirectBuffer_ = 0;
+        /** Holds the shader storage buffer for the per-draw data. */
+        GLuint drawDataBuffer_ = 0;
+        /** Holds the shader storage buffer for the materials. */
+        GLuint materialBuffer_ = 0;
+        /** Holds the indirect draw commands of the current frame. */
+        mutable std::vector<DrawElementsIndirectCommand> indirectCommands_;
+        /** Holds the per-draw data of the current frame. */
+        mutable std::vector<IndirectDrawData> indirectDrawData_;
+        /** Holds the visible sub-meshes of the current frame to sort them by textures. */
+        mutable std::vector<IndirectDrawItem> indirectDrawItems_;
+
+        /** Holds the location of the instance matrix attribute (-1 if the shader does not support instancing). */
+        GLint instanceMatrixLocation_ = -1;
+        /** Holds the vertex array object for instanced draws (the instance matrix attribute is only enabled here). */
+        GLuint instanceVao_ = 0;
+        /** Holds the bounding boxes of the instances for culling. */
+        mutable math::AABB3ArraySoA instanceBoxes_;
+        /** Holds the visibility bitmask of the instances. */
+        mutable std::vector<std::uint32_t> instanceVisibility_;
+        /** Holds the visibility bitmask of the instances in a single layer (combined into instanceVisibility_). */
+        mutable std::vector<std::uint32_t> instanceLayerVisibility_;
+        /** Holds the view frusta of the current draw (one per layer). */
+        mutable std::vector<math::Frustum<float>> cullingFrusta_;
+        /** Holds the matrices of the visible instances. */
+        mutable std::vector<glm::mat4> visibleInstances_;
 
-        void DrawSubMesh(const glm::mat4& modelMatrix, const SubMesh* subMesh, bool overrideBump = false) const;
+        /** Holds the occlusion buffer to test against (optional). */
+        const math::OcclusionBuffer* occlusionBuffer_ = nullptr;
+        /** Holds the sub-meshes with their node and bounding box surface area to select the occluders. */
+        mutable std::vector<std::tuple<float, std::size_t, const SubMesh*>> occluderCandidates_;
+        /** Holds the sub-meshes (with their node) rasterized by the last call to RasterizeOccluders(). */
+        mutable std::vector<std::pair<std::size_t, const SubMesh*>> occluders_;
+        /** Holds the occlusion buffer the occluders were rasterized into. */
+        mutable const math::OcclusionBuffer* occludersBuffer_ = nullptr;
+
+        const std::vector<glm::mat4>& GetNodeLocalTransforms() const;
+        const math::AABB3<float>& GetNodeBoundingBox(std::size_t node) const;
+        const std::vector<math::AABB3<float>>& GetSubMeshBoundingBoxes(std::size_t node) const;
+        void ComputeCustomBoundingBoxes();
+        void UpdateNodeTransforms(const glm::mat4& modelMatrix) const;
+        void UpdateNodeModelTransforms() const;
+        void ComputeNodeTransforms(const glm::mat4& modelMatrix, const std::vector<glm::mat4>& nodeLocalTransforms,
+            std::vector<glm::mat4>& worldMatrices, std::vector<glm::mat3>& normalMatrices) const;
+        bool ContainsOccluder(std::size_t firstNode, std::size_t endNode, const SubMesh* subMesh) const;
+        const std::vector<math::Frustum<float>>& GetCullingFrusta(const glm::mat4& viewProjection) const;
+        bool IsBoxVisible(const std::vector<math::Frustum<float>>& frusta, const math::AABB3<float>& box, const glm::mat4& parentMatrix,
+            std::size_t numSubMeshes, bool testOcclusion) const;
+        void EnqueueSubMesh(RenderQueue& queue, std::size_t node, const SubMesh* subMesh, bool overrideBump) const;
+        void DrawSubMesh(const glm::mat4& modelMatrix, const glm::mat3& normalMatrix, const SubMesh* subMesh, bool overrideBump = false, GLsizei numInstances = 1) const;
+        void CreateIndirectBuffers();
+        void SetDrawIndexAttribute(const GPUProgram* program);
+        void EnableInstanceMatrixAttribute() const;
+        void DrawInstances(const std::vector<glm::mat4>& instanceMatrices, bool overrideBump) const;
+        void AddIndirectDrawItem(std::size_t node, const SubMesh* subMesh) const;
+        void DrawIndirectSubMeshes() const;
     };
 
     template <class VTX>
@@ -74,14 +242,30 @@ namespace viscom {
     template<class VTX> void MeshRenderable::NotifyRecompiledShader(const GPUProgram* program)
     {
         glGenVertexArrays(1, &vao_);
-        glBindVertexArray(vao_);
+        GLStateCache::BindVertexArray(vao_);
         glBindBuffer(GL_ARRAY_BUFFER, vbo_);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh_->GetIndexBuffer());
         VTX::SetVertexAttributes(program);
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        SetDrawIndexAttribute(program);
+
+        if (instanceVao_ != 0) {
+            glDeleteVertexArrays(1, &instanceVao_);
+            // the name can be reused by the new vertex array object.
+            GLStateCache::Invalidate();
+        }
+        instanceVao_ = 0;
+        instanceMatrixLocation_ = program->getAttributeLocation("instanceMatrix");
+        if (instanceMatrixLocation_ >= 0) {
+            glGenVertexArrays(1, &instanceVao_);
+            GLStateCache::BindVertexArray(instanceVao_);
+            glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh_->GetIndexBuffer());
+            VTX::SetVertexAttributes(program);
+            EnableInstanceMatrixAttribute();
+        }
+        GLStateCache::BindVertexArray(0);
 
         uniformLocations_ = program->GetUniformLocations({ "modelMatrix", "normalMatrix", "diffuseTexture", "bumpTexture", "bumpMultiplier" });
+        usesPerDrawBlock_ = program->HasUniformBlock(StandardUniforms::PER_DRAW_UNIFORM_BLOCK);
     }
 }
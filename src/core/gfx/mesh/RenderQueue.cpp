@@ -0,0 +1,118 @@
+/**
+ * @file   RenderQueue.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of a render queue that sorts sub-mesh draws by state.
+ */
+
+#include "RenderQueue.h"
+#include "MeshRenderable.h"
+#include "core/gfx/GLStateCache.h"
+#include "core/gfx/Material.h"
+#include "core/gfx/UniformBuffers.h"
+#include "core/open_gl.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace viscom {
+
+    /** Draws all queued items sorted by state and clears the queue. */
+    void RenderQueue::Flush()
+    {
+        statistics_ = RenderQueueStatistics{};
+        if (items_.empty()) return;
+
+        order_.resize(items_.size());
+        std::iota(order_.begin(), order_.end(), 0U);
+        std::sort(order_.begin(), order_.end(), [this](std::uint32_t left, std::uint32_t right) {
+            const auto& l = items_[left];
+            const auto& r = items_[right];
+            return std::tie(l.program_, l.vao_, l.diffuseTexture_, l.bumpTexture_, l.material_)
+                < std::tie(r.program_, r.vao_, r.diffuseTexture_, r.bumpTexture_, r.material_);
+        });
+
+        // the application may have changed the state with direct OpenGL calls since the last framework draw.
+        GLStateCache::Invalidate();
+        GLuint currentProgram = 0, currentVAO = 0, currentDiffuse = 0, currentBump = 0;
+        auto currentBumpMultiplier = std::numeric_limits<float>::quiet_NaN();
+        auto numLayers = static_cast<GLsizei>(StandardUniforms::GetNumRenderLayers());
+        for (auto index : order_) {
+            const auto& item = items_[index];
+            const auto& uniformLocations = *item.uniformLocations_;
+
+            if (item.program_ != currentProgram) {
+                GLStateCache::UseProgram(item.program_);
+                currentProgram = item.program_;
+                currentBumpMultiplier = std::numeric_limits<float>::quiet_NaN();
+                // texture units are fixed, so samplers only need to be set once per program.
+                if (uniformLocations.size() > 2) {
+                    glUniform1i(uniformLocations[2], 0);
+                    statistics_.uniformUpdates_ += 1;
+                }
+                if (uniformLocations.size() > 3) {
+                    glUniform1i(uniformLocations[3], 1);
+                    statistics_.uniformUpdates_ += 1;
+                }
+                statistics_.programChanges_ += 1;
+            }
+            else statistics_.skippedBinds_ += 1;
+
+            if (item.vao_ != currentVAO) {
+                GLStateCache::BindVertexArray(item.vao_);
+                MeshRenderable::SetIdentityInstanceMatrix(item.instanceMatrixLocation_);
+                MeshRenderable::SetLayerDivisor(item.drawIndexLocation_, 1);
+                currentVAO = item.vao_;
+                statistics_.vertexArrayChanges_ += 1;
+            }
+            else statistics_.skippedBinds_ += 1;
+
+            if (item.diffuseTexture_ != 0 && uniformLocations.size() > 2) {
+                if (item.diffuseTexture_ != currentDiffuse) {
+                    GLStateCache::BindTexture(0, GL_TEXTURE_2D, item.diffuseTexture_);
+                    currentDiffuse = item.diffuseTexture_;
+                    statistics_.textureBinds_ += 1;
+                }
+                else statistics_.skippedBinds_ += 1;
+            }
+
+            if (item.bumpTexture_ != 0 && uniformLocations.size() > 3) {
+                if (item.bumpTexture_ != currentBump) {
+                    GLStateCache::BindTexture(1, GL_TEXTURE_2D, item.bumpTexture_);
+                    currentBump = item.bumpTexture_;
+                    statistics_.textureBinds_ += 1;
+                }
+                else statistics_.skippedBinds_ += 1;
+
+                if (!item.overrideBump_ && uniformLocations.size() > 4) {
+                    if (item.material_->bumpMultiplier != currentBumpMultiplier) {
+                        glUniform1f(uniformLocations[4], item.material_->bumpMultiplier);
+                        currentBumpMultiplier = item.material_->bumpMultiplier;
+                        statistics_.uniformUpdates_ += 1;
+                    }
+                    else statistics_.skippedBinds_ += 1;
+                }
+            }
+
+            if (item.usesPerDrawBlock_) {
+                StandardUniforms::SetPerDraw(item.modelMatrix_, item.normalMatrix_);
+                statistics_.uniformUpdates_ += 1;
+            }
+            else {
+                glUniformMatrix4fv(uniformLocations[0], 1, GL_FALSE, glm::value_ptr(item.modelMatrix_));
+                glUniformMatrix3fv(uniformLocations[1], 1, GL_FALSE, glm::value_ptr(item.normalMatrix_));
+                statistics_.uniformUpdates_ += 2;
+            }
+
+            glDrawElementsInstanced(GL_TRIANGLES, item.numIndices_, GL_UNSIGNED_INT,
+                (static_cast<char*> (nullptr)) + (item.indexOffset_ * sizeof(unsigned int)), numLayers);
+            statistics_.drawCalls_ += 1;
+        }
+        GLStateCache::BindVertexArray(0);
+
+        items_.clear();
+    }
+}
@@ -0,0 +1,86 @@
+/**
+ * @file   RenderQueue.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of a render queue that sorts sub-mesh draws by state.
+ */
+
+#pragma once
+
+#include "core/main.h"
+#include "core/open_gl_fwd.h"
+
+namespace viscom {
+
+    struct Material;
+
+    /** A single sub-mesh draw in the render queue. */
+    struct RenderQueueItem
+    {
+        /** The GPU program used. */
+        GLuint program_;
+        /** The vertex array object used. */
+        GLuint vao_;
+        /** The location of the instance matrix attribute set to the identity (-1 if not used, see MeshRenderable). */
+        GLint instanceMatrixLocation_;
+        /** The location of the draw index attribute (-1 if not used, see MeshRenderable). */
+        GLint drawIndexLocation_;
+        /** The standard uniform locations of the program (see MeshRenderable). */
+        const std::vector<GLint>* uniformLocations_;
+        /** Flag if the matrices are written to the per-draw uniform block instead of the uniforms. */
+        bool usesPerDrawBlock_;
+        /** The diffuse texture (0 if none). */
+        GLuint diffuseTexture_;
+        /** The bump texture (0 if none). */
+        GLuint bumpTexture_;
+        /** The material of the sub-mesh. */
+        const Material* material_;
+        /** Flag if the bump multiplier should not be set from the material. */
+        bool overrideBump_;
+        /** The model matrix. */
+        glm::mat4 modelMatrix_;
+        /** The normal matrix. */
+        glm::mat3 normalMatrix_;
+        /** The number of indices to draw. */
+        GLsizei numIndices_;
+        /** The offset of the first index. */
+        std::size_t indexOffset_;
+    };
+
+    /** Number of state changes and draw calls of the last flush of a render queue. */
+    struct RenderQueueStatistics
+    {
+        std::size_t programChanges_ = 0;
+        std::size_t vertexArrayChanges_ = 0;
+        std::size_t textureBinds_ = 0;
+        std::size_t uniformUpdates_ = 0;
+        std::size_t drawCalls_ = 0;
+        /** The number of binds that were skipped because the state was already set. */
+        std::size_t skippedBinds_ = 0;
+    };
+
+    /**
+     *  Collects sub-mesh draws (see MeshRenderable::Enqueue) and issues them sorted by program, vertex array,
+     *  textures and material, so redundant state changes can be skipped.
+     */
+    class RenderQueue
+    {
+    public:
+        void Push(const RenderQueueItem& item) { items_.push_back(item); }
+        void Clear() noexcept { items_.clear(); }
+        std::size_t GetNumberOfItems() const noexcept { return items_.size(); }
+
+        void Flush();
+
+        const RenderQueueStatistics& GetStatistics() const noexcept { return statistics_; }
+
+    private:
+        /** The queued items. */
+        std::vector<RenderQueueItem> items_;
+        /** The draw order of the items. */
+        std::vector<std::uint32_t> order_;
+        /** The statistics of the last flush. */
+        RenderQueueStatistics statistics_;
+    };
+}
@@ -0,0 +1,95 @@
+/**
+ * @file   SceneBVH.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of a world space BVH over the sub-meshes of a scene.
+ */
+
+#include "SceneBVH.h"
+#include "Mesh.h"
+#include "SceneMeshNode.h"
+#include "core/math/math.h"
+#include "core/math/transforms.h"
+#include <cassert>
+
+namespace viscom {
+
+    /** Removes all entries. */
+    void SceneBVH::Clear() noexcept
+    {
+        entries_.clear();
+        bvh_.Clear();
+    }
+
+    /**
+     *  Adds all sub-meshes of a (possibly animated) mesh. Build() needs to be called afterwards.
+     *  @param mesh the mesh to add.
+     *  @param nodeWorldTransforms the world transform of each node (see Mesh::ComputeNodeWorldTransforms).
+     *  @param userId an id stored with all entries.
+     */
+    void SceneBVH::AddMesh(const Mesh* mesh, const std::vector<glm::mat4>& nodeWorldTransforms, std::uint32_t userId)
+    {
+        const auto& nodes = mesh->GetNodes();
+        assert(nodeWorldTransforms.size() >= nodes.size());
+        for (std::size_t n = 0; n < nodes.size(); ++n) {
+            for (std::size_t i = 0; i < nodes[n]->GetNumberOfSubMeshes(); ++i) {
+                auto subMeshId = nodes[n]->GetSubMeshID(i);
+                const auto& localAABB = mesh->GetSubMeshes()[subMeshId].GetLocalAABB();
+                // skip sub-meshes without triangles.
+                if (localAABB.minmax_[0].x > localAABB.minmax_[1].x) continue;
+                entries_.push_back(Entry{ mesh, static_cast<std::uint32_t>(n), static_cast<std::uint32_t>(subMeshId), userId,
+                    math::transformAABB(localAABB, nodeWorldTransforms[n]) });
+            }
+        }
+    }
+
+    /**
+     *  Adds all sub-meshes of a mesh in its static pose. Build() needs to be called afterwards.
+     *  @param mesh the mesh to add.
+     *  @param modelMatrix the model matrix of the mesh.
+     *  @param userId an id stored with all entries.
+     */
+    void SceneBVH::AddMesh(const Mesh* mesh, const glm::mat4& modelMatrix, std::uint32_t userId)
+    {
+        std::vector<glm::mat4> nodeWorldTransforms(mesh->GetNodes().size());
+        mesh->ComputeNodeWorldTransforms(modelMatrix, mesh->GetNodeLocalTransforms(), nodeWorldTransforms);
+        AddMesh(mesh, nodeWorldTransforms, userId);
+    }
+
+    /**
+     *  Builds the hierarchy over all entries added.
+     *  @param maxLeafSize the maximum number of entries in a leaf the builder aims for.
+     */
+    void SceneBVH::Build(std::size_t maxLeafSize)
+    {
+        std::vector<math::AABB3<float>> boxes(entries_.size());
+        for (std::size_t i = 0; i < entries_.size(); ++i) boxes[i] = entries_[i].aabb_;
+        bvh_.Build(boxes, maxLeafSize);
+    }
+
+    /**
+     *  Collects all entries inside or intersected by a view frustum.
+     *  @param viewProjection the view projection matrix of the frustum.
+     *  @param visibleEntries the indices of all visible entries are appended to this.
+     */
+    void SceneBVH::CullFrustum(const glm::mat4& viewProjection, std::vector<std::uint32_t>& visibleEntries) const
+    {
+        auto frustum = math::extractFrustum(viewProjection);
+        bvh_.QueryFrustum(frustum, [this, &frustum, &visibleEntries](std::uint32_t entry) {
+            if (math::AABBInFrustumTest(frustum, entries_[entry].aabb_)) visibleEntries.push_back(entry);
+        });
+    }
+
+    /**
+     *  Collects all entries overlapping a box.
+     *  @param box the world space box.
+     *  @param overlappingEntries the indices of all overlapping entries are appended to this.
+     */
+    void SceneBVH::QueryOverlap(const math::AABB3<float>& box, std::vector<std::uint32_t>& overlappingEntries) const
+    {
+        bvh_.QueryOverlap(box, [this, &box, &overlappingEntries](std::uint32_t entry) {
+            if (entries_[entry].aabb_.IsIntersecting(box)) overlappingEntries.push_back(entry);
+        });
+    }
+}
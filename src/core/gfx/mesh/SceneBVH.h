@@ -0,0 +1,58 @@
+/**
+ * @file   SceneBVH.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of a world space BVH over the sub-meshes of a scene.
+ */
+
+#pragma once
+
+#include "core/main.h"
+#include "core/math/BVH.h"
+
+namespace viscom {
+
+    class Mesh;
+
+    /**
+     *  Bounding volume hierarchy over the world space boxes of all sub-meshes of one or more meshes.
+     *  The scene hierarchy of a mesh is often very unbalanced, so this is used instead for frustum culling,
+     *  ray picking and proximity queries. The BVH needs to be rebuilt when meshes move.
+     */
+    class SceneBVH
+    {
+    public:
+        /** An entry in the BVH, i.e., a sub-mesh instance in world space. */
+        struct Entry
+        {
+            /** The mesh the sub-mesh belongs to. */
+            const Mesh* mesh_;
+            /** The index of the node (in Mesh::GetNodes() order) the sub-mesh is referenced by. */
+            std::uint32_t node_;
+            /** The index of the sub-mesh. */
+            std::uint32_t subMesh_;
+            /** A user defined id (e.g., to identify the mesh instance). */
+            std::uint32_t userId_;
+            /** The world space box of the sub-mesh. */
+            math::AABB3<float> aabb_;
+        };
+
+        void Clear() noexcept;
+        void AddMesh(const Mesh* mesh, const std::vector<glm::mat4>& nodeWorldTransforms, std::uint32_t userId = 0);
+        void AddMesh(const Mesh* mesh, const glm::mat4& modelMatrix, std::uint32_t userId = 0);
+        void Build(std::size_t maxLeafSize = 2);
+
+        const std::vector<Entry>& GetEntries() const noexcept { return entries_; }
+        const math::BVH& GetBVH() const noexcept { return bvh_; }
+
+        void CullFrustum(const glm::mat4& viewProjection, std::vector<std::uint32_t>& visibleEntries) const;
+        void QueryOverlap(const math::AABB3<float>& box, std::vector<std::uint32_t>& overlappingEntries) const;
+
+    private:
+        /** The sub-mesh instances. */
+        std::vector<Entry> entries_;
+        /** The hierarchy over all entries. */
+        math::BVH bvh_;
+    };
+}
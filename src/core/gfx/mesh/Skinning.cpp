@@ -0,0 +1,133 @@
+/**
+ * @file   Skinning.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of CPU side skinning functions.
+ */
+
+#include "Skinning.h"
+#include "core/math/simd.h"
+#include "core/math/transforms.h"
+
+namespace viscom {
+
+    namespace {
+
+#ifdef VISCOM_SIMD_SSE
+        /** Blends the skinning matrices of one vertex, returns false if the vertex has no bone weights. */
+        inline bool BlendSkinningMatrices(const float* matrices, const glm::uvec4& indices, const glm::vec4& weights, __m128 (&m)[4])
+        {
+            if (weights.x + weights.y + weights.z + weights.w <= 0.0f) return false;
+
+            m[0] = m[1] = m[2] = m[3] = _mm_setzero_ps();
+            for (glm::length_t i = 0; i < 4; ++i) {
+                if (weights[i] == 0.0f) continue;
+                const auto w = _mm_set1_ps(weights[i]);
+                const auto* mat = matrices + 16 * static_cast<std::size_t>(indices[i]);
+                m[0] = _mm_add_ps(m[0], _mm_mul_ps(w, _mm_loadu_ps(mat)));
+                m[1] = _mm_add_ps(m[1], _mm_mul_ps(w, _mm_loadu_ps(mat + 4)));
+                m[2] = _mm_add_ps(m[2], _mm_mul_ps(w, _mm_loadu_ps(mat + 8)));
+                m[3] = _mm_add_ps(m[3], _mm_mul_ps(w, _mm_loadu_ps(mat + 12)));
+            }
+            return true;
+        }
+
+        /** Transforms a vector by the upper 3 columns of a matrix (w = 0). */
+        inline __m128 TransformVector(const __m128 (&m)[4], const glm::vec3& v)
+        {
+            auto r = _mm_mul_ps(m[0], _mm_set1_ps(v.x));
+            r = _mm_add_ps(r, _mm_mul_ps(m[1], _mm_set1_ps(v.y)));
+            return _mm_add_ps(r, _mm_mul_ps(m[2], _mm_set1_ps(v.z)));
+        }
+
+        inline glm::vec3 StoreVec3(__m128 v)
+        {
+            alignas(16) float result[4];
+            _mm_store_ps(result, v);
+            return glm::vec3{ result[0], result[1], result[2] };
+        }
+#else
+        /** Blends the skinning matrices of one vertex, returns false if the vertex has no bone weights. */
+        inline bool BlendSkinningMatrices(const glm::mat4* matrices, const glm::uvec4& indices, const glm::vec4& weights, glm::mat4& m)
+        {
+            if (weights.x + weights.y + weights.z + weights.w <= 0.0f) return false;
+
+            m = glm::mat4{ 0.0f };
+            for (glm::length_t i = 0; i < 4; ++i) {
+                if (weights[i] == 0.0f) continue;
+                m += weights[i] * matrices[indices[i]];
+            }
+            return true;
+        }
+#endif
+    }
+
+    void SkinPositions(const glm::vec3* positions, const glm::uvec4* boneIndices, const glm::vec4* boneWeights,
+        std::size_t numVertices, const glm::mat4* skinningMatrices, glm::vec3* result)
+    {
+#ifdef VISCOM_SIMD_SSE
+        const auto* matrices = reinterpret_cast<const float*>(skinningMatrices);
+        __m128 m[4];
+        for (std::size_t v = 0; v < numVertices; ++v) {
+            if (!BlendSkinningMatrices(matrices, boneIndices[v], boneWeights[v], m)) {
+                result[v] = positions[v];
+                continue;
+            }
+            result[v] = StoreVec3(_mm_add_ps(TransformVector(m, positions[v]), m[3]));
+        }
+#else
+        glm::mat4 m;
+        for (std::size_t v = 0; v < numVertices; ++v) {
+            if (!BlendSkinningMatrices(skinningMatrices, boneIndices[v], boneWeights[v], m)) {
+                result[v] = positions[v];
+                continue;
+            }
+            result[v] = glm::vec3(m * glm::vec4(positions[v], 1.0f));
+        }
+#endif
+    }
+
+    void SkinPositionsAndNormals(const glm::vec3* positions, const glm::vec3* normals, const glm::uvec4* boneIndices,
+        const glm::vec4* boneWeights, std::size_t numVertices, const glm::mat4* skinningMatrices,
+        glm::vec3* resultPositions, glm::vec3* resultNormals)
+    {
+#ifdef VISCOM_SIMD_SSE
+        const auto* matrices = reinterpret_cast<const float*>(skinningMatrices);
+        __m128 m[4];
+        for (std::size_t v = 0; v < numVertices; ++v) {
+            if (!BlendSkinningMatrices(matrices, boneIndices[v], boneWeights[v], m)) {
+                resultPositions[v] = positions[v];
+                resultNormals[v] = normals[v];
+                continue;
+            }
+            resultPositions[v] = StoreVec3(_mm_add_ps(TransformVector(m, positions[v]), m[3]));
+            resultNormals[v] = glm::normalize(StoreVec3(TransformVector(m, normals[v])));
+        }
+#else
+        glm::mat4 m;
+        for (std::size_t v = 0; v < numVertices; ++v) {
+            if (!BlendSkinningMatrices(skinningMatrices, boneIndices[v], boneWeights[v], m)) {
+                resultPositions[v] = positions[v];
+                resultNormals[v] = normals[v];
+                continue;
+            }
+            resultPositions[v] = glm::vec3(m * glm::vec4(positions[v], 1.0f));
+            resultNormals[v] = glm::normalize(glm::vec3(m * glm::vec4(normals[v], 0.0f)));
+        }
+#endif
+    }
+
+    math::AABB3<float> ComputeSkinnedBoundingBox(const std::vector<math::AABB3<float>>& boneBoundingBoxes,
+        const glm::mat4* skinningMatrices)
+    {
+        math::AABB3<float> result;
+        for (std::size_t b = 0; b < boneBoundingBoxes.size(); ++b) {
+            const auto& box = boneBoundingBoxes[b];
+            // bones without any vertices have an empty box.
+            if (box.minmax_[0].x > box.minmax_[1].x) continue;
+            result = result.Union(math::transformAABB(box, skinningMatrices[b]));
+        }
+        return result;
+    }
+}
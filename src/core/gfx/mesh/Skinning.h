@@ -0,0 +1,46 @@
+/**
+ * @file   Skinning.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of CPU side skinning functions.
+ */
+
+#pragma once
+
+#include "core/math/aabb.h"
+#include <vector>
+
+namespace viscom {
+
+    /**
+     *  Skins vertex positions with up to four bones per vertex (linear blend skinning).
+     *  The skinning matrices are expected to be the same as the ones used in shaders (i.e.,
+     *  globalInverse * globalBoneTransform * inverseBindPose). Vertices without any bone weight are copied.
+     *  @param positions the bind pose positions.
+     *  @param boneIndices the bone indices for each vertex.
+     *  @param boneWeights the (normalized) bone weights for each vertex.
+     *  @param numVertices the number of vertices to skin.
+     *  @param skinningMatrices the skinning matrix for each bone.
+     *  @param result the buffer to write the skinned positions to (needs to hold numVertices entries).
+     */
+    void SkinPositions(const glm::vec3* positions, const glm::uvec4* boneIndices, const glm::vec4* boneWeights,
+        std::size_t numVertices, const glm::mat4* skinningMatrices, glm::vec3* result);
+
+    /**
+     *  Skins vertex positions and normals with up to four bones per vertex (see SkinPositions).
+     *  Normals are transformed with the blended upper 3x3 matrix and re-normalized.
+     */
+    void SkinPositionsAndNormals(const glm::vec3* positions, const glm::vec3* normals, const glm::uvec4* boneIndices,
+        const glm::vec4* boneWeights, std::size_t numVertices, const glm::mat4* skinningMatrices,
+        glm::vec3* resultPositions, glm::vec3* resultNormals);
+
+    /**
+     *  Computes the bounding box of an animated mesh from the bind pose bounding boxes of its bones.
+     *  @param boneBoundingBoxes the bind pose boxes of all vertices influenced by each bone.
+     *  @param skinningMatrices the skinning matrix for each bone.
+     *  @return the box enclosing all transformed bone boxes.
+     */
+    math::AABB3<float> ComputeSkinnedBoundingBox(const std::vector<math::AABB3<float>>& boneBoundingBoxes,
+        const glm::mat4* skinningMatrices);
+}
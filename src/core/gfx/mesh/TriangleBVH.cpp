@@ -0,0 +1,159 @@
+/**
+ * @file   TriangleBVH.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of a BVH over triangles for ray picking.
+ */
+
+#include "TriangleBVH.h"
+#include "core/math/simd.h"
+
+namespace viscom {
+
+    /**
+     *  Constructor, builds the hierarchy.
+     *  @param vertices the vertices referenced by the indices.
+     *  @param indices three indices for each triangle.
+     *  @param numTriangles the number of triangles.
+     *  @param maxLeafSize the maximum number of triangles in a leaf the builder aims for.
+     */
+    TriangleBVH::TriangleBVH(const std::vector<glm::vec3>& vertices, const unsigned int* indices, std::size_t numTriangles, std::size_t maxLeafSize)
+    {
+        std::vector<math::AABB3<float>> boxes(numTriangles);
+        for (std::size_t t = 0; t < numTriangles; ++t) {
+            boxes[t].AddPoint(vertices[indices[3 * t]]);
+            boxes[t].AddPoint(vertices[indices[3 * t + 1]]);
+            boxes[t].AddPoint(vertices[indices[3 * t + 2]]);
+        }
+        bvh_.Build(boxes, maxLeafSize);
+
+        const auto& primitiveIndices = bvh_.GetPrimitiveIndices();
+        packets_.resize((primitiveIndices.size() + 3) / 4);
+        for (auto& packet : packets_) packet = TrianglePacket{};
+        for (std::size_t i = 0; i < primitiveIndices.size(); ++i) {
+            auto t = primitiveIndices[i];
+            const auto& v0 = vertices[indices[3 * t]];
+            auto e1 = vertices[indices[3 * t + 1]] - v0;
+            auto e2 = vertices[indices[3 * t + 2]] - v0;
+            auto& packet = packets_[i / 4];
+            for (glm::length_t c = 0; c < 3; ++c) {
+                packet.v0_[c][i % 4] = v0[c];
+                packet.e1_[c][i % 4] = e1[c];
+                packet.e2_[c][i % 4] = e2[c];
+            }
+        }
+    }
+
+    /**
+     *  Finds the closest intersection of a ray with the triangles (Moeller/Trumbore, both sides).
+     *  @param origin the rays origin.
+     *  @param direction the rays direction.
+     *  @param maxDistance the maximum distance along the ray (in multiples of direction).
+     *  @param hit the closest hit, only written if a triangle was hit.
+     *  @return whether any triangle was hit.
+     */
+    bool TriangleBVH::Intersect(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, TriangleHit& hit) const
+    {
+        bool found = false;
+        bvh_.QueryRayLeaves(origin, direction, maxDistance, [this, &origin, &direction, &hit, &found](std::uint32_t first, std::uint32_t count, float& leafMaxDistance) {
+            IntersectLeaf(first, count, origin, direction, leafMaxDistance, hit, found);
+        });
+        return found;
+    }
+
+    void TriangleBVH::IntersectLeaf(std::uint32_t first, std::uint32_t count, const glm::vec3& origin, const glm::vec3& direction,
+        float& maxDistance, TriangleHit& hit, bool& found) const
+    {
+        const auto& primitiveIndices = bvh_.GetPrimitiveIndices();
+        const auto last = first + count;
+
+#ifdef VISCOM_SIMD_SSE
+        const auto ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), oz = _mm_set1_ps(origin.z);
+        const auto dx = _mm_set1_ps(direction.x), dy = _mm_set1_ps(direction.y), dz = _mm_set1_ps(direction.z);
+        const auto zero = _mm_setzero_ps();
+        const auto one = _mm_set1_ps(1.0f);
+
+        for (auto p = first / 4; p <= (last - 1) / 4; ++p) {
+            const auto& packet = packets_[p];
+            const auto e1x = _mm_load_ps(packet.e1_[0]), e1y = _mm_load_ps(packet.e1_[1]), e1z = _mm_load_ps(packet.e1_[2]);
+            const auto e2x = _mm_load_ps(packet.e2_[0]), e2y = _mm_load_ps(packet.e2_[1]), e2z = _mm_load_ps(packet.e2_[2]);
+
+            // pvec = direction x e2
+            const auto pvx = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            const auto pvy = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            const auto pvz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+            const auto det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, pvx), _mm_mul_ps(e1y, pvy)), _mm_mul_ps(e1z, pvz));
+            const auto invDet = _mm_div_ps(one, det);
+
+            // tvec = origin - v0
+            const auto tx = _mm_sub_ps(ox, _mm_load_ps(packet.v0_[0]));
+            const auto ty = _mm_sub_ps(oy, _mm_load_ps(packet.v0_[1]));
+            const auto tz = _mm_sub_ps(oz, _mm_load_ps(packet.v0_[2]));
+            const auto u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, pvx), _mm_mul_ps(ty, pvy)), _mm_mul_ps(tz, pvz)), invDet);
+
+            // qvec = tvec x e1
+            const auto qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+            const auto qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+            const auto qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+            const auto v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+            const auto t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+
+            auto mask = _mm_cmpneq_ps(det, zero);
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(u, zero));
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(v, zero));
+            mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(u, v), one));
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(t, zero));
+            mask = _mm_and_ps(mask, _mm_cmplt_ps(t, _mm_set1_ps(maxDistance)));
+
+            auto hits = _mm_movemask_ps(mask);
+            if (hits == 0) continue;
+
+            alignas(16) float ts[4], us[4], vs[4];
+            _mm_store_ps(ts, t);
+            _mm_store_ps(us, u);
+            _mm_store_ps(vs, v);
+            for (std::uint32_t l = 0; l < 4; ++l) {
+                auto slot = 4 * p + l;
+                // lanes of neighboring leaves (or padding) in the same packet are ignored.
+                if ((hits & (1 << l)) == 0 || slot < first || slot >= last || ts[l] >= maxDistance) continue;
+                maxDistance = ts[l];
+                hit.triangle_ = primitiveIndices[slot];
+                hit.barycentrics_ = glm::vec2{ us[l], vs[l] };
+                hit.distance_ = ts[l];
+                found = true;
+            }
+        }
+#else
+        for (auto slot = first; slot < last; ++slot) {
+            const auto& packet = packets_[slot / 4];
+            const auto l = slot % 4;
+            glm::vec3 v0{ packet.v0_[0][l], packet.v0_[1][l], packet.v0_[2][l] };
+            glm::vec3 e1{ packet.e1_[0][l], packet.e1_[1][l], packet.e1_[2][l] };
+            glm::vec3 e2{ packet.e2_[0][l], packet.e2_[1][l], packet.e2_[2][l] };
+
+            auto pvec = glm::cross(direction, e2);
+            auto det = glm::dot(e1, pvec);
+            if (det == 0.0f) continue;
+            auto invDet = 1.0f / det;
+
+            auto tvec = origin - v0;
+            auto u = glm::dot(tvec, pvec) * invDet;
+            if (u < 0.0f || u > 1.0f) continue;
+
+            auto qvec = glm::cross(tvec, e1);
+            auto v = glm::dot(direction, qvec) * invDet;
+            if (v < 0.0f || u + v > 1.0f) continue;
+
+            auto t = glm::dot(e2, qvec) * invDet;
+            if (t < 0.0f || t >= maxDistance) continue;
+
+            maxDistance = t;
+            hit.triangle_ = primitiveIndices[slot];
+            hit.barycentrics_ = glm::vec2{ u, v };
+            hit.distance_ = t;
+            found = true;
+        }
+#endif
+    }
+}
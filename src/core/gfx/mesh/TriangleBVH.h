@@ -0,0 +1,58 @@
+/**
+ * @file   TriangleBVH.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of a BVH over triangles for ray picking.
+ */
+
+#pragma once
+
+#include "core/math/BVH.h"
+#include <limits>
+
+namespace viscom {
+
+    /** Result of a ray/triangle intersection. */
+    struct TriangleHit
+    {
+        /** The index of the triangle hit. */
+        std::uint32_t triangle_ = 0;
+        /** The barycentric coordinates of the hit with respect to the second and third vertex. */
+        glm::vec2 barycentrics_{ 0.0f };
+        /** The distance along the ray (in multiples of the rays direction). */
+        float distance_ = std::numeric_limits<float>::max();
+    };
+
+    /**
+     *  Bounding volume hierarchy over triangles. The triangles are stored in packets of four in leaf order,
+     *  so they can be intersected with SSE in one go.
+     */
+    class TriangleBVH
+    {
+    public:
+        TriangleBVH() noexcept = default;
+        TriangleBVH(const std::vector<glm::vec3>& vertices, const unsigned int* indices, std::size_t numTriangles, std::size_t maxLeafSize = 4);
+
+        bool Intersect(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, TriangleHit& hit) const;
+
+        const math::BVH& GetBVH() const noexcept { return bvh_; }
+
+    private:
+        /** Four triangles as first vertex and two edges in SoA layout. */
+        struct alignas(16) TrianglePacket
+        {
+            float v0_[3][4];
+            float e1_[3][4];
+            float e2_[3][4];
+        };
+
+        void IntersectLeaf(std::uint32_t first, std::uint32_t count, const glm::vec3& origin, const glm::vec3& direction,
+            float& maxDistance, TriangleHit& hit, bool& found) const;
+
+        /** The hierarchy over all triangles. */
+        math::BVH bvh_;
+        /** The triangles in the order of the BVHs primitive index list, the last packet is padded with degenerate triangles. */
+        std::vector<TrianglePacket> packets_;
+    };
+}
@@ -6,6 +6,7 @@
 ///
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
 #include <vector>
 
@@ -27,18 +28,17 @@ namespace viscom {
     std::size_t FindFrameAtTimeStamp(const std::vector<std::pair<Time, Transform>>& frames, Time time,
                                      std::size_t maxSearch)
     {
-        if (time < 0.0) {
+        if (time < 0.0 || maxSearch == 0) {
             return 0;
         }
 
-        for (std::size_t f = 0U; f < maxSearch; ++f) {
-            if (frames[f].first > time) {
-                if (f == 0) return 0;
-                return f - 1;
-            }
-        }
+        // frames are sorted by time -> binary search for the first frame after time.
+        auto framesEnd = frames.begin() + maxSearch;
+        auto nextFrame = std::upper_bound(frames.begin(), framesEnd, time,
+            [](Time t, const std::pair<Time, Transform>& frame) { return t < frame.first; });
 
-        return maxSearch - 1;
+        if (nextFrame == frames.begin()) return 0;
+        return static_cast<std::size_t>(nextFrame - frames.begin()) - 1;
     }
 
     ///
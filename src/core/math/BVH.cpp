@@ -0,0 +1,196 @@
+/**
+ * @file   BVH.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of a bounding volume hierarchy over axis aligned boxes.
+ */
+
+#include "BVH.h"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+
+namespace viscom::math {
+
+    namespace {
+        /** Number of bins used to evaluate the surface area heuristic. */
+        constexpr std::size_t SAH_BINS = 16;
+
+        /** Half of the surface area of a box. */
+        inline float HalfArea(const glm::vec3& boxMin, const glm::vec3& boxMax)
+        {
+            auto d = glm::max(boxMax - boxMin, glm::vec3(0.0f));
+            return d.x * d.y + d.y * d.z + d.z * d.x;
+        }
+
+        struct SAHBin
+        {
+            glm::vec3 min_{ std::numeric_limits<float>::max() };
+            glm::vec3 max_{ std::numeric_limits<float>::lowest() };
+            std::uint32_t count_ = 0;
+        };
+    }
+
+    /**
+     *  Constructor, builds the hierarchy.
+     *  @param primitiveBoxes the boxes of all primitives (need to be valid, i.e., min <= max).
+     *  @param maxLeafSize the maximum number of primitives in a leaf the builder aims for.
+     */
+    BVH::BVH(const std::vector<AABB3<float>>& primitiveBoxes, std::size_t maxLeafSize)
+    {
+        Build(primitiveBoxes, maxLeafSize);
+    }
+
+    /**
+     *  Builds the hierarchy, any old hierarchy is replaced.
+     *  @param primitiveBoxes the boxes of all primitives (need to be valid, i.e., min <= max).
+     *  @param maxLeafSize the maximum number of primitives in a leaf the builder aims for.
+     */
+    void BVH::Build(const std::vector<AABB3<float>>& primitiveBoxes, std::size_t maxLeafSize)
+    {
+        Clear();
+        if (primitiveBoxes.empty()) return;
+
+        std::vector<glm::vec3> centroids(primitiveBoxes.size());
+        for (std::size_t i = 0; i < primitiveBoxes.size(); ++i) {
+            centroids[i] = 0.5f * (primitiveBoxes[i].minmax_[0] + primitiveBoxes[i].minmax_[1]);
+        }
+
+        primitiveIndices_.resize(primitiveBoxes.size());
+        std::iota(primitiveIndices_.begin(), primitiveIndices_.end(), 0U);
+        nodes_.reserve(2 * primitiveBoxes.size());
+        BuildNode(0, static_cast<std::uint32_t>(primitiveBoxes.size()), primitiveBoxes, centroids, glm::max(maxLeafSize, std::size_t{ 1 }), 0);
+        nodes_.shrink_to_fit();
+    }
+
+    void BVH::Clear() noexcept
+    {
+        nodes_.clear();
+        primitiveIndices_.clear();
+    }
+
+    /** Returns the bounding box of all primitives. */
+    AABB3<float> BVH::GetBoundingBox() const
+    {
+        if (nodes_.empty()) return AABB3<float>{};
+        return AABB3<float>{ nodes_[0].min_, nodes_[0].max_ };
+    }
+
+    std::uint32_t BVH::BuildNode(std::uint32_t first, std::uint32_t count, const std::vector<AABB3<float>>& boxes,
+        const std::vector<glm::vec3>& centroids, std::size_t maxLeafSize, std::size_t depth)
+    {
+        auto nodeIndex = static_cast<std::uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+
+        glm::vec3 boxMin{ std::numeric_limits<float>::max() }, boxMax{ std::numeric_limits<float>::lowest() };
+        glm::vec3 centroidMin{ std::numeric_limits<float>::max() }, centroidMax{ std::numeric_limits<float>::lowest() };
+        for (auto i = first; i < first + count; ++i) {
+            auto p = primitiveIndices_[i];
+            boxMin = glm::min(boxMin, boxes[p].minmax_[0]);
+            boxMax = glm::max(boxMax, boxes[p].minmax_[1]);
+            centroidMin = glm::min(centroidMin, centroids[p]);
+            centroidMax = glm::max(centroidMax, centroids[p]);
+        }
+        nodes_[nodeIndex].min_ = boxMin;
+        nodes_[nodeIndex].max_ = boxMax;
+
+        auto makeLeaf = [this, nodeIndex, first, count]() {
+            nodes_[nodeIndex].offset_ = first;
+            nodes_[nodeIndex].count_ = count;
+            return nodeIndex;
+        };
+
+        if (count <= maxLeafSize || depth + 2 >= BVH_MAX_STACK_DEPTH) return makeLeaf();
+
+        // find the best split plane over all axes.
+        auto bestCost = std::numeric_limits<float>::max();
+        glm::length_t bestAxis = -1;
+        std::size_t bestSplit = 0;
+        auto centroidExtent = centroidMax - centroidMin;
+        for (glm::length_t axis = 0; axis < 3; ++axis) {
+            if (centroidExtent[axis] <= 0.0f) continue;
+
+            std::array<SAHBin, SAH_BINS> bins;
+            auto binScale = static_cast<float>(SAH_BINS) / centroidExtent[axis];
+            for (auto i = first; i < first + count; ++i) {
+                auto p = primitiveIndices_[i];
+                auto b = glm::min(static_cast<std::size_t>((centroids[p][axis] - centroidMin[axis]) * binScale), SAH_BINS - 1);
+                bins[b].min_ = glm::min(bins[b].min_, boxes[p].minmax_[0]);
+                bins[b].max_ = glm::max(bins[b].max_, boxes[p].minmax_[1]);
+                bins[b].count_ += 1;
+            }
+
+            // sweep from the right to get the cost of all right sides.
+            std::array<float, SAH_BINS> rightCost;
+            SAHBin right;
+            for (auto b = SAH_BINS - 1; b > 0; --b) {
+                right.min_ = glm::min(right.min_, bins[b].min_);
+                right.max_ = glm::max(right.max_, bins[b].max_);
+                right.count_ += bins[b].count_;
+                rightCost[b] = right.count_ == 0 ? 0.0f : HalfArea(right.min_, right.max_) * static_cast<float>(right.count_);
+            }
+
+            SAHBin left;
+            for (std::size_t b = 0; b < SAH_BINS - 1; ++b) {
+                left.min_ = glm::min(left.min_, bins[b].min_);
+                left.max_ = glm::max(left.max_, bins[b].max_);
+                left.count_ += bins[b].count_;
+                if (left.count_ == 0 || left.count_ == count) continue;
+
+                auto cost = HalfArea(left.min_, left.max_) * static_cast<float>(left.count_) + rightCost[b + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestSplit = b + 1;
+                }
+            }
+        }
+
+        // all centroids are at the same position: nothing to split.
+        if (bestAxis == -1) return makeLeaf();
+
+        // traversal and intersection costs are assumed to be equal.
+        auto leafCost = HalfArea(boxMin, boxMax) * static_cast<float>(count);
+        if (bestCost + HalfArea(boxMin, boxMax) >= leafCost && count <= 4 * maxLeafSize) return makeLeaf();
+
+        auto binScale = static_cast<float>(SAH_BINS) / centroidExtent[bestAxis];
+        auto middle = std::partition(primitiveIndices_.begin() + first, primitiveIndices_.begin() + first + count,
+            [&centroids, &centroidMin, bestAxis, binScale, bestSplit](std::uint32_t p) {
+            return glm::min(static_cast<std::size_t>((centroids[p][bestAxis] - centroidMin[bestAxis]) * binScale), SAH_BINS - 1) < bestSplit;
+        });
+        auto leftCount = static_cast<std::uint32_t>(middle - (primitiveIndices_.begin() + first));
+
+        BuildNode(first, leftCount, boxes, centroids, maxLeafSize, depth + 1);
+        auto rightChild = BuildNode(first + leftCount, count - leftCount, boxes, centroids, maxLeafSize, depth + 1);
+        nodes_[nodeIndex].offset_ = rightChild;
+        nodes_[nodeIndex].count_ = 0;
+        return nodeIndex;
+    }
+
+    int BVH::TestFrustum(const Frustum<float>& frustum, const BVHNode& node)
+    {
+        auto result = 2;
+        for (const auto& plane : frustum.planes) {
+            auto normal = glm::vec3(plane);
+            // positive and negative vertex with respect to the plane normal.
+            auto pVertex = glm::mix(node.min_, node.max_, glm::greaterThanEqual(normal, glm::vec3(0.0f)));
+            auto nVertex = glm::mix(node.max_, node.min_, glm::greaterThanEqual(normal, glm::vec3(0.0f)));
+            if (glm::dot(normal, pVertex) + plane.w < 0.0f) return 0;
+            if (glm::dot(normal, nVertex) + plane.w < 0.0f) result = 1;
+        }
+        return result;
+    }
+
+    float BVH::TestRay(const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance, const BVHNode& node)
+    {
+        auto t0 = (node.min_ - origin) * invDirection;
+        auto t1 = (node.max_ - origin) * invDirection;
+        auto tNear = glm::min(t0, t1);
+        auto tFar = glm::max(t0, t1);
+        auto entry = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, 0.0f));
+        auto exit = glm::min(glm::min(tFar.x, tFar.y), glm::min(tFar.z, maxDistance));
+        return entry <= exit ? entry : -1.0f;
+    }
+}
@@ -0,0 +1,186 @@
+/**
+ * @file   BVH.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of a bounding volume hierarchy over axis aligned boxes.
+ */
+
+#pragma once
+
+#include "primitives.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace viscom::math {
+
+    /**
+     *  A single node of a BVH (32 bytes). Nodes are stored depth first, so the left child of an inner node
+     *  directly follows its parent and offset_ is the index of the right child. For leaves offset_ is the
+     *  first entry in the BVHs primitive index list.
+     */
+    struct BVHNode
+    {
+        /** The boxes minimum. */
+        glm::vec3 min_;
+        /** The index of the right child (inner nodes) or the first primitive (leaves). */
+        std::uint32_t offset_;
+        /** The boxes maximum. */
+        glm::vec3 max_;
+        /** The number of primitives in a leaf, 0 for inner nodes. */
+        std::uint32_t count_;
+
+        bool IsLeaf() const noexcept { return count_ != 0; }
+    };
+
+    static_assert(sizeof(BVHNode) == 32, "BVHNode should fit two nodes into a cache line.");
+
+    /**
+     *  Bounding volume hierarchy over a set of primitive boxes, built with the binned surface area heuristic.
+     *  The BVH only stores indices to the primitives, the queries call a function for each candidate primitive.
+     */
+    class BVH
+    {
+    public:
+        BVH() noexcept = default;
+        explicit BVH(const std::vector<AABB3<float>>& primitiveBoxes, std::size_t maxLeafSize = 4);
+
+        void Build(const std::vector<AABB3<float>>& primitiveBoxes, std::size_t maxLeafSize = 4);
+        void Clear() noexcept;
+
+        bool IsEmpty() const noexcept { return nodes_.empty(); }
+        const std::vector<BVHNode>& GetNodes() const noexcept { return nodes_; }
+        const std::vector<std::uint32_t>& GetPrimitiveIndices() const noexcept { return primitiveIndices_; }
+        AABB3<float> GetBoundingBox() const;
+
+        /**
+         *  Calls fn(primitiveIndex) for all primitives whose node boxes are inside or intersected by the frustum.
+         *  @param frustum the frustum (plane normals pointing inside).
+         *  @param fn the function to call for each candidate primitive.
+         */
+        template<class Fn> void QueryFrustum(const Frustum<float>& frustum, Fn fn) const;
+        /**
+         *  Calls fn(primitiveIndex) for all primitives whose node boxes overlap a box.
+         *  @param box the box to test.
+         *  @param fn the function to call for each candidate primitive.
+         */
+        template<class Fn> void QueryOverlap(const AABB3<float>& box, Fn fn) const;
+        /**
+         *  Calls fn(primitiveIndex, maxDistance) for all primitives whose node boxes are hit by a ray, nearest nodes first.
+         *  The function can reduce maxDistance (e.g., when a closer hit was found) to prune the traversal.
+         *  @param origin the rays origin.
+         *  @param direction the rays direction (does not need to be normalized, distances are in multiples of it).
+         *  @param maxDistance the maximum distance along the ray.
+         *  @param fn the function to call for each candidate primitive.
+         */
+        template<class Fn> void QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Fn fn) const;
+        /**
+         *  Same as QueryRay but calls fn(firstIndex, count, maxDistance) once for each leaf hit. The primitives of the
+         *  leaf are GetPrimitiveIndices()[firstIndex] to GetPrimitiveIndices()[firstIndex + count - 1].
+         */
+        template<class Fn> void QueryRayLeaves(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Fn fn) const;
+
+    private:
+        std::uint32_t BuildNode(std::uint32_t first, std::uint32_t count, const std::vector<AABB3<float>>& boxes,
+            const std::vector<glm::vec3>& centroids, std::size_t maxLeafSize, std::size_t depth);
+
+        /** Tests a node against a frustum, returns 0 if outside, 1 if intersecting and 2 if inside. */
+        static int TestFrustum(const Frustum<float>& frustum, const BVHNode& node);
+        /** Tests a ray (with inverse direction) against a node, returns the entry distance or a negative value on a miss. */
+        static float TestRay(const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance, const BVHNode& node);
+
+        /** The nodes of the hierarchy, the root is the first node. */
+        std::vector<BVHNode> nodes_;
+        /** The primitive indices referenced by the leaves. */
+        std::vector<std::uint32_t> primitiveIndices_;
+    };
+
+    /** Maximum depth of the traversal stacks, the build creates leaves before exceeding it. */
+    constexpr std::size_t BVH_MAX_STACK_DEPTH = 64;
+
+    template<class Fn> inline void BVH::QueryFrustum(const Frustum<float>& frustum, Fn fn) const
+    {
+        if (nodes_.empty()) return;
+
+        std::pair<std::uint32_t, bool> stack[BVH_MAX_STACK_DEPTH];
+        std::size_t stackSize = 0;
+        stack[stackSize++] = std::make_pair(0U, false);
+        while (stackSize > 0) {
+            auto [nodeIndex, inside] = stack[--stackSize];
+            const auto& node = nodes_[nodeIndex];
+            if (!inside) {
+                auto test = TestFrustum(frustum, node);
+                if (test == 0) continue;
+                inside = test == 2;
+            }
+
+            if (node.IsLeaf()) {
+                for (auto i = node.offset_; i < node.offset_ + node.count_; ++i) fn(primitiveIndices_[i]);
+            }
+            else {
+                stack[stackSize++] = std::make_pair(node.offset_, inside);
+                stack[stackSize++] = std::make_pair(nodeIndex + 1, inside);
+            }
+        }
+    }
+
+    template<class Fn> inline void BVH::QueryOverlap(const AABB3<float>& box, Fn fn) const
+    {
+        if (nodes_.empty()) return;
+
+        std::uint32_t stack[BVH_MAX_STACK_DEPTH];
+        std::size_t stackSize = 0;
+        stack[stackSize++] = 0;
+        while (stackSize > 0) {
+            auto nodeIndex = stack[--stackSize];
+            const auto& node = nodes_[nodeIndex];
+            if (glm::any(glm::greaterThan(node.min_, box.minmax_[1])) || glm::any(glm::lessThan(node.max_, box.minmax_[0]))) continue;
+
+            if (node.IsLeaf()) {
+                for (auto i = node.offset_; i < node.offset_ + node.count_; ++i) fn(primitiveIndices_[i]);
+            }
+            else {
+                stack[stackSize++] = node.offset_;
+                stack[stackSize++] = nodeIndex + 1;
+            }
+        }
+    }
+
+    template<class Fn> inline void BVH::QueryRay(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Fn fn) const
+    {
+        QueryRayLeaves(origin, direction, maxDistance, [this, &fn](std::uint32_t first, std::uint32_t count, float& leafMaxDistance) {
+            for (auto i = first; i < first + count; ++i) fn(primitiveIndices_[i], leafMaxDistance);
+        });
+    }
+
+    template<class Fn> inline void BVH::QueryRayLeaves(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Fn fn) const
+    {
+        if (nodes_.empty()) return;
+
+        const auto invDirection = 1.0f / direction;
+        std::pair<std::uint32_t, float> stack[BVH_MAX_STACK_DEPTH];
+        std::size_t stackSize = 0;
+        auto rootDistance = TestRay(origin, invDirection, maxDistance, nodes_[0]);
+        if (rootDistance < 0.0f) return;
+        stack[stackSize++] = std::make_pair(0U, rootDistance);
+        while (stackSize > 0) {
+            auto [nodeIndex, distance] = stack[--stackSize];
+            // a closer hit may have been found since this node was pushed.
+            if (distance > maxDistance) continue;
+            const auto& node = nodes_[nodeIndex];
+
+            if (node.IsLeaf()) {
+                fn(node.offset_, node.count_, maxDistance);
+                continue;
+            }
+
+            std::pair<std::uint32_t, float> nearChild{ nodeIndex + 1, TestRay(origin, invDirection, maxDistance, nodes_[nodeIndex + 1]) };
+            std::pair<std::uint32_t, float> farChild{ node.offset_, TestRay(origin, invDirection, maxDistance, nodes_[node.offset_]) };
+            if (nearChild.second < 0.0f || (farChild.second >= 0.0f && farChild.second < nearChild.second)) std::swap(nearChild, farChild);
+            // push the farther child first so the nearer one is traversed first.
+            if (farChild.second >= 0.0f) stack[stackSize++] = farChild;
+            if (nearChild.second >= 0.0f) stack[stackSize++] = nearChild;
+        }
+    }
+}
@@ -0,0 +1,113 @@
+/**
+ * @file   FrustumCulling.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of batched AABB vs. frustum culling.
+ */
+
+#include "FrustumCulling.h"
+#include "simd.h"
+#include <algorithm>
+#include <array>
+
+namespace viscom::math {
+
+    void AABB3ArraySoA::resize(std::size_t size)
+    {
+        minX_.resize(size); minY_.resize(size); minZ_.resize(size);
+        maxX_.resize(size); maxY_.resize(size); maxZ_.resize(size);
+    }
+
+    void AABB3ArraySoA::clear() noexcept
+    {
+        minX_.clear(); minY_.clear(); minZ_.clear();
+        maxX_.clear(); maxY_.clear(); maxZ_.clear();
+    }
+
+    void AABB3ArraySoA::Set(std::size_t index, const AABB3<float>& aabb)
+    {
+        minX_[index] = aabb.minmax_[0].x; minY_[index] = aabb.minmax_[0].y; minZ_[index] = aabb.minmax_[0].z;
+        maxX_[index] = aabb.minmax_[1].x; maxY_[index] = aabb.minmax_[1].y; maxZ_[index] = aabb.minmax_[1].z;
+    }
+
+    void AABB3ArraySoA::PushBack(const AABB3<float>& aabb)
+    {
+        minX_.push_back(aabb.minmax_[0].x); minY_.push_back(aabb.minmax_[0].y); minZ_.push_back(aabb.minmax_[0].z);
+        maxX_.push_back(aabb.minmax_[1].x); maxY_.push_back(aabb.minmax_[1].y); maxZ_.push_back(aabb.minmax_[1].z);
+    }
+
+    /**
+     *  Tests a batch of boxes against a frustum. A box is visible if its positive vertex is inside all planes
+     *  (same conservative test as AABBInFrustumTest).
+     *  @param frustum the frustum (plane normals pointing inside).
+     *  @param minX, minY, minZ, maxX, maxY, maxZ the boxes in SoA layout.
+     *  @param numBoxes the number of boxes.
+     *  @param visibility the bitmask to write to, needs (numBoxes + 31) / 32 entries. Bit i % 32 of entry i / 32 is set if box i is visible.
+     */
+    void CullAABBs(const Frustum<float>& frustum, const float* minX, const float* minY, const float* minZ,
+        const float* maxX, const float* maxY, const float* maxZ, std::size_t numBoxes, std::uint32_t* visibility)
+    {
+        std::fill_n(visibility, (numBoxes + 31) / 32, 0U);
+
+        // the positive vertex only depends on the plane, so the coordinate arrays can be chosen once per plane.
+        std::array<const float*, 6> px, py, pz;
+        for (std::size_t k = 0; k < 6; ++k) {
+            const auto& plane = frustum.planes[k];
+            px[k] = plane.x >= 0.0f ? maxX : minX;
+            py[k] = plane.y >= 0.0f ? maxY : minY;
+            pz[k] = plane.z >= 0.0f ? maxZ : minZ;
+        }
+
+        std::size_t i = 0;
+#if defined(VISCOM_SIMD_AVX)
+        for (; i + 8 <= numBoxes; i += 8) {
+            auto visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (std::size_t k = 0; k < 6; ++k) {
+                const auto& plane = frustum.planes[k];
+                auto d = _mm256_mul_ps(_mm256_set1_ps(plane.x), _mm256_loadu_ps(px[k] + i));
+                d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(plane.y), _mm256_loadu_ps(py[k] + i)));
+                d = _mm256_add_ps(d, _mm256_mul_ps(_mm256_set1_ps(plane.z), _mm256_loadu_ps(pz[k] + i)));
+                d = _mm256_add_ps(d, _mm256_set1_ps(plane.w));
+                visible = _mm256_and_ps(visible, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GE_OQ));
+            }
+            visibility[i / 32] |= static_cast<std::uint32_t>(_mm256_movemask_ps(visible)) << (i % 32);
+        }
+#elif defined(VISCOM_SIMD_SSE)
+        for (; i + 4 <= numBoxes; i += 4) {
+            auto visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (std::size_t k = 0; k < 6; ++k) {
+                const auto& plane = frustum.planes[k];
+                auto d = _mm_mul_ps(_mm_set1_ps(plane.x), _mm_loadu_ps(px[k] + i));
+                d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(plane.y), _mm_loadu_ps(py[k] + i)));
+                d = _mm_add_ps(d, _mm_mul_ps(_mm_set1_ps(plane.z), _mm_loadu_ps(pz[k] + i)));
+                d = _mm_add_ps(d, _mm_set1_ps(plane.w));
+                visible = _mm_and_ps(visible, _mm_cmpge_ps(d, _mm_setzero_ps()));
+            }
+            visibility[i / 32] |= static_cast<std::uint32_t>(_mm_movemask_ps(visible)) << (i % 32);
+        }
+#endif
+
+        for (; i < numBoxes; ++i) {
+            bool visible = true;
+            for (std::size_t k = 0; k < 6 && visible; ++k) {
+                const auto& plane = frustum.planes[k];
+                visible = plane.x * px[k][i] + plane.y * py[k][i] + plane.z * pz[k][i] + plane.w >= 0.0f;
+            }
+            if (visible) visibility[i / 32] |= 1U << (i % 32);
+        }
+    }
+
+    /**
+     *  Tests a batch of boxes against a frustum.
+     *  @param frustum the frustum (plane normals pointing inside).
+     *  @param boxes the boxes.
+     *  @param visibility the resulting bitmask (see IsVisible()), resized as needed.
+     */
+    void CullAABBs(const Frustum<float>& frustum, const AABB3ArraySoA& boxes, std::vector<std::uint32_t>& visibility)
+    {
+        visibility.resize((boxes.size() + 31) / 32);
+        CullAABBs(frustum, boxes.minX_.data(), boxes.minY_.data(), boxes.minZ_.data(),
+            boxes.maxX_.data(), boxes.maxY_.data(), boxes.maxZ_.data(), boxes.size(), visibility.data());
+    }
+}
@@ -0,0 +1,36 @@
+/**
+ * @file   FrustumCulling.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of batched AABB vs. frustum culling.
+ */
+
+#pragma once
+
+#include "primitives.h"
+#include <cstdint>
+#include <vector>
+
+namespace viscom::math {
+
+    /** A set of axis aligned boxes in SoA layout for batched tests. */
+    struct AABB3ArraySoA
+    {
+        std::vector<float> minX_, minY_, minZ_;
+        std::vector<float> maxX_, maxY_, maxZ_;
+
+        std::size_t size() const noexcept { return minX_.size(); }
+        void resize(std::size_t size);
+        void clear() noexcept;
+        void Set(std::size_t index, const AABB3<float>& aabb);
+        void PushBack(const AABB3<float>& aabb);
+    };
+
+    void CullAABBs(const Frustum<float>& frustum, const float* minX, const float* minY, const float* minZ,
+        const float* maxX, const float* maxY, const float* maxZ, std::size_t numBoxes, std::uint32_t* visibility);
+    void CullAABBs(const Frustum<float>& frustum, const AABB3ArraySoA& boxes, std::vector<std::uint32_t>& visibility);
+
+    /** Returns whether box i is visible in a bitmask written by CullAABBs. */
+    inline bool IsVisible(const std::vector<std::uint32_t>& visibility, std::size_t i) { return (visibility[i / 32] & (1U << (i % 32))) != 0; }
+}
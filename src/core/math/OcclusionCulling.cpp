@@ -0,0 +1,212 @@
+/**
+ * @file   OcclusionCulling.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Implementation of a software rasterized depth buffer for occlusion culling.
+ */
+
+#include "OcclusionCulling.h"
+#include "simd.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace viscom::math {
+
+    namespace {
+        /** Vertices closer to the eye are not projected, the triangle or box is handled conservatively instead. */
+        constexpr float MIN_CLIP_W = 1e-5f;
+        /** Boxes are moved closer by this window depth, so rounding errors of the rasterizer cannot hide them. */
+        constexpr float DEPTH_BIAS = 1e-5f;
+
+        std::size_t RoundUpToTile(std::size_t size)
+        {
+            return std::max<std::size_t>(1, (size + OcclusionBuffer::TILE_SIZE - 1) / OcclusionBuffer::TILE_SIZE) * OcclusionBuffer::TILE_SIZE;
+        }
+    }
+
+    /**
+     *  Constructor.
+     *  @param width the width of the buffer (rounded up to a multiple of TILE_SIZE).
+     *  @param height the height of the buffer (rounded up to a multiple of TILE_SIZE).
+     */
+    OcclusionBuffer::OcclusionBuffer(std::size_t width, std::size_t height) :
+        width_{ RoundUpToTile(width) },
+        height_{ RoundUpToTile(height) },
+        depth_(width_ * height_, 1.0f),
+        tileMaxDepth_((width_ / TILE_SIZE) * (height_ / TILE_SIZE), 1.0f)
+    {
+    }
+
+    /**
+     *  Clears the buffer for a new frame (or window).
+     *  @param viewProjection the view projection matrix used for occluders and tests.
+     */
+    void OcclusionBuffer::Clear(const glm::mat4& viewProjection)
+    {
+        viewProjection_ = viewProjection;
+        std::fill(depth_.begin(), depth_.end(), 1.0f);
+        std::fill(tileMaxDepth_.begin(), tileMaxDepth_.end(), 1.0f);
+        tilesValid_ = true;
+    }
+
+    /**
+     *  Rasterizes an indexed triangle list as occluder. Triangles crossing the near plane are skipped (they would be
+     *  clipped on the GPU), so the buffer never claims more occlusion than there is.
+     *  @param modelMatrix the model matrix of the vertices.
+     *  @param vertices the vertex positions.
+     *  @param indices the indices of the triangles.
+     *  @param numIndices the number of indices.
+     */
+    void OcclusionBuffer::RasterizeTriangles(const glm::mat4& modelMatrix, const std::vector<glm::vec3>& vertices,
+        const unsigned int* indices, std::size_t numIndices)
+    {
+        auto mvp = viewProjection_ * modelMatrix;
+        glm::vec2 screenScale{ 0.5f * static_cast<float>(width_), 0.5f * static_cast<float>(height_) };
+
+        std::array<glm::vec3, 3> screen;
+        for (std::size_t i = 0; i + 2 < numIndices; i += 3) {
+            auto inFront = true;
+            for (std::size_t j = 0; j < 3 && inFront; ++j) {
+                auto clip = mvp * glm::vec4(vertices[indices[i + j]], 1.0f);
+                inFront = clip.w > MIN_CLIP_W && clip.z >= -clip.w;
+                auto ndc = glm::vec3(clip) / clip.w;
+                screen[j] = glm::vec3((glm::vec2(ndc) + 1.0f) * screenScale, 0.5f * ndc.z + 0.5f);
+            }
+            if (inFront) RasterizeTriangle(screen[0], screen[1], screen[2]);
+        }
+    }
+
+    /**
+     *  Tests if a box may be visible, i.e., is not completely behind the occluders. All pixels the box touches (and
+     *  their neighbors) are tested with a small depth bias, so the test is conservative.
+     *  Boxes crossing the near plane or outside of the buffer are reported as visible.
+     *  @param aabb the box in world coordinates.
+     */
+    bool OcclusionBuffer::IsVisible(const AABB3<float>& aabb) const
+    {
+        glm::vec2 screenMin{ std::numeric_limits<float>::max() }, screenMax{ std::numeric_limits<float>::lowest() };
+        auto minDepth = 1.0f;
+        for (std::size_t i = 0; i < 8; ++i) {
+            glm::vec3 corner{ aabb.minmax_[i & 1].x, aabb.minmax_[(i >> 1) & 1].y, aabb.minmax_[(i >> 2) & 1].z };
+            auto clip = viewProjection_ * glm::vec4(corner, 1.0f);
+            if (clip.w <= MIN_CLIP_W || clip.z < -clip.w) return true;
+            auto ndc = glm::vec3(clip) / clip.w;
+            auto screen = (glm::vec2(ndc) + 1.0f) * 0.5f * glm::vec2(width_, height_);
+            screenMin = glm::min(screenMin, screen);
+            screenMax = glm::max(screenMax, screen);
+            minDepth = glm::min(minDepth, 0.5f * ndc.z + 0.5f);
+        }
+
+        auto width = static_cast<float>(width_), height = static_cast<float>(height_);
+        if (screenMax.x < 0.0f || screenMax.y < 0.0f || screenMin.x >= width || screenMin.y >= height) return true;
+
+        // the rectangle is dilated by a pixel to account for rounding errors at its borders.
+        auto x0 = static_cast<std::size_t>(glm::max(std::floor(screenMin.x) - 1.0f, 0.0f));
+        auto y0 = static_cast<std::size_t>(glm::max(std::floor(screenMin.y) - 1.0f, 0.0f));
+        auto x1 = static_cast<std::size_t>(glm::min(std::floor(screenMax.x) + 1.0f, width - 1.0f));
+        auto y1 = static_cast<std::size_t>(glm::min(std::floor(screenMax.y) + 1.0f, height - 1.0f));
+        minDepth -= DEPTH_BIAS;
+
+        UpdateTiles();
+        auto tilesX = width_ / TILE_SIZE;
+        for (auto ty = y0 / TILE_SIZE; ty <= y1 / TILE_SIZE; ++ty) {
+            for (auto tx = x0 / TILE_SIZE; tx <= x1 / TILE_SIZE; ++tx) {
+                // the whole tile is in front of the box.
+                if (tileMaxDepth_[ty * tilesX + tx] < minDepth) continue;
+
+                auto py1 = std::min(y1, ty * TILE_SIZE + TILE_SIZE - 1);
+                auto px1 = std::min(x1, tx * TILE_SIZE + TILE_SIZE - 1);
+                for (auto py = std::max(y0, ty * TILE_SIZE); py <= py1; ++py) {
+                    for (auto px = std::max(x0, tx * TILE_SIZE); px <= px1; ++px) {
+                        if (depth_[py * width_ + px] >= minDepth) return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     *  Rasterizes a single triangle with a depth test. Only pixels completely inside the triangle are covered and
+     *  they get the maximum depth of the triangle inside the pixel, so the buffer never claims more occlusion than
+     *  the triangle causes. Triangles smaller than a pixel and pixels on edges shared by two triangles stay uncovered.
+     *  @param v0, v1In, v2In the vertices in window coordinates (x, y in pixels, z in [0, 1]).
+     */
+    void OcclusionBuffer::RasterizeTriangle(const glm::vec3& v0, const glm::vec3& v1In, const glm::vec3& v2In)
+    {
+        auto area = (v1In.x - v0.x) * (v2In.y - v0.y) - (v1In.y - v0.y) * (v2In.x - v0.x);
+        if (std::abs(area) < 1e-8f) return;
+        // occluders may use either winding.
+        const auto& v1 = area > 0.0f ? v1In : v2In;
+        const auto& v2 = area > 0.0f ? v2In : v1In;
+        area = std::abs(area);
+
+        auto minX = glm::max(std::floor(glm::min(v0.x, glm::min(v1.x, v2.x))), 0.0f);
+        auto minY = glm::max(std::floor(glm::min(v0.y, glm::min(v1.y, v2.y))), 0.0f);
+        auto maxX = glm::min(std::ceil(glm::max(v0.x, glm::max(v1.x, v2.x))), static_cast<float>(width_) - 1.0f);
+        auto maxY = glm::min(std::ceil(glm::max(v0.y, glm::max(v1.y, v2.y))), static_cast<float>(height_) - 1.0f);
+        if (minX > maxX || minY > maxY) return;
+
+        // edge functions e(x, y) = a * x + b * y + c, positive inside; edge i is opposite of vertex i.
+        // c is reduced by the largest decrease of e from the pixel center to a corner, so e(center) >= 0 means the
+        // whole pixel is inside.
+        std::array<float, 3> a{ v1.y - v2.y, v2.y - v0.y, v0.y - v1.y };
+        std::array<float, 3> b{ v2.x - v1.x, v0.x - v2.x, v1.x - v0.x };
+        std::array<float, 3> c{ v1.x * v2.y - v2.x * v1.y, v2.x * v0.y - v0.x * v2.y, v0.x * v1.y - v1.x * v0.y };
+        for (std::size_t e = 0; e < 3; ++e) c[e] -= 0.5f * (std::abs(a[e]) + std::abs(b[e]));
+        // the depth is linear in window coordinates, it is computed relative to v0 to avoid cancellation and
+        // increased to the maximum depth inside the pixel.
+        auto za = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+        auto zb = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) / area;
+        auto zc = v0.z - za * v0.x - zb * v0.y + 0.5f * (std::abs(za) + std::abs(zb));
+
+        // width_ is a multiple of 4, so rows can be processed in aligned groups of 4 pixels.
+        auto x0 = static_cast<std::size_t>(minX) & ~std::size_t{ 3 };
+        auto x1 = static_cast<std::size_t>(maxX);
+        for (auto y = static_cast<std::size_t>(minY); y <= static_cast<std::size_t>(maxY); ++y) {
+            auto py = static_cast<float>(y) + 0.5f;
+            auto* row = &depth_[y * width_];
+            auto x = x0;
+#ifdef VISCOM_SIMD_SSE
+            auto pxOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            auto zero = _mm_setzero_ps();
+            for (; x <= x1; x += 4) {
+                auto px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), pxOffsets);
+                auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (std::size_t e = 0; e < 3; ++e) {
+                    auto ev = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a[e]), px), _mm_set1_ps(b[e] * py + c[e]));
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(ev, zero));
+                }
+                auto z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(za), px), _mm_set1_ps(zb * py + zc));
+                auto old = _mm_loadu_ps(row + x);
+                auto closer = _mm_and_ps(inside, _mm_cmplt_ps(z, old));
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(closer, z), _mm_andnot_ps(closer, old)));
+            }
+#endif
+            for (; x <= x1; ++x) {
+                auto px = static_cast<float>(x) + 0.5f;
+                if (a[0] * px + b[0] * py + c[0] < 0.0f || a[1] * px + b[1] * py + c[1] < 0.0f || a[2] * px + b[2] * py + c[2] < 0.0f) continue;
+                row[x] = glm::min(row[x], za * px + zb * py + zc);
+            }
+        }
+        tilesValid_ = false;
+    }
+
+    /** Recomputes the maximum depth of each tile after occluders were rasterized. */
+    void OcclusionBuffer::UpdateTiles() const
+    {
+        if (tilesValid_) return;
+
+        auto tilesX = width_ / TILE_SIZE;
+        std::fill(tileMaxDepth_.begin(), tileMaxDepth_.end(), 0.0f);
+        for (std::size_t y = 0; y < height_; ++y) {
+            auto* tileRow = &tileMaxDepth_[(y / TILE_SIZE) * tilesX];
+            const auto* row = &depth_[y * width_];
+            for (std::size_t x = 0; x < width_; ++x) tileRow[x / TILE_SIZE] = std::max(tileRow[x / TILE_SIZE], row[x]);
+        }
+        tilesValid_ = true;
+    }
+}
@@ -0,0 +1,60 @@
+/**
+ * @file   OcclusionCulling.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Declaration of a software rasterized depth buffer for occlusion culling.
+ */
+
+#pragma once
+
+#include "primitives.h"
+#include <vector>
+
+namespace viscom::math {
+
+    /**
+     *  A low resolution depth buffer on the CPU. A few large occluders are rasterized into it and bounding boxes are
+     *  tested against it before their contents are submitted to the GPU. Depth values are window coordinates in
+     *  [0, 1] (as with the default glDepthRange), the buffer is cleared to the far plane.
+     *  The test is conservative: occluders only cover pixels they cover completely (with their farthest depth inside
+     *  the pixel) and boxes are tested with a dilated rectangle and a depth bias.
+     *  For fast box tests the maximum depth of each tile of TILE_SIZE x TILE_SIZE pixels is kept as a second level.
+     */
+    class OcclusionBuffer
+    {
+    public:
+        OcclusionBuffer(std::size_t width = 256, std::size_t height = 128);
+
+        void Clear(const glm::mat4& viewProjection);
+        void RasterizeTriangles(const glm::mat4& modelMatrix, const std::vector<glm::vec3>& vertices,
+            const unsigned int* indices, std::size_t numIndices);
+        bool IsVisible(const AABB3<float>& aabb) const;
+
+        std::size_t GetWidth() const noexcept { return width_; }
+        std::size_t GetHeight() const noexcept { return height_; }
+        const glm::mat4& GetViewProjection() const noexcept { return viewProjection_; }
+        /** Returns the depth values row by row, starting at the bottom. */
+        const std::vector<float>& GetDepth() const noexcept { return depth_; }
+
+        /** The size of the tiles of the second level in pixels (width and height are rounded up to it). */
+        static constexpr std::size_t TILE_SIZE = 8;
+
+    private:
+        void RasterizeTriangle(const glm::vec3& v0, const glm::vec3& v1In, const glm::vec3& v2In);
+        void UpdateTiles() const;
+
+        /** The width of the buffer in pixels. */
+        std::size_t width_;
+        /** The height of the buffer in pixels. */
+        std::size_t height_;
+        /** The view projection matrix of the current frame. */
+        glm::mat4 viewProjection_ = glm::mat4{ 1.0f };
+        /** The depth of each pixel. */
+        std::vector<float> depth_;
+        /** The maximum depth of each tile. */
+        mutable std::vector<float> tileMaxDepth_;
+        /** Flag if the tiles are up to date with the depth values. */
+        mutable bool tilesValid_ = true;
+    };
+}
@@ -142,40 +142,31 @@ namespace viscom::math {
         minmax_[1] += offset;
     }
 
-    template<typename real, int N, typename V, int I>
-    struct AABBInternal {
-        static void permuteMultiply(std::vector<V>& result, const glm::tmat4x4<real, glm::highp>& mat, const glm::tvec4<real, glm::highp>& v, const AABB<real, N, V>& aabb)
-        {
-            auto v0 = v;
-            v0[I] = aabb.minmax_[0][I];
-            auto v1 = v;
-            v1[I] = aabb.minmax_[1][I];
-            AABBInternal<real, N, V, I - 1>::permuteMultiply(result, mat, v0, aabb);
-            AABBInternal<real, N, V, I - 1>::permuteMultiply(result, mat, v1, aabb);
-        }
-    };
-
-    template<typename real, int N, typename V>
-    struct AABBInternal<real, N, V, 0> {
-        static void permuteMultiply(std::vector<V>& result, const glm::tmat4x4<real, glm::highp>& mat, const glm::tvec4<real, glm::highp>& v, const AABB<real, N, V>& aabb)
-        {
-            auto v0 = v;
-            v0[0] = aabb.minmax_[0][0];
-            auto v1 = v;
-            v1[0] = aabb.minmax_[1][0];
-            result.emplace_back(mat * v0);
-            result.emplace_back(mat * v1);
-        }
-    };
-
+    /**
+     *  Transforms the box with an affine matrix using the center/extent form of Arvos method:
+     *  the new center is the transformed center and the new extent is the old one transformed by the
+     *  absolute values of the matrix. This neither transforms all corners nor allocates memory.
+     *  Empty boxes (min > max) stay unchanged.
+     */
     template<typename real, int N, typename V>
     inline void AABB<real, N, V>::Transform(const glm::tmat4x4<real, glm::highp>& mat)
     {
+        for (glm::length_t i = 0; i < N; ++i) if (minmax_[0][i] > minmax_[1][i]) return;
+
+        const V center = static_cast<real>(0.5) * (minmax_[0] + minmax_[1]);
+        const V extent = static_cast<real>(0.5) * (minmax_[1] - minmax_[0]);
+        V newCenter, newExtent;
+        for (glm::length_t i = 0; i < N; ++i) {
+            newCenter[i] = mat[3][i];
+            newExtent[i] = static_cast<real>(0);
+            for (glm::length_t j = 0; j < N; ++j) {
+                newCenter[i] += mat[j][i] * center[j];
+                newExtent[i] += glm::abs(mat[j][i]) * extent[j];
+            }
+        }
 
-        std::vector<V> newCorners;
-        AABBInternal<real, N, V, N - 1>::permuteMultiply(newCorners, mat, glm::tvec4<real, glm::highp>{1.0f}, *this);
-
-        FromPoints(newCorners);
+        minmax_[0] = newCenter - newExtent;
+        minmax_[1] = newCenter + newExtent;
     }
 
     template<typename real, int N, typename V>
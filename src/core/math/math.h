@@ -98,7 +98,7 @@ namespace viscom { namespace math {
      *  @param p the point.
      */
     template<typename real> bool pointInAABB2Test(const AABB2<real>& b, const glm::tvec2<real, glm::highp>& p) {
-        return (p.x >= b.minmax[0].x && p.y >= b.minmax[0].y && p.x <= b.minmax[1].x && p.y <= b.minmax[1].y);
+        return (p.x >= b.minmax_[0].x && p.y >= b.minmax_[0].y && p.x <= b.minmax_[1].x && p.y <= b.minmax_[1].y);
     }
 
     /**
@@ -108,7 +108,7 @@ namespace viscom { namespace math {
      *  @param p the point.
      */
     template<typename real> bool pointInAABB3Test(const AABB3<real>& b, const glm::tvec3<real, glm::highp>& p) {
-        auto& bmin = b.minmax[0]; auto& bmax = b.minmax[1];
+        auto& bmin = b.minmax_[0]; auto& bmax = b.minmax_[1];
         return (p.x >= bmin.x && p.y >= bmin.y && p.z >= bmin.z
             && p.x <= bmax.x && p.y <= bmax.y && p.z <= bmax.z);
     }
@@ -120,7 +120,7 @@ namespace viscom { namespace math {
      *  @param b1 the second box.
      */
     template<typename real> bool overlapAABB2Test(const AABB2<real>& b0, const AABB2<real>& b1) {
-        return (pointInAABB2Test(b0, b1.minmax[0]) || pointInAABB2Test(b0, b1.minmax[1]));
+        return (pointInAABB2Test(b0, b1.minmax_[0]) || pointInAABB2Test(b0, b1.minmax_[1]));
     }
 
     /**
@@ -130,7 +130,7 @@ namespace viscom { namespace math {
      *  @param b1 the second box.
      */
     template<typename real> bool overlapAABB3Test(const AABB3<real>& b0, const AABB3<real>& b1) {
-        return (pointInAABB3Test(b0, b1.minmax[0]) || pointInAABB3Test(b0, b1.minmax[1]));
+        return (pointInAABB3Test(b0, b1.minmax_[0]) || pointInAABB3Test(b0, b1.minmax_[1]));
     }
 
     /**
@@ -140,7 +140,7 @@ namespace viscom { namespace math {
      *  @param b1 the second box.
      */
     template<typename real> bool containAABB2Test(const AABB2<real>& b0, const AABB2<real>& b1) {
-        return (pointInAABB2Test(b0, b1.minmax[0]) && pointInAABB2Test(b0, b1.minmax[1]));
+        return (pointInAABB2Test(b0, b1.minmax_[0]) && pointInAABB2Test(b0, b1.minmax_[1]));
     }
 
     /**
@@ -150,7 +150,25 @@ namespace viscom { namespace math {
      *  @param b1 the second box.
      */
     template<typename real> bool containAABB3Test(const AABB3<real>& b0, const AABB3<real>& b1) {
-        return (pointInAABB3Test(b0, b1.minmax[0]) && pointInAABB3Test(b0, b1.minmax[1]));
+        return (pointInAABB3Test(b0, b1.minmax_[0]) && pointInAABB3Test(b0, b1.minmax_[1]));
+    }
+
+    /**
+     *  Extracts the frustum planes from a view projection matrix (Gribb/Hartmann), normals point inside.
+     *  @param real the floating point type used.
+     *  @param m the view projection matrix (or projection * view * model for object space planes).
+     */
+    template<typename real> Frustum<real> extractFrustum(const glm::tmat4x4<real, glm::highp>& m) {
+        Frustum<real> f;
+        auto row = [&m](glm::length_t i) { return glm::tvec4<real, glm::highp>{ m[0][i], m[1][i], m[2][i], m[3][i] }; };
+        f.left() = row(3) + row(0);
+        f.right() = row(3) - row(0);
+        f.top() = row(3) - row(1);
+        f.bttm() = row(3) + row(1);
+        f.near() = row(3) + row(2);
+        f.far() = row(3) - row(2);
+        for (auto& plane : f.planes) plane /= glm::length(glm::tvec3<real, glm::highp>(plane));
+        return f;
     }
 
     /**
@@ -160,10 +178,10 @@ namespace viscom { namespace math {
      *  @param b the box.
      */
     template<typename real> bool AABBInFrustumTest(const Frustum<real>& f, const AABB3<real>& b) {
-        auto& bmax = b.minmax[1];
+        auto& bmax = b.minmax_[1];
         for (unsigned int i = 0; i < 6; ++i) {
             auto& plane = f.planes[i];
-            glm::vec3 p{ b.minmax[0] };
+            glm::vec3 p{ b.minmax_[0] };
             if (plane.x >= 0) p.x = bmax.x;
             if (plane.y >= 0) p.y = bmax.y;
             if (plane.z >= 0) p.z = bmax.z;
@@ -0,0 +1,35 @@
+/**
+ * @file   simd.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Detection of the SIMD instruction sets used by CPU side kernels.
+ */
+
+#pragma once
+
+// SSE2 is part of every x64 target, AVX needs to be enabled explicitly (/arch:AVX or -mavx).
+#if !defined(VISCOM_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define VISCOM_SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+#if defined(VISCOM_SIMD_SSE) && defined(__AVX__)
+#define VISCOM_SIMD_AVX
+#include <immintrin.h>
+#endif
+
+namespace viscom::math {
+
+#ifdef VISCOM_SIMD_SSE
+    constexpr bool USE_SSE = true;
+#else
+    constexpr bool USE_SSE = false;
+#endif
+
+#ifdef VISCOM_SIMD_AVX
+    constexpr bool USE_AVX = true;
+#else
+    constexpr bool USE_AVX = false;
+#endif
+}
@@ -11,6 +11,9 @@
 #include "app/SlaveNode.h"
 #include <imgui.h>
 #include "core/imgui/imgui_impl_glfw_gl3.h"
+#include "core/gfx/GLStateCache.h"
+#include "core/gfx/RenderTargetPool.h"
+#include "core/gfx/UniformBuffers.h"
 #include "core/open_gl.h"
 #include <iostream>
 
@@ -88,9 +91,12 @@ namespace viscom {
         while (!glfwWindowShouldClose(window_)) {
             appNodeImpl_->PreSync();
             PostSyncFunction();
+            // the application may change the OpenGL state directly in each of the callbacks.
+            GLStateCache::Invalidate();
             appNodeImpl_->ClearBuffer(backBuffer_);
             BaseDrawFrame();
             BaseDraw2D();
+            GLStateCache::Invalidate();
             appNodeImpl_->PostDraw();
             ImGui_ImplGlfwGL3_FinishAllFrames();
             glfwSwapBuffers(window_);
@@ -141,11 +147,17 @@ namespace viscom {
         ImGui_ImplGlfwGL3_Init(window_, false);
 
         FullscreenQuad::InitializeStatic();
+        StandardUniforms::InitializeStatic();
+        RenderTargetPool::InitializeStatic();
         appNodeImpl_->InitOpenGL();
+        GLStateCache::Invalidate();
     }
 
     void ApplicationNodeInternal::PostSyncFunction()
     {
+        GLStateCache::ResetStatistics();
+        // all windows of a frame share the streaming buffer region of the frame.
+        StandardUniforms::NextFrame();
         auto lastTime = currentTime_;
         currentTime_ = glfwGetTime();
 
@@ -172,15 +184,36 @@ namespace viscom {
 
     void ApplicationNodeInternal::BaseDrawFrame()
     {
+        GLStateCache::Invalidate();
         glCullFace(GL_BACK);
         glFrontFace(GL_CCW);
-        glEnable(GL_CULL_FACE);
-        glEnable(GL_DEPTH_TEST);
+        GLStateCache::Enable(GL_CULL_FACE);
+        GLStateCache::Enable(GL_DEPTH_TEST);
+        UpdatePerFrameUniforms(0);
         appNodeImpl_->DrawFrame(backBuffer_);
     }
 
+    void ApplicationNodeInternal::UpdatePerFrameUniforms(std::size_t windowId)
+    {
+        PerFrameUniforms perFrame;
+        perFrame.viewMatrix_ = camHelper_.GetViewMatrix();
+        perFrame.projectionMatrix_ = camHelper_.GetPerspectiveMatrix();
+        perFrame.viewProjectionMatrix_ = camHelper_.GetViewPerspectiveMatrix();
+        perFrame.viewport_ = glm::vec4(glm::vec2(GetViewportScreen(windowId).position_), glm::vec2(GetViewportScreen(windowId).size_));
+        perFrame.time_ = static_cast<float>(GetCurrentAppTime());
+        perFrame.elapsedTime_ = static_cast<float>(GetElapsedTime());
+        StandardUniforms::SetPerFrame(perFrame);
+
+        // a single layer, unless the node renders all windows at once.
+        PerLayerUniforms perLayer;
+        perLayer.viewProjectionMatrices_[0] = perFrame.viewProjectionMatrix_;
+        perLayer.numLayers_ = 1;
+        StandardUniforms::SetPerLayer(perLayer);
+    }
+
     void ApplicationNodeInternal::BaseDraw2D()
     {
+        GLStateCache::Invalidate();
         ImGui_ImplGlfwGL3_NewFrame(-GetViewportScreen(0).position_, GetViewportScreen(0).size_, GetViewportScreen(0).size_, GetViewportScaling(0), GetCurrentAppTime(), GetElapsedTime());
 
         appNodeImpl_->Draw2D(backBuffer_);
@@ -196,6 +229,8 @@ namespace viscom {
         ImGui_ImplGlfwGL3_Shutdown();
         ImGui::DestroyContext();
         appNodeImpl_->CleanUp();
+        StandardUniforms::CleanUpStatic();
+        RenderTargetPool::CleanUpStatic();
     }
 
     bool ApplicationNodeInternal::IsMouseButtonPressed(int button) const noexcept
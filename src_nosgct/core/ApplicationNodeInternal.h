@@ -90,6 +90,7 @@ namespace viscom {
         void Terminate() const;
 
         CameraHelper* GetCamera() { return &camHelper_; }
+        unsigned int GetNumRenderLayers() const { return 1; }
         std::vector<FrameBuffer> CreateOffscreenBuffers(const FrameBufferDescriptor& fboDesc, int sizeDivisor = 1) const;
         const FrameBuffer* SelectOffscreenBuffer(const std::vector<FrameBuffer>& offscreenBuffers) const;
         std::unique_ptr<FullscreenQuad> CreateFullscreenQuad(const std::string& fragmentShader);
@@ -100,6 +101,7 @@ namespace viscom {
 
     private:
         glm::dvec2 ConvertInputCoordinates(double x, double y);
+        void UpdatePerFrameUniforms(std::size_t windowId);
 
         /** Holds the applications configuration. */
         FWConfiguration config_;
@@ -34,6 +34,11 @@ namespace viscom {
         localCoordsMatrix_.second = localScreenSize;
     }
 
+    glm::mat4 CameraHelper::GetViewMatrix() const
+    {
+        return userView_ * CalculateViewUpdate();
+    }
+
     glm::mat4 CameraHelper::GetViewPerspectiveMatrix() const
     {
         auto result = CalculateViewUpdate();
@@ -50,6 +55,11 @@ namespace viscom {
         return GetViewPerspectiveMatrix();
     }
 
+    glm::mat4 CameraHelper::GetWindowViewPerspectiveMatrix(std::size_t) const
+    {
+        return GetViewPerspectiveMatrix();
+    }
+
     math::Line3<float> CameraHelper::GetPickRay(const glm::vec2& globalScreenCoords) const
     {
         math::Line3<float> result;
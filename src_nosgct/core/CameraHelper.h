@@ -31,11 +31,13 @@ namespace viscom {
 
         /** Get camera matrices (eye dependent). */
         const glm::mat4& GetPerspectiveMatrix() const { return projection_; }
+        glm::mat4 GetViewMatrix() const;
         glm::mat4 GetViewPerspectiveMatrix() const;
 
         /** Get camera matrices (eye independent). */
         glm::mat4 GetCentralPerspectiveMatrix() const;
         glm::mat4 GetCentralViewPerspectiveMatrix() const;
+        glm::mat4 GetWindowViewPerspectiveMatrix(std::size_t windowId) const;
 
         math::Line3<float> GetPickRay(const glm::vec2& globalScreenCoords) const;
         glm::vec3 GetPickPosition(const glm::vec2& globalScreenCoords) const;
@@ -9,6 +9,9 @@
 #include "ApplicationNodeInternal.h"
 #include "core/ApplicationNodeBase.h"
 #include "core/imgui/imgui_impl_glfw_gl3.h"
+#include "core/gfx/GLStateCache.h"
+#include "core/gfx/RenderTargetPool.h"
+#include "core/gfx/UniformBuffers.h"
 #include "external/tinyxml2.h"
 #include "core/utils/utils.h"
 #include <imgui.h>
@@ -185,8 +188,11 @@ namespace viscom {
         }
 
         FullscreenQuad::InitializeStatic();
+        StandardUniforms::InitializeStatic();
+        RenderTargetPool::InitializeStatic();
         RequestSharedResources();
         appNodeImpl_->InitOpenGL();
+        GLStateCache::Invalidate();
     }
 
     void ApplicationNodeInternal::BasePreSync()
@@ -249,6 +255,9 @@ namespace viscom {
 
     void ApplicationNodeInternal::PostSyncFunction()
     {
+        GLStateCache::ResetStatistics();
+        // all windows of a frame share the streaming buffer region of the frame.
+        StandardUniforms::NextFrame();
 #ifdef VISCOM_SYNCINPUT
         if (!engine_->isMaster()) {
             {
@@ -301,22 +310,45 @@ namespace viscom {
     void ApplicationNodeInternal::BaseClearBuffer()
     {
         if (applicationHalted_) return;
+        GLStateCache::Invalidate();
         appNodeImpl_->ClearBuffer(framebuffers_[GetEngine()->getCurrentWindowIndex()]);
     }
 
     void ApplicationNodeInternal::BaseDrawFrame()
     {
         if (applicationHalted_) return;
+        // SGCT changes the OpenGL state between the draw callbacks.
+        GLStateCache::Invalidate();
         glCullFace(GL_BACK);
         glFrontFace(GL_CCW);
-        glEnable(GL_CULL_FACE);
-        glEnable(GL_DEPTH_TEST);
+        GLStateCache::Enable(GL_CULL_FACE);
+        GLStateCache::Enable(GL_DEPTH_TEST);
+        UpdatePerFrameUniforms(GetEngine()->getCurrentWindowIndex());
         appNodeImpl_->DrawFrame(framebuffers_[GetEngine()->getCurrentWindowIndex()]);
     }
 
+    void ApplicationNodeInternal::UpdatePerFrameUniforms(std::size_t windowId)
+    {
+        PerFrameUniforms perFrame;
+        perFrame.viewMatrix_ = camHelper_.GetViewMatrix();
+        perFrame.projectionMatrix_ = camHelper_.GetPerspectiveMatrix();
+        perFrame.viewProjectionMatrix_ = camHelper_.GetViewPerspectiveMatrix();
+        perFrame.viewport_ = glm::vec4(glm::vec2(GetViewportScreen(windowId).position_), glm::vec2(GetViewportScreen(windowId).size_));
+        perFrame.time_ = static_cast<float>(GetCurrentAppTime());
+        perFrame.elapsedTime_ = static_cast<float>(GetElapsedTime());
+        StandardUniforms::SetPerFrame(perFrame);
+
+        // a single layer, unless the node renders all windows at once.
+        PerLayerUniforms perLayer;
+        perLayer.viewProjectionMatrices_[0] = perFrame.viewProjectionMatrix_;
+        perLayer.numLayers_ = 1;
+        StandardUniforms::SetPerLayer(perLayer);
+    }
+
     void ApplicationNodeInternal::BaseDraw2D()
     {
         if (applicationHalted_) return;
+        GLStateCache::Invalidate();
         auto window = GetEngine()->getCurrentWindowPtr();
 
         if constexpr (SHOW_CLIENT_GUI) ImGui_ImplGlfwGL3_NewFrame(-GetViewportScreen(window->getId()).position_, GetViewportQuadSize(window->getId()), GetViewportScreen(window->getId()).size_, GetViewportScaling(window->getId()), GetCurrentAppTime(), GetElapsedTime());
@@ -340,6 +372,7 @@ namespace viscom {
     void ApplicationNodeInternal::BasePostDraw()
     {
         if (applicationHalted_) return;
+        GLStateCache::Invalidate();
         appNodeImpl_->PostDraw();
         if constexpr (SHOW_CLIENT_GUI) ImGui_ImplGlfwGL3_FinishAllFrames();
         else if (engine_->isMaster()) ImGui_ImplGlfwGL3_FinishAllFrames();
@@ -358,6 +391,8 @@ namespace viscom {
             ImGui::DestroyContext();
         }
         appNodeImpl_->CleanUp();
+        StandardUniforms::CleanUpStatic();
+        RenderTargetPool::CleanUpStatic();
         initialized_ = false;
     }
 
@@ -112,6 +112,8 @@ namespace viscom {
         void Terminate() const;
 
         CameraHelper* GetCamera() { return &camHelper_; }
+        unsigned int GetNumRenderLayers() const { return numRenderLayers_; }
+        void SetNumRenderLayers(unsigned int numRenderLayers) { numRenderLayers_ = numRenderLayers; }
         std::vector<FrameBuffer> CreateOffscreenBuffers(const FrameBufferDescriptor& fboDesc, int sizeDivisor = 1) const;
         const FrameBuffer* SelectOffscreenBuffer(const std::vector<FrameBuffer>& offscreenBuffers) const;
         std::unique_ptr<FullscreenQuad> CreateFullscreenQuad(const std::string& fragmentShader);
@@ -122,6 +124,7 @@ namespace viscom {
 
     private:
         glm::dvec2 ConvertInputCoordinatesLocalToGlobal(const glm::dvec2& p);
+        void UpdatePerFrameUniforms(std::size_t windowId);
         void ReleaseSynchronizedResource(ResourceType type, std::string_view name);
         void CreateSynchronizedResource(ResourceType type, const void* data, std::size_t length);
         void CreateSynchronizedResources();
@@ -156,6 +159,8 @@ namespace viscom {
         std::vector<glm::vec2> viewportScaling_;
         /** Holds the frame buffer objects for each window. */
         std::vector<FrameBuffer> framebuffers_;
+        /** Holds the number of windows rendered in one pass to a layered frame buffer (1 if rendered separately). */
+        unsigned int numRenderLayers_ = 1;
 
         /** The camera helper class. */
         CameraHelper camHelper_;
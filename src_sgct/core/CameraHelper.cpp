@@ -35,6 +35,11 @@ namespace viscom {
         return engine_->getCurrentProjectionMatrix();
     }
 
+    glm::mat4 CameraHelper::GetViewMatrix() const
+    {
+        return engine_->getCurrentModelViewMatrix() * CalculateViewUpdate();
+    }
+
     glm::mat4 CameraHelper::GetViewPerspectiveMatrix() const
     {
         auto result = CalculateViewUpdate();
@@ -47,9 +52,15 @@ namespace viscom {
     }
 
     glm::mat4 CameraHelper::GetCentralViewPerspectiveMatrix() const
+    {
+        return GetWindowViewPerspectiveMatrix(0);
+    }
+
+    /** Returns the view projection matrix of a windows first viewport, e.g., to render all windows in one pass. */
+    glm::mat4 CameraHelper::GetWindowViewPerspectiveMatrix(std::size_t windowId) const
     {
         auto result = CalculateViewUpdate();
-        return engine_->getWindowPtr(0)->getViewport(0)->getProjection(sgct_core::Frustum::MonoEye)->getViewProjectionMatrix()
+        return engine_->getWindowPtr(windowId)->getViewport(0)->getProjection(sgct_core::Frustum::MonoEye)->getViewProjectionMatrix()
             * sgct_core::ClusterManager::instance()->getSceneTransform() * result;
     }
 
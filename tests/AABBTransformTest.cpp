@@ -0,0 +1,130 @@
+/**
+ * @file   AABBTransformTest.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Tests the center/extent AABB transform against transforming the corners and benchmarks them.
+ */
+
+#include "TestHelper.h"
+#include "core/math/transforms.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+using namespace viscom;
+
+namespace {
+
+    /** The former AABB::Transform: permutes the corners recursively into a heap allocated vector. */
+    template<int I> struct PermuteMultiply {
+        static void Apply(std::vector<glm::vec3>& result, const glm::mat4& mat, const glm::vec4& v, const math::AABB3<float>& aabb)
+        {
+            auto v0 = v;
+            v0[I] = aabb.minmax_[0][I];
+            auto v1 = v;
+            v1[I] = aabb.minmax_[1][I];
+            PermuteMultiply<I - 1>::Apply(result, mat, v0, aabb);
+            PermuteMultiply<I - 1>::Apply(result, mat, v1, aabb);
+        }
+    };
+
+    template<> struct PermuteMultiply<0> {
+        static void Apply(std::vector<glm::vec3>& result, const glm::mat4& mat, const glm::vec4& v, const math::AABB3<float>& aabb)
+        {
+            auto v0 = v;
+            v0[0] = aabb.minmax_[0][0];
+            auto v1 = v;
+            v1[0] = aabb.minmax_[1][0];
+            result.emplace_back(mat * v0);
+            result.emplace_back(mat * v1);
+        }
+    };
+
+    math::AABB3<float> TransformPermuteMultiply(const math::AABB3<float>& aabb, const glm::mat4& mat)
+    {
+        std::vector<glm::vec3> newCorners;
+        PermuteMultiply<2>::Apply(newCorners, mat, glm::vec4{ 1.0f }, aabb);
+        return math::AABB3<float>{ newCorners };
+    }
+
+    /** The former math::transformAABB: transforms all eight corners without allocation. */
+    math::AABB3<float> TransformCorners(const math::AABB3<float>& aabb, const glm::mat4& m)
+    {
+        math::AABB3<float> result{ glm::vec3(std::numeric_limits<float>::infinity()), glm::vec3(-std::numeric_limits<float>::infinity()) };
+        for (auto i = 0; i < 8; ++i) {
+            glm::vec3 pt{ aabb.minmax_[(i & 0x4) == 0x4].x, aabb.minmax_[(i & 0x2) == 0x2].y, aabb.minmax_[i & 0x1].z };
+            auto ptTransformed = glm::vec3(m * glm::vec4(pt, 1.0f));
+            result.minmax_[0] = glm::min(result.minmax_[0], ptTransformed);
+            result.minmax_[1] = glm::max(result.minmax_[1], ptTransformed);
+        }
+        return result;
+    }
+
+    /** Compares two boxes relative to their magnitude (the corners may cancel out differently). */
+    bool IsClose(const math::AABB3<float>& b0, const math::AABB3<float>& b1)
+    {
+        auto scale = 1.0f;
+        for (const auto& corner : b0.minmax_) for (int j = 0; j < 3; ++j) scale = std::max(scale, std::abs(corner[j]));
+        for (int i = 0; i < 2; ++i) {
+            auto difference = glm::abs(b0.minmax_[i] - b1.minmax_[i]);
+            for (int j = 0; j < 3; ++j) if (difference[j] > 1e-5f * scale) return false;
+        }
+        return true;
+    }
+}
+
+int main(int, char**)
+{
+    constexpr std::size_t numBoxes = 1000000;
+
+    std::mt19937 rng{ 42 };
+    std::uniform_real_distribution<float> positionDist{ -100.0f, 100.0f };
+    std::uniform_real_distribution<float> sizeDist{ 0.01f, 10.0f };
+    std::uniform_real_distribution<float> angleDist{ -3.0f, 3.0f };
+
+    std::vector<math::AABB3<float>> boxes;
+    std::vector<glm::mat4> matrices;
+    boxes.reserve(numBoxes);
+    matrices.reserve(numBoxes);
+    for (std::size_t i = 0; i < numBoxes; ++i) {
+        glm::vec3 position{ positionDist(rng), positionDist(rng), positionDist(rng) };
+        glm::vec3 size{ sizeDist(rng), sizeDist(rng), sizeDist(rng) };
+        boxes.emplace_back(position, position + size);
+
+        glm::vec3 axis{ positionDist(rng), positionDist(rng), positionDist(rng) + 200.0f };
+        auto matrix = glm::translate(glm::mat4{ 1.0f }, glm::vec3{ positionDist(rng), positionDist(rng), positionDist(rng) });
+        matrix = glm::rotate(matrix, angleDist(rng), axis);
+        matrices.push_back(glm::scale(matrix, glm::vec3{ sizeDist(rng), -sizeDist(rng), sizeDist(rng) }));
+    }
+
+    // the center/extent form is exact for affine matrices, so all three methods must agree.
+    std::size_t numMismatches = 0;
+    for (std::size_t i = 0; i < numBoxes; ++i) {
+        auto arvo = math::transformAABB(boxes[i], matrices[i]);
+        if (!IsClose(arvo, TransformCorners(boxes[i], matrices[i]))) ++numMismatches;
+        if (!IsClose(arvo, TransformPermuteMultiply(boxes[i], matrices[i]))) ++numMismatches;
+    }
+    VISCOM_CHECK(numMismatches == 0);
+
+    // empty boxes stay unchanged.
+    math::AABB3<float> emptyBox;
+    VISCOM_CHECK(emptyBox.NewFromTransform(matrices[0]).minmax_ == emptyBox.minmax_);
+
+    std::vector<math::AABB3<float>> results(numBoxes);
+    auto permuteTime = test::MeasureMilliseconds(5, [&]() {
+        for (std::size_t i = 0; i < numBoxes; ++i) results[i] = TransformPermuteMultiply(boxes[i], matrices[i]);
+    });
+    auto cornersTime = test::MeasureMilliseconds(5, [&]() {
+        for (std::size_t i = 0; i < numBoxes; ++i) results[i] = TransformCorners(boxes[i], matrices[i]);
+    });
+    auto arvoTime = test::MeasureMilliseconds(5, [&]() {
+        for (std::size_t i = 0; i < numBoxes; ++i) results[i] = math::transformAABB(boxes[i], matrices[i]);
+    });
+
+    std::cout << "Transforming " << numBoxes << " boxes:" << std::endl;
+    std::cout << "  recursive permuteMultiply: " << permuteTime << "ms" << std::endl;
+    std::cout << "  eight corners:             " << cornersTime << "ms" << std::endl;
+    std::cout << "  center/extent (Arvo):      " << arvoTime << "ms" << std::endl;
+
+    return test::TestResult();
+}
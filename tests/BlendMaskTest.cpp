@@ -0,0 +1,145 @@
+/**
+ * @file   BlendMaskTest.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Tests writing and reading blend masks in all formats, with and without compression, and the legacy format.
+ */
+
+#include "TestHelper.h"
+#include "core/BlendMask.h"
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+
+using namespace viscom;
+
+namespace {
+
+    /** A typical blend mask: fully lit, ramps to the borders, black outside and some noise (odd width for the RLE). */
+    std::vector<float> CreateMask(const glm::uvec2& size)
+    {
+        std::mt19937 rng{ 42 };
+        std::uniform_real_distribution<float> noiseDist{ 0.0f, 1.0f };
+        std::vector<float> mask(static_cast<std::size_t>(size.x) * size.y);
+        for (auto y = 0U; y < size.y; ++y) {
+            for (auto x = 0U; x < size.x; ++x) {
+                auto& pixel = mask[static_cast<std::size_t>(y) * size.x + x];
+                if (x < 20) pixel = 0.0f;
+                else if (x < 120) pixel = static_cast<float>(x - 20) / 100.0f;
+                else if (x < 400) pixel = 1.0f;
+                else if (y % 7 == 0) pixel = noiseDist(rng);
+                else pixel = static_cast<float>(size.x - x) / static_cast<float>(size.x - 400);
+            }
+        }
+        return mask;
+    }
+
+    /** The maximum difference of a pixel after writing and reading it in a format. */
+    float GetTolerance(BlendMaskFormat format, float value)
+    {
+        switch (format) {
+        case BlendMaskFormat::R8:
+            return 0.5f / 255.0f + 1e-6f;
+        case BlendMaskFormat::R16:
+            return 0.5f / 65535.0f + 1e-7f;
+        case BlendMaskFormat::R16F:
+            // 11 significant bits, values in [0, 1].
+            return glm::max(value, 1.0f / 16384.0f) / 2048.0f;
+        default:
+            return 0.0f;
+        }
+    }
+
+    std::size_t GetFileSize(const std::string& filename)
+    {
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        return static_cast<std::size_t>(file.tellg());
+    }
+
+    /** Reads a mask in chunks of different sizes and returns the maximum difference relative to the tolerance. */
+    bool ReadAndCompare(BlendMaskReader& reader, const std::vector<float>& mask, BlendMaskFormat format)
+    {
+        const auto& size = reader.GetSize();
+        auto matches = true;
+        std::vector<unsigned int> chunks{ 1, 5, 64 };
+        for (auto y = 0U, chunk = 0U; y < size.y; ++chunk) {
+            auto numRows = glm::min(chunks[chunk % chunks.size()], size.y - y);
+            auto rows = reader.ReadRowsf(numRows);
+            for (std::size_t i = 0; i < rows.size(); ++i) {
+                auto expected = mask[static_cast<std::size_t>(y) * size.x + i];
+                if (glm::abs(rows[i] - expected) > GetTolerance(format, expected)) matches = false;
+            }
+            y += numRows;
+        }
+        return matches && reader.GetNumRowsRead() == size.y;
+    }
+}
+
+int main(int, char**)
+{
+    const std::string filename = "BlendMaskTest.bin";
+    glm::uvec2 size{ 517, 97 };
+    auto mask = CreateMask(size);
+
+    for (auto format : { BlendMaskFormat::R8, BlendMaskFormat::R16, BlendMaskFormat::R16F, BlendMaskFormat::R32F }) {
+        std::size_t uncompressedSize = 0;
+        for (auto compression : { BlendMaskCompression::None, BlendMaskCompression::DeltaRLE }) {
+            WriteBlendMask(filename, size, mask, format, compression);
+            auto fileSize = GetFileSize(filename);
+            if (compression == BlendMaskCompression::None) uncompressedSize = fileSize;
+            // the mask is mostly constant or linear, so the delta encoding leaves long runs.
+            else VISCOM_CHECK(fileSize < uncompressedSize / 2);
+
+            BlendMaskReader reader(filename);
+            VISCOM_CHECK(!reader.IsLegacy());
+            VISCOM_CHECK(reader.GetSize() == size);
+            VISCOM_CHECK(reader.GetFormat() == format);
+            VISCOM_CHECK(reader.GetCompression() == compression);
+            VISCOM_CHECK(reader.GetBytesPerPixel() == GetBlendMaskBytesPerPixel(format));
+            VISCOM_CHECK(ReadAndCompare(reader, mask, format));
+
+            auto readBeyondEnd = false;
+            try { reader.ReadRows(1, std::vector<std::uint8_t>(size.x * reader.GetBytesPerPixel()).data()); }
+            catch (const std::runtime_error&) { readBeyondEnd = true; }
+            VISCOM_CHECK(readBeyondEnd);
+        }
+    }
+
+    // the legacy format: the size as two unsigned integers followed by the pixels as floats.
+    {
+        std::ofstream file(filename, std::ios::binary);
+        glm::u32vec2 legacySize{ size };
+        file.write(reinterpret_cast<const char*>(&legacySize), sizeof(legacySize));
+        file.write(reinterpret_cast<const char*>(mask.data()), mask.size() * sizeof(float));
+    }
+    {
+        BlendMaskReader reader(filename);
+        VISCOM_CHECK(reader.IsLegacy());
+        VISCOM_CHECK(reader.GetSize() == size);
+        VISCOM_CHECK(reader.GetFormat() == BlendMaskFormat::R32F);
+        VISCOM_CHECK(reader.GetCompression() == BlendMaskCompression::None);
+        VISCOM_CHECK(ReadAndCompare(reader, mask, BlendMaskFormat::R32F));
+    }
+
+    // truncated files are reported instead of returning garbage.
+    WriteBlendMask(filename, size, mask, BlendMaskFormat::R16, BlendMaskCompression::DeltaRLE);
+    {
+        std::ifstream file(filename, std::ios::binary);
+        std::vector<char> data(GetFileSize(filename) / 2);
+        file.read(data.data(), data.size());
+        file.close();
+        std::ofstream truncated(filename, std::ios::binary);
+        truncated.write(data.data(), data.size());
+    }
+    {
+        BlendMaskReader reader(filename);
+        auto truncatedDetected = false;
+        try { reader.ReadRowsf(size.y); }
+        catch (const std::runtime_error&) { truncatedDetected = true; }
+        VISCOM_CHECK(truncatedDetected);
+    }
+
+    std::remove(filename.c_str());
+    return test::TestResult();
+}
@@ -0,0 +1,89 @@
+/**
+ * @file   FrustumCullingTest.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Tests the batched (SIMD) frustum culling against the scalar test and benchmarks both.
+ */
+
+#include "TestHelper.h"
+#include "core/math/FrustumCulling.h"
+#include "core/math/math.h"
+#include "core/math/simd.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <random>
+
+using namespace viscom;
+
+namespace {
+
+    /** Returns the signed distance of the positive vertex of a box to the closest plane (negative if culled). */
+    float MinPlaneDistance(const math::Frustum<float>& frustum, const math::AABB3<float>& box)
+    {
+        auto result = std::numeric_limits<float>::max();
+        for (const auto& plane : frustum.planes) {
+            glm::vec3 p{ plane.x >= 0.0f ? box.minmax_[1].x : box.minmax_[0].x,
+                plane.y >= 0.0f ? box.minmax_[1].y : box.minmax_[0].y,
+                plane.z >= 0.0f ? box.minmax_[1].z : box.minmax_[0].z };
+            result = std::min(result, glm::dot(glm::vec3(plane), p) + plane.w);
+        }
+        return result;
+    }
+}
+
+int main(int, char**)
+{
+    // not a multiple of 32 to also test the remainder loop.
+    constexpr std::size_t numBoxes = 1000003;
+
+    std::mt19937 rng{ 42 };
+    std::uniform_real_distribution<float> positionDist{ -100.0f, 100.0f };
+    std::uniform_real_distribution<float> sizeDist{ 0.01f, 10.0f };
+
+    std::vector<math::AABB3<float>> boxes;
+    math::AABB3ArraySoA boxesSoA;
+    boxes.reserve(numBoxes);
+    for (std::size_t i = 0; i < numBoxes; ++i) {
+        glm::vec3 position{ positionDist(rng), positionDist(rng), positionDist(rng) };
+        glm::vec3 size{ sizeDist(rng), sizeDist(rng), sizeDist(rng) };
+        boxes.emplace_back(position, position + size);
+        boxesSoA.PushBack(boxes.back());
+    }
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 150.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(10.0f, 5.0f, 20.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    auto frustum = math::extractFrustum(projection * view);
+
+    std::vector<std::uint32_t> visibility;
+    math::CullAABBs(frustum, boxesSoA, visibility);
+    VISCOM_CHECK(visibility.size() == (numBoxes + 31) / 32);
+
+    std::size_t numVisible = 0, numMismatches = 0;
+    for (std::size_t i = 0; i < numBoxes; ++i) {
+        auto scalarVisible = math::AABBInFrustumTest(frustum, boxes[i]);
+        if (scalarVisible) ++numVisible;
+        // boxes touching a plane may differ by the rounding of the dot product.
+        if (math::IsVisible(visibility, i) != scalarVisible && std::abs(MinPlaneDistance(frustum, boxes[i])) > 1e-4f) ++numMismatches;
+    }
+    VISCOM_CHECK(numMismatches == 0);
+    // the view should neither contain all nor no boxes, otherwise the test is meaningless.
+    VISCOM_CHECK(numVisible > 0 && numVisible < numBoxes);
+
+    // the padding bits of the last entry must not be set.
+    VISCOM_CHECK((visibility.back() >> (numBoxes % 32)) == 0);
+
+    auto scalarTime = test::MeasureMilliseconds(10, [&]() {
+        for (std::size_t i = 0; i < numBoxes; ++i) {
+            if (math::AABBInFrustumTest(frustum, boxes[i])) visibility[i / 32] |= 1U << (i % 32);
+            else visibility[i / 32] &= ~(1U << (i % 32));
+        }
+    });
+    auto batchedTime = test::MeasureMilliseconds(10, [&]() { math::CullAABBs(frustum, boxesSoA, visibility); });
+
+    std::cout << "Culling " << numBoxes << " boxes (" << numVisible << " visible, SSE: " << math::USE_SSE
+        << ", AVX: " << math::USE_AVX << "):" << std::endl;
+    std::cout << "  scalar AABBInFrustumTest: " << scalarTime << "ms" << std::endl;
+    std::cout << "  batched CullAABBs:        " << batchedTime << "ms" << std::endl;
+
+    return test::TestResult();
+}
@@ -0,0 +1,377 @@
+/**
+ * @file   IndirectDrawGLTest.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Renders a scene with the indirect draw data of MeshRenderable::DrawIndirect and with one draw call per
+ *         sub-mesh like MeshRenderable::Draw and compares the images. Runs headless on an EGL context without
+ *         surface (e.g., Mesa llvmpipe with LIBGL_ALWAYS_SOFTWARE=1), exits with 77 (skipped) if there is none.
+ */
+
+#include "TestHelper.h"
+#include "core/gfx/mesh/IndirectDraw.h"
+#define GL_GLEXT_PROTOTYPES
+#include <GL/glcorearb.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cstring>
+#include <string>
+
+using namespace viscom;
+
+namespace {
+
+    constexpr int IMAGE_SIZE = 64;
+    constexpr int SKIP_TEST = 77;
+
+    /** The per-draw data of the indirect path (see MeshRenderable, std430 layout). */
+    const char* INDIRECT_VERTEX_SHADER = R"(
+layout(location = 0) in vec3 position;
+layout(location = 1) in uint drawIndex;
+struct DrawData { mat4 modelMatrix; mat4 normalMatrix; uint materialIndex; };
+layout(std430, binding = 0) buffer DrawDataBuffer { DrawData drawData[]; };
+layout(std430, binding = 1) buffer MaterialBuffer { vec4 materialColors[]; };
+uniform mat4 layerMatrices[2];
+uniform int numLayers;
+flat out vec4 color;
+void main()
+{
+    int layer = gl_InstanceID % numLayers;
+    gl_Position = layerMatrices[layer] * drawData[drawIndex].modelMatrix * vec4(position, 1.0);
+    color = materialColors[drawData[drawIndex].materialIndex];
+    SET_LAYER
+}
+)";
+
+    /** The uniforms of the direct path. */
+    const char* DIRECT_VERTEX_SHADER = R"(
+layout(location = 0) in vec3 position;
+uniform mat4 modelMatrix;
+uniform vec4 materialColor;
+uniform mat4 layerMatrices[2];
+flat out vec4 color;
+void main()
+{
+    int layer = gl_InstanceID;
+    gl_Position = layerMatrices[layer] * modelMatrix * vec4(position, 1.0);
+    color = materialColor;
+    SET_LAYER
+}
+)";
+
+    const char* FRAGMENT_SHADER = R"(
+flat in vec4 color;
+out vec4 fragColor;
+void main() { fragColor = color; }
+)";
+
+    /** A surfaceless OpenGL 4.3 core context. */
+    struct HeadlessContext
+    {
+        EGLDisplay display_ = EGL_NO_DISPLAY;
+        EGLContext context_ = EGL_NO_CONTEXT;
+
+        bool Create()
+        {
+            auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+            if (getPlatformDisplay == nullptr) return false;
+            display_ = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            EGLint major, minor;
+            if (display_ == EGL_NO_DISPLAY || !eglInitialize(display_, &major, &minor) || !eglBindAPI(EGL_OPENGL_API)) return false;
+
+            const EGLint attributes[] = { EGL_CONTEXT_MAJOR_VERSION, 4, EGL_CONTEXT_MINOR_VERSION, 3,
+                EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE };
+            context_ = eglCreateContext(display_, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+            return context_ != EGL_NO_CONTEXT && eglMakeCurrent(display_, EGL_NO_SURFACE, EGL_NO_SURFACE, context_);
+        }
+
+        ~HeadlessContext()
+        {
+            if (context_ != EGL_NO_CONTEXT) eglDestroyContext(display_, context_);
+            if (display_ != EGL_NO_DISPLAY) eglTerminate(display_);
+        }
+    };
+
+    GLuint CompileShader(GLenum type, const std::string& source)
+    {
+        auto shader = glCreateShader(type);
+        const auto* text = source.c_str();
+        glShaderSource(shader, 1, &text, nullptr);
+        glCompileShader(shader);
+        GLint status;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if (status != GL_TRUE) {
+            std::string log(4096, '\0');
+            glGetShaderInfoLog(shader, static_cast<GLsizei>(log.size()), nullptr, &log[0]);
+            std::cerr << "Shader compilation failed: " << log.c_str() << std::endl;
+        }
+        return shader;
+    }
+
+    GLuint CreateProgram(const char* vertexShader, bool layered)
+    {
+        std::string header = "#version 430 core\n";
+        if (layered) header += "#extension GL_ARB_shader_viewport_layer_array : require\n";
+        std::string vertexSource = vertexShader;
+        auto setLayer = vertexSource.find("SET_LAYER");
+        vertexSource.replace(setLayer, 9, layered ? "gl_Layer = layer;" : "");
+
+        auto program = glCreateProgram();
+        auto vs = CompileShader(GL_VERTEX_SHADER, header + vertexSource);
+        auto fs = CompileShader(GL_FRAGMENT_SHADER, header + FRAGMENT_SHADER);
+        glAttachShader(program, vs);
+        glAttachShader(program, fs);
+        glLinkProgram(program);
+        glDeleteShader(vs);
+        glDeleteShader(fs);
+        GLint status;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        VISCOM_CHECK(status == GL_TRUE);
+        return program;
+    }
+
+    bool HasExtension(const char* name)
+    {
+        GLint numExtensions = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+        for (GLint i = 0; i < numExtensions; ++i) {
+            if (std::strcmp(reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i)), name) == 0) return true;
+        }
+        return false;
+    }
+
+    /** A mesh of quads in one vertex and index buffer (one sub-mesh per quad, indices relative to the first vertex). */
+    struct QuadScene
+    {
+        static constexpr GLuint NUM_SUB_MESHES = 6;
+
+        GLuint vao_ = 0;
+        GLuint buffers_[3] = { 0, 0, 0 };
+        std::vector<IndirectDrawItem> items_;
+        std::vector<glm::mat4> nodeMatrices_;
+        std::vector<glm::mat3> nodeNormalMatrices_;
+        std::vector<glm::vec4> materialColors_{ glm::vec4(1.0f, 0.0f, 0.0f, 1.0f), glm::vec4(0.0f, 1.0f, 0.0f, 1.0f),
+            glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), glm::vec4(1.0f, 1.0f, 0.0f, 1.0f) };
+
+        QuadScene()
+        {
+            std::vector<glm::vec3> vertices;
+            std::vector<GLuint> indices;
+            for (GLuint i = 0; i < NUM_SUB_MESHES; ++i) {
+                // distinct depths, so the image does not depend on the draw order.
+                glm::vec3 center{ 0.12f * i - 0.3f, 0.08f * i - 0.2f, 0.1f * i - 0.3f };
+                auto first = static_cast<GLuint>(vertices.size());
+                vertices.push_back(center + glm::vec3(-0.25f, -0.2f, 0.0f));
+                vertices.push_back(center + glm::vec3(0.25f, -0.2f, 0.0f));
+                vertices.push_back(center + glm::vec3(0.25f, 0.2f, 0.0f));
+                vertices.push_back(center + glm::vec3(-0.25f, 0.2f, 0.0f));
+                for (auto index : { 0U, 1U, 2U, 0U, 2U, 3U }) indices.push_back(first + index);
+
+                // node, number of indices, first index, material, textures (only used for grouping).
+                items_.push_back(IndirectDrawItem{ i % 3, 6, i * 6, i % 4, { i % 2, 0 } });
+            }
+            nodeMatrices_.resize(3, glm::mat4{ 1.0f });
+            nodeMatrices_[1][3] = glm::vec4(0.3f, -0.1f, 0.05f, 1.0f);
+            nodeMatrices_[2][0][0] = 0.5f;
+            nodeMatrices_[2][3] = glm::vec4(-0.2f, 0.4f, -0.05f, 1.0f);
+            nodeNormalMatrices_.resize(3, glm::mat3{ 1.0f });
+
+            // the draw index attribute reads 0 to the number of sub-meshes, the base instance selects the entry.
+            std::vector<std::uint32_t> drawIndices(NUM_SUB_MESHES);
+            for (std::uint32_t i = 0; i < NUM_SUB_MESHES; ++i) drawIndices[i] = i;
+
+            glGenVertexArrays(1, &vao_);
+            glBindVertexArray(vao_);
+            glGenBuffers(3, buffers_);
+            glBindBuffer(GL_ARRAY_BUFFER, buffers_[0]);
+            glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW);
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers_[1]);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, buffers_[2]);
+            glBufferData(GL_ARRAY_BUFFER, drawIndices.size() * sizeof(std::uint32_t), drawIndices.data(), GL_STATIC_DRAW);
+            glEnableVertexAttribArray(1);
+            glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, sizeof(std::uint32_t), nullptr);
+            glBindVertexArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+
+        ~QuadScene()
+        {
+            glDeleteBuffers(3, buffers_);
+            glDeleteVertexArrays(1, &vao_);
+        }
+    };
+
+    /** A layered color and depth target. */
+    struct LayeredTarget
+    {
+        GLuint fbo_ = 0;
+        GLuint readFbo_ = 0;
+        GLuint textures_[2] = { 0, 0 };
+        GLsizei numLayers_;
+
+        explicit LayeredTarget(GLsizei numLayers) : numLayers_{ numLayers }
+        {
+            glGenTextures(2, textures_);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, textures_[0]);
+            glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_RGBA8, IMAGE_SIZE, IMAGE_SIZE, numLayers);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, textures_[1]);
+            glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_DEPTH_COMPONENT24, IMAGE_SIZE, IMAGE_SIZE, numLayers);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+            glGenFramebuffers(1, &fbo_);
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+            glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, textures_[0], 0);
+            glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, textures_[1], 0);
+            VISCOM_CHECK(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+            glGenFramebuffers(1, &readFbo_);
+        }
+
+        ~LayeredTarget()
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &fbo_);
+            glDeleteFramebuffers(1, &readFbo_);
+            glDeleteTextures(2, textures_);
+        }
+
+        void Clear() const
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo_);
+            glViewport(0, 0, IMAGE_SIZE, IMAGE_SIZE);
+            glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
+
+        std::vector<std::uint8_t> Read() const
+        {
+            std::vector<std::uint8_t> pixels(static_cast<std::size_t>(IMAGE_SIZE) * IMAGE_SIZE * 4 * numLayers_);
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, readFbo_);
+            for (GLsizei layer = 0; layer < numLayers_; ++layer) {
+                glFramebufferTextureLayer(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, textures_[0], 0, layer);
+                glReadPixels(0, 0, IMAGE_SIZE, IMAGE_SIZE, GL_RGBA, GL_UNSIGNED_BYTE,
+                    pixels.data() + static_cast<std::size_t>(IMAGE_SIZE) * IMAGE_SIZE * 4 * layer);
+            }
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+            return pixels;
+        }
+    };
+
+    /** Like MeshRenderable::DrawIndirectSubMeshes: one multi draw per set of textures. */
+    std::vector<std::uint8_t> RenderIndirect(const QuadScene& scene, const LayeredTarget& target, GLuint program, GLuint numLayers)
+    {
+        auto items = scene.items_;
+        SortIndirectDrawItems(items);
+        std::vector<DrawElementsIndirectCommand> commands;
+        std::vector<IndirectDrawData> drawData;
+        BuildIndirectDrawCommands(items, scene.nodeMatrices_, scene.nodeNormalMatrices_, numLayers, commands, drawData);
+
+        GLuint buffers[3];
+        glGenBuffers(3, buffers);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffers[0]);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[1]);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, drawData.size() * sizeof(IndirectDrawData), drawData.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[2]);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, scene.materialColors_.size() * sizeof(glm::vec4), scene.materialColors_.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffers[1]);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buffers[2]);
+
+        target.Clear();
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "numLayers"), static_cast<GLint>(numLayers));
+        glBindVertexArray(scene.vao_);
+        // all layers of a draw read the same draw index.
+        glVertexAttribDivisor(1, numLayers);
+        for (std::size_t first = 0; first < items.size();) {
+            auto last = first + 1;
+            while (last < items.size() && items[last].textures_ == items[first].textures_) ++last;
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, static_cast<char*>(nullptr) + first * sizeof(DrawElementsIndirectCommand),
+                static_cast<GLsizei>(last - first), 0);
+            first = last;
+        }
+        glBindVertexArray(0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        glDeleteBuffers(3, buffers);
+        return target.Read();
+    }
+
+    /** Like MeshRenderable::Draw: one draw call per sub-mesh with the matrices as uniforms. */
+    std::vector<std::uint8_t> RenderDirect(const QuadScene& scene, const LayeredTarget& target, GLuint program, GLuint numLayers)
+    {
+        target.Clear();
+        glUseProgram(program);
+        glBindVertexArray(scene.vao_);
+        for (const auto& item : scene.items_) {
+            glUniformMatrix4fv(glGetUniformLocation(program, "modelMatrix"), 1, GL_FALSE, &scene.nodeMatrices_[item.node_][0][0]);
+            glUniform4fv(glGetUniformLocation(program, "materialColor"), 1, &scene.materialColors_[item.materialIndex_][0]);
+            glDrawElementsInstanced(GL_TRIANGLES, item.numIndices_, GL_UNSIGNED_INT,
+                static_cast<char*>(nullptr) + item.firstIndex_ * sizeof(GLuint), static_cast<GLsizei>(numLayers));
+        }
+        glBindVertexArray(0);
+        return target.Read();
+    }
+
+    void SetLayerMatrices(GLuint program)
+    {
+        glm::mat4 layerMatrices[2] = { glm::mat4{ 1.0f }, glm::mat4{ 1.0f } };
+        layerMatrices[1][0][0] = 1.5f;
+        layerMatrices[1][3] = glm::vec4(-0.3f, 0.1f, 0.0f, 1.0f);
+        glUseProgram(program);
+        glUniformMatrix4fv(glGetUniformLocation(program, "layerMatrices"), 2, GL_FALSE, &layerMatrices[0][0][0]);
+    }
+
+    /** Renders the scene with both paths and compares the images of all layers. */
+    void CompareIndirectToDirect(const QuadScene& scene, GLuint numLayers)
+    {
+        auto layered = numLayers > 1;
+        auto indirectProgram = CreateProgram(INDIRECT_VERTEX_SHADER, layered);
+        auto directProgram = CreateProgram(DIRECT_VERTEX_SHADER, layered);
+        SetLayerMatrices(indirectProgram);
+        SetLayerMatrices(directProgram);
+        LayeredTarget target{ static_cast<GLsizei>(numLayers) };
+
+        auto indirectImage = RenderIndirect(scene, target, indirectProgram, numLayers);
+        auto directImage = RenderDirect(scene, target, directProgram, numLayers);
+        VISCOM_CHECK(glGetError() == GL_NO_ERROR);
+
+        // every layer shows a good part of the quads.
+        const auto numPixels = static_cast<std::size_t>(IMAGE_SIZE) * IMAGE_SIZE;
+        const auto layerSize = numPixels * 4;
+        for (GLuint layer = 0; layer < numLayers; ++layer) {
+            std::size_t numCovered = 0;
+            for (std::size_t i = layer * layerSize; i < (layer + 1) * layerSize; i += 4) numCovered += directImage[i + 3] != 0 ? 1 : 0;
+            VISCOM_CHECK(numCovered > numPixels / 8);
+        }
+        std::size_t numDifferent = 0;
+        for (std::size_t i = 0; i < indirectImage.size(); ++i) numDifferent += indirectImage[i] != directImage[i] ? 1 : 0;
+        if (numDifferent != 0) std::cerr << numLayers << " layer(s): " << numDifferent << " different bytes." << std::endl;
+        VISCOM_CHECK(numDifferent == 0);
+
+        glDeleteProgram(indirectProgram);
+        glDeleteProgram(directProgram);
+    }
+}
+
+int main(int, char**)
+{
+    HeadlessContext context;
+    if (!context.Create()) {
+        std::cout << "No headless OpenGL 4.3 context available, skipping." << std::endl;
+        return SKIP_TEST;
+    }
+    std::cout << "Rendering with " << glGetString(GL_RENDERER) << "." << std::endl;
+
+    glEnable(GL_DEPTH_TEST);
+    {
+        QuadScene scene;
+        CompareIndirectToDirect(scene, 1);
+        if (HasExtension("GL_ARB_shader_viewport_layer_array")) CompareIndirectToDirect(scene, 2);
+        else std::cout << "GL_ARB_shader_viewport_layer_array not supported, skipping layered rendering." << std::endl;
+    }
+
+    return test::TestResult();
+}
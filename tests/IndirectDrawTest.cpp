@@ -0,0 +1,78 @@
+/**
+ * @file   IndirectDrawTest.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Tests the indirect draw commands and per-draw data built for MeshRenderable::DrawIndirect.
+ */
+
+#include "TestHelper.h"
+#include "core/gfx/mesh/IndirectDraw.h"
+
+using namespace viscom;
+
+int main(int, char**)
+{
+    // the buffers are read by the GPU, so the layouts have to match exactly.
+    VISCOM_CHECK(sizeof(DrawElementsIndirectCommand) == 5 * sizeof(GLuint));
+    VISCOM_CHECK(sizeof(IndirectDrawData) == 2 * sizeof(glm::mat4) + 4 * sizeof(std::uint32_t));
+
+    std::vector<glm::mat4> nodeMatrices(3, glm::mat4{ 1.0f });
+    std::vector<glm::mat3> nodeNormalMatrices(3, glm::mat3{ 1.0f });
+    for (std::size_t n = 0; n < nodeMatrices.size(); ++n) {
+        nodeMatrices[n][3] = glm::vec4(static_cast<float>(n), 2.0f * n, 3.0f * n, 1.0f);
+        nodeNormalMatrices[n][0][0] = static_cast<float>(n + 1);
+    }
+
+    // node, number of indices, first index, material, textures.
+    std::vector<IndirectDrawItem> items{
+        { 0, 30, 0, 2, { 5, 0 } },
+        { 1, 60, 30, 1, { 3, 4 } },
+        { 2, 90, 90, 0, { 5, 0 } },
+        { 2, 12, 180, 1, { 0, 0 } },
+        { 1, 24, 192, 2, { 3, 4 } } };
+
+    SortIndirectDrawItems(items);
+    // sorted by textures, equal textures keep their order.
+    VISCOM_CHECK(items[0].firstIndex_ == 180);
+    VISCOM_CHECK(items[1].firstIndex_ == 30 && items[2].firstIndex_ == 192);
+    VISCOM_CHECK(items[3].firstIndex_ == 0 && items[4].firstIndex_ == 90);
+
+    std::vector<DrawElementsIndirectCommand> commands;
+    std::vector<IndirectDrawData> drawData;
+    BuildIndirectDrawCommands(items, nodeMatrices, nodeNormalMatrices, 1, commands, drawData);
+    VISCOM_CHECK(commands.size() == items.size());
+    VISCOM_CHECK(drawData.size() == items.size());
+
+    for (std::size_t i = 0; i < items.size() && i < commands.size() && i < drawData.size(); ++i) {
+        VISCOM_CHECK(commands[i].count_ == items[i].numIndices_);
+        VISCOM_CHECK(commands[i].instanceCount_ == 1);
+        VISCOM_CHECK(commands[i].firstIndex_ == items[i].firstIndex_);
+        VISCOM_CHECK(commands[i].baseVertex_ == 0);
+        // the base instance selects the per-draw data.
+        VISCOM_CHECK(commands[i].baseInstance_ == i);
+
+        VISCOM_CHECK(drawData[i].modelMatrix_ == nodeMatrices[items[i].node_]);
+        VISCOM_CHECK(drawData[i].normalMatrix_ == glm::mat4(nodeNormalMatrices[items[i].node_]));
+        VISCOM_CHECK(drawData[i].normalMatrix_[3] == glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+        VISCOM_CHECK(drawData[i].materialIndex_ == items[i].materialIndex_);
+    }
+
+    // layered rendering draws one instance per layer, the base instance still selects the per-draw data.
+    BuildIndirectDrawCommands(items, nodeMatrices, nodeNormalMatrices, 3, commands, drawData);
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        VISCOM_CHECK(commands[i].instanceCount_ == 3);
+        VISCOM_CHECK(commands[i].baseInstance_ == i);
+    }
+
+    // the arrays are reused between frames.
+    items.resize(2);
+    BuildIndirectDrawCommands(items, nodeMatrices, nodeNormalMatrices, 1, commands, drawData);
+    VISCOM_CHECK(commands.size() == 2 && drawData.size() == 2);
+
+    items.clear();
+    BuildIndirectDrawCommands(items, nodeMatrices, nodeNormalMatrices, 1, commands, drawData);
+    VISCOM_CHECK(commands.empty() && drawData.empty());
+
+    return test::TestResult();
+}
@@ -0,0 +1,121 @@
+/**
+ * @file   OcclusionCullingTest.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Tests that the software occlusion buffer never culls boxes that are (partly) visible.
+ */
+
+#include "TestHelper.h"
+#include "core/math/OcclusionCulling.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <array>
+#include <random>
+
+using namespace viscom;
+
+namespace {
+
+    /** A triangle of an occluder in window coordinates (x, y in pixels, z in [0, 1]). */
+    using ScreenTriangle = std::array<glm::vec3, 3>;
+
+    glm::vec3 ToWindow(const glm::mat4& viewProjection, const glm::vec3& p, const math::OcclusionBuffer& buffer)
+    {
+        auto clip = viewProjection * glm::vec4(p, 1.0f);
+        auto ndc = glm::vec3(clip) / clip.w;
+        return glm::vec3((ndc.x + 1.0f) * 0.5f * buffer.GetWidth(), (ndc.y + 1.0f) * 0.5f * buffer.GetHeight(), 0.5f * ndc.z + 0.5f);
+    }
+
+    /** Returns the depth of a triangle at a window position (2 if the triangle does not cover it). */
+    float TriangleDepth(const ScreenTriangle& t, const glm::vec2& p)
+    {
+        auto area = (t[1].x - t[0].x) * (t[2].y - t[0].y) - (t[1].y - t[0].y) * (t[2].x - t[0].x);
+        if (area == 0.0f) return 2.0f;
+        auto w0 = ((t[1].x - p.x) * (t[2].y - p.y) - (t[1].y - p.y) * (t[2].x - p.x)) / area;
+        auto w1 = ((t[2].x - p.x) * (t[0].y - p.y) - (t[2].y - p.y) * (t[0].x - p.x)) / area;
+        auto w2 = 1.0f - w0 - w1;
+        if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) return 2.0f;
+        return w0 * t[0].z + w1 * t[1].z + w2 * t[2].z;
+    }
+
+    /** Checks with sample points on the surface of a box if any part of it is in front of all occluders. */
+    bool IsSampledVisible(const math::OcclusionBuffer& buffer, const std::vector<ScreenTriangle>& occluders,
+        const math::AABB3<float>& box, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> dist{ 0.0f, 1.0f };
+        for (int i = 0; i < 512; ++i) {
+            glm::vec3 t{ dist(rng), dist(rng), dist(rng) };
+            // move the sample to one of the faces, the corners are included.
+            t[i % 3] = static_cast<float>((i / 3) % 2);
+            if (i < 8) t = glm::vec3(static_cast<float>(i & 1), static_cast<float>((i >> 1) & 1), static_cast<float>((i >> 2) & 1));
+            auto sample = ToWindow(buffer.GetViewProjection(), box.minmax_[0] + t * (box.minmax_[1] - box.minmax_[0]), buffer);
+            // samples outside of the view are not visible anyway.
+            if (sample.x < 0.0f || sample.y < 0.0f || sample.x >= buffer.GetWidth() || sample.y >= buffer.GetHeight()) continue;
+
+            auto hidden = false;
+            for (const auto& occluder : occluders) hidden = hidden || TriangleDepth(occluder, glm::vec2(sample)) < sample.z;
+            if (!hidden) return true;
+        }
+        return false;
+    }
+}
+
+int main(int, char**)
+{
+    auto viewProjection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 100.0f)
+        * glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    math::OcclusionBuffer buffer{ 256, 128 };
+
+    // a wall at z = -10 covering the center of the view.
+    std::vector<glm::vec3> wall{ { -4.0f, -3.0f, -10.0f }, { 4.0f, -3.0f, -10.0f }, { 4.0f, 3.0f, -10.0f }, { -4.0f, 3.0f, -10.0f } };
+    std::vector<unsigned int> wallIndices{ 0, 1, 2, 0, 2, 3 };
+    buffer.Clear(viewProjection);
+    buffer.RasterizeTriangles(glm::mat4{ 1.0f }, wall, wallIndices.data(), wallIndices.size());
+
+    // behind the wall (away from the diagonal, pixels on edges shared by two triangles are not covered).
+    VISCOM_CHECK(!buffer.IsVisible(math::AABB3<float>{ glm::vec3(-3.0f, 1.0f, -30.0f), glm::vec3(-2.0f, 2.0f, -20.0f) }));
+    // in front of the wall, intersecting it and the wall itself.
+    VISCOM_CHECK(buffer.IsVisible(math::AABB3<float>{ glm::vec3(-1.0f, -1.0f, -9.0f), glm::vec3(1.0f, 1.0f, -8.0f) }));
+    VISCOM_CHECK(buffer.IsVisible(math::AABB3<float>{ glm::vec3(-1.0f, -1.0f, -11.0f), glm::vec3(1.0f, 1.0f, -9.0f) }));
+    VISCOM_CHECK(buffer.IsVisible(math::AABB3<float>{ glm::vec3(-4.0f, -3.0f, -10.0f), glm::vec3(4.0f, 3.0f, -10.0f) }));
+    // behind the wall, but slightly larger than its silhouette (less than a pixel).
+    VISCOM_CHECK(buffer.IsVisible(math::AABB3<float>{ glm::vec3(-8.0f, -1.0f, -20.0f), glm::vec3(8.02f, 1.0f, -20.0f) }));
+    // crossing the near plane.
+    VISCOM_CHECK(buffer.IsVisible(math::AABB3<float>{ glm::vec3(-1.0f, -1.0f, -30.0f), glm::vec3(1.0f, 1.0f, 1.0f) }));
+
+    // random occluders and boxes: every culled box has to be hidden at all sample points.
+    std::mt19937 rng{ 42 };
+    std::uniform_real_distribution<float> positionDist{ -10.0f, 10.0f };
+    std::uniform_real_distribution<float> depthDist{ -40.0f, -2.0f };
+    std::uniform_real_distribution<float> sizeDist{ 0.01f, 3.0f };
+    std::size_t numCulled = 0, numWrong = 0;
+    for (int scene = 0; scene < 50; ++scene) {
+        std::vector<glm::vec3> vertices;
+        std::vector<unsigned int> indices;
+        for (unsigned int i = 0; i < 30; ++i) {
+            vertices.emplace_back(positionDist(rng), positionDist(rng), depthDist(rng));
+            indices.push_back(static_cast<unsigned int>(vertices.size() - 1));
+        }
+        buffer.Clear(viewProjection);
+        buffer.RasterizeTriangles(glm::mat4{ 1.0f }, vertices, indices.data(), indices.size());
+
+        std::vector<ScreenTriangle> occluders;
+        for (std::size_t i = 0; i < vertices.size(); i += 3) {
+            occluders.push_back(ScreenTriangle{ ToWindow(viewProjection, vertices[i], buffer),
+                ToWindow(viewProjection, vertices[i + 1], buffer), ToWindow(viewProjection, vertices[i + 2], buffer) });
+        }
+
+        for (int i = 0; i < 2000; ++i) {
+            glm::vec3 position{ positionDist(rng), positionDist(rng), depthDist(rng) - 5.0f };
+            math::AABB3<float> box{ position, position + glm::vec3(sizeDist(rng), sizeDist(rng), sizeDist(rng)) };
+            if (buffer.IsVisible(box)) continue;
+            ++numCulled;
+            if (IsSampledVisible(buffer, occluders, box, rng)) ++numWrong;
+        }
+    }
+    std::cout << numCulled << " boxes culled, " << numWrong << " of them visible." << std::endl;
+    VISCOM_CHECK(numCulled > 0);
+    VISCOM_CHECK(numWrong == 0);
+
+    return test::TestResult();
+}
@@ -0,0 +1,177 @@
+/**
+ * @file   OpenCVParserTest.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Tests parsing the calibration matrices and their binary cache and benchmarks them on a large file.
+ */
+
+#include "TestHelper.h"
+#include "core/OpenCVParserHelper.h"
+#include <g3log/logworker.hpp>
+#include <experimental/filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+using namespace viscom;
+namespace fs = std::experimental::filesystem;
+
+namespace {
+
+    const std::string XML_FILENAME = "OpenCVParserTest.xml";
+
+    std::string MatrixXML(const std::string& name, std::size_t rows, const std::string& dt, const std::string& data)
+    {
+        return "<" + name + " type_id=\"opencv-matrix\">\n  <rows>" + std::to_string(rows) + "</rows>\n  <cols>1</cols>\n  <dt>"
+            + dt + "</dt>\n  <data>\n    " + data + "</data></" + name + ">\n";
+    }
+
+    void WriteXML(const std::string& matrices)
+    {
+        std::ofstream file(XML_FILENAME);
+        file << "<?xml version=\"1.0\"?>\n<opencv_storage>\n" << matrices << "</opencv_storage>\n";
+    }
+
+    template<typename F> bool Throws(F&& f)
+    {
+        try { f(); }
+        catch (const std::runtime_error&) { return true; }
+        return false;
+    }
+
+    /** The parser before the binary cache: one std::stringstream per matrix. */
+    std::vector<glm::vec3> ParseVector3fStringStream(tinyxml2::XMLElement* element)
+    {
+        std::vector<glm::vec3> result(OpenCVParserHelper::Parse<std::size_t>(element->FirstChildElement("rows")));
+        std::stringstream dataStream(element->FirstChildElement("data")->GetText());
+        float x, y, z;
+        std::size_t i = 0;
+        while (dataStream >> x >> y >> z) result[i++] = glm::vec3(x, y, z);
+        return result;
+    }
+
+    void TestParsing()
+    {
+        WriteXML(MatrixXML("values", 6, "f", "1.5e3 +2 -3.25E-2\n    +4.0e+1 0. 7")
+            + MatrixXML("points", 2, "\"3f\"", "1. 2. 3. -4 +5e-1 6E2"));
+        auto matrices = OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, false);
+
+        auto values = OpenCVParserHelper::GetVectorf(matrices, "values");
+        VISCOM_CHECK(values == std::vector<float>({ 1500.0f, 2.0f, -0.0325f, 40.0f, 0.0f, 7.0f }));
+        auto points = OpenCVParserHelper::GetVector3f(matrices, "points");
+        VISCOM_CHECK(points.size() == 2);
+        VISCOM_CHECK(points[0] == glm::vec3(1.0f, 2.0f, 3.0f) && points[1] == glm::vec3(-4.0f, 0.5f, 600.0f));
+        VISCOM_CHECK(Throws([&matrices]() { OpenCVParserHelper::GetVector2f(matrices, "points"); }));
+        VISCOM_CHECK(Throws([&matrices]() { OpenCVParserHelper::GetVectorf(matrices, "missing"); }));
+
+        WriteXML(MatrixXML("values", 4, "f", "1 2 3"));
+        VISCOM_CHECK(Throws([]() { OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, false); }));
+        WriteXML(MatrixXML("values", 2, "f", "1 2 3"));
+        VISCOM_CHECK(Throws([]() { OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, false); }));
+        WriteXML(MatrixXML("values", 3, "f", "1 abc 3"));
+        VISCOM_CHECK(Throws([]() { OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, false); }));
+        WriteXML(MatrixXML("values", 2, "f", "1 ++2"));
+        VISCOM_CHECK(Throws([]() { OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, false); }));
+    }
+
+    void TestCache()
+    {
+        auto cacheFilename = XML_FILENAME + ".cache";
+        fs::remove(cacheFilename);
+        WriteXML(MatrixXML("values", 3, "f", "1 2 3"));
+        auto writeTime = fs::last_write_time(XML_FILENAME);
+
+        auto fromXML = OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, true);
+        VISCOM_CHECK(fs::exists(cacheFilename));
+        auto fromCache = OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, true);
+        VISCOM_CHECK(OpenCVParserHelper::GetVectorf(fromCache, "values") == OpenCVParserHelper::GetVectorf(fromXML, "values"));
+
+        // same size and write time: the cache is used, so the changed values are not seen.
+        WriteXML(MatrixXML("values", 3, "f", "4 5 6"));
+        fs::last_write_time(XML_FILENAME, writeTime);
+        auto cached = OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, true);
+        VISCOM_CHECK(OpenCVParserHelper::GetVectorf(cached, "values") == std::vector<float>({ 1.0f, 2.0f, 3.0f }));
+
+        // a different write time invalidates the cache.
+        fs::last_write_time(XML_FILENAME, writeTime + std::chrono::seconds(10));
+        auto changedTime = OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, true);
+        VISCOM_CHECK(OpenCVParserHelper::GetVectorf(changedTime, "values") == std::vector<float>({ 4.0f, 5.0f, 6.0f }));
+
+        // a different size invalidates the cache.
+        WriteXML(MatrixXML("values", 3, "f", "7 8 9.5"));
+        fs::last_write_time(XML_FILENAME, writeTime + std::chrono::seconds(10));
+        auto changedSize = OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, true);
+        VISCOM_CHECK(OpenCVParserHelper::GetVectorf(changedSize, "values") == std::vector<float>({ 7.0f, 8.0f, 9.5f }));
+
+        // corrupt caches are ignored.
+        std::ofstream(cacheFilename, std::ios::binary | std::ios::trunc) << "VCMC";
+        auto corruptCache = OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, true);
+        VISCOM_CHECK(OpenCVParserHelper::GetVectorf(corruptCache, "values") == std::vector<float>({ 7.0f, 8.0f, 9.5f }));
+
+        fs::remove(cacheFilename);
+    }
+
+    /** Compares the stringstream parser to the current one and the cache on a calibration set of many projectors. */
+    void BenchmarkLargeFile()
+    {
+        constexpr std::size_t numProjectors = 16;
+        constexpr std::size_t numPoints = 40000;
+
+        std::mt19937 rng{ 42 };
+        std::uniform_real_distribution<float> dist{ -2000.0f, 2000.0f };
+        std::string matrices;
+        for (std::size_t p = 0; p < numProjectors; ++p) {
+            std::ostringstream data;
+            data.precision(9);
+            for (std::size_t i = 0; i < 3 * numPoints; ++i) data << dist(rng) << (i % 3 == 2 ? "\n    " : " ");
+            matrices += MatrixXML("warpGrid" + std::to_string(p), numPoints, "\"3f\"", data.str());
+        }
+        WriteXML(matrices);
+        auto cacheFilename = XML_FILENAME + ".cache";
+        fs::remove(cacheFilename);
+
+        tinyxml2::XMLDocument doc;
+        OpenCVParserHelper::LoadXMLDocument("Test", XML_FILENAME, doc);
+        auto storage = doc.FirstChildElement("opencv_storage");
+        auto mismatches = 0;
+        for (auto element = storage->FirstChildElement(); element != nullptr; element = element->NextSiblingElement()) {
+            if (ParseVector3fStringStream(element) != OpenCVParserHelper::ParseVector3f(element)) ++mismatches;
+        }
+        VISCOM_CHECK(mismatches == 0);
+
+        auto stringStreamTime = test::MeasureMilliseconds(3, [storage]() {
+            for (auto element = storage->FirstChildElement(); element != nullptr; element = element->NextSiblingElement()) ParseVector3fStringStream(element);
+        });
+        auto parseTime = test::MeasureMilliseconds(3, [storage]() {
+            for (auto element = storage->FirstChildElement(); element != nullptr; element = element->NextSiblingElement()) OpenCVParserHelper::ParseVector3f(element);
+        });
+        auto xmlTime = test::MeasureMilliseconds(3, []() { OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, false); });
+        OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, true);
+        auto cacheTime = test::MeasureMilliseconds(3, []() { OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, true); });
+        VISCOM_CHECK(OpenCVParserHelper::LoadMatrices("Test", XML_FILENAME, true).size() == numProjectors);
+
+        std::cout << "Loading " << numProjectors << " matrices of " << numPoints << " 3f values ("
+            << fs::file_size(XML_FILENAME) / (1024 * 1024) << "MB):" << std::endl;
+        std::cout << "  parse data, stringstream:  " << stringStreamTime << "ms" << std::endl;
+        std::cout << "  parse data, from_chars:    " << parseTime << "ms" << std::endl;
+        std::cout << "  LoadMatrices, XML:         " << xmlTime << "ms" << std::endl;
+        std::cout << "  LoadMatrices, cache:       " << cacheTime << "ms" << std::endl;
+
+        fs::remove(cacheFilename);
+    }
+}
+
+int main(int, char**)
+{
+    auto logWorker = g3::LogWorker::createLogWorker();
+    g3::initializeLogging(logWorker.get());
+
+    TestParsing();
+    TestCache();
+    BenchmarkLargeFile();
+
+    fs::remove(XML_FILENAME);
+    return test::TestResult();
+}
@@ -0,0 +1,135 @@
+/**
+ * @file   RenderGraphTest.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Tests compiling render graphs: culling of unused passes, aliasing of frame buffers and kept resources.
+ */
+
+#include "TestHelper.h"
+#include "core/gfx/RenderGraph.h"
+#include "core/open_gl.h"
+
+using namespace viscom;
+
+namespace {
+
+    void NoDraw(const RenderGraph&, const FrameBuffer&) {}
+
+    FrameBufferDescriptor ColorDepthDesc()
+    {
+        return FrameBufferDescriptor{ { FrameBufferTextureDescriptor{ GL_RGBA8 } }, { RenderBufferDescriptor{ GL_DEPTH24_STENCIL8 } } };
+    }
+
+    /** Passes a -> b -> c -> output, a and c can share a frame buffer unless c uses a different descriptor or size. */
+    RenderGraphStatistics CompileChain(const FrameBufferDescriptor& desc, const FrameBufferDescriptor& descC, unsigned int sizeDivisorC)
+    {
+        RenderGraph graph;
+        auto a = graph.AddPass("a", {}, desc, 1, NoDraw);
+        auto b = graph.AddPass("b", { { a, 0 } }, desc, 1, NoDraw);
+        auto c = graph.AddPass("c", { { b, 0 } }, descC, sizeDivisorC, NoDraw);
+        graph.AddOutputPass("output", { { c, 0 } }, NoDraw);
+        graph.Compile();
+        return graph.GetStatistics();
+    }
+
+    void TestAliasing()
+    {
+        auto desc = ColorDepthDesc();
+        auto shared = CompileChain(desc, desc, 1);
+        VISCOM_CHECK(shared.numPasses_ == 4 && shared.culledPasses_ == 0);
+        VISCOM_CHECK(shared.numTargets_ == 3 && shared.numPhysicalTargets_ == 2);
+
+        // every part of the descriptor and the size have to match.
+        auto multisampled = desc;
+        multisampled.numSamples_ = 4;
+        auto otherFormat = desc;
+        otherFormat.texDesc_[0].internalFormat_ = GL_RGBA16F;
+        auto withoutDepth = desc;
+        withoutDepth.rbDesc_.clear();
+        VISCOM_CHECK(CompileChain(desc, multisampled, 1).numPhysicalTargets_ == 3);
+        VISCOM_CHECK(CompileChain(desc, otherFormat, 1).numPhysicalTargets_ == 3);
+        VISCOM_CHECK(CompileChain(desc, withoutDepth, 1).numPhysicalTargets_ == 3);
+        VISCOM_CHECK(CompileChain(desc, desc, 2).numPhysicalTargets_ == 3);
+
+        FrameBufferDescriptor layered{ { FrameBufferTextureDescriptor{ GL_RGBA8, GL_TEXTURE_2D_ARRAY } }, {} };
+        layered.numLayers_ = 2;
+        auto moreLayers = layered;
+        moreLayers.numLayers_ = 4;
+        VISCOM_CHECK(CompileChain(layered, layered, 1).numPhysicalTargets_ == 2);
+        VISCOM_CHECK(CompileChain(layered, moreLayers, 1).numPhysicalTargets_ == 3);
+
+        // passes reading two textures keep both alive.
+        RenderGraph graph;
+        auto a = graph.AddPass("a", {}, ColorDepthDesc(), 1, NoDraw);
+        auto b = graph.AddPass("b", { { a, 0 } }, ColorDepthDesc(), 1, NoDraw);
+        auto c = graph.AddPass("c", { { a, 0 }, { b, 0 } }, ColorDepthDesc(), 1, NoDraw);
+        graph.AddOutputPass("output", { { c, 0 } }, NoDraw);
+        graph.Compile();
+        VISCOM_CHECK(graph.GetStatistics().numPhysicalTargets_ == 3);
+    }
+
+    void TestCullingAndKeep()
+    {
+        // a -> b -> c -> d -> output, unused reads a but nothing reads unused.
+        auto buildGraph = [](RenderGraph& graph) {
+            auto a = graph.AddPass("a", {}, ColorDepthDesc(), 1, NoDraw);
+            auto b = graph.AddPass("b", { { a, 0 } }, ColorDepthDesc(), 1, NoDraw);
+            auto unused = graph.AddPass("unused", { { a, 0 } }, ColorDepthDesc(), 1, NoDraw);
+            auto c = graph.AddPass("c", { { b, 0 } }, ColorDepthDesc(), 1, NoDraw);
+            auto d = graph.AddPass("d", { { c, 0 } }, ColorDepthDesc(), 1, NoDraw);
+            graph.AddOutputPass("output", { { d, 0 } }, NoDraw);
+            return std::make_pair(a, unused);
+        };
+
+        {
+            RenderGraph graph;
+            auto unused = buildGraph(graph).second;
+            graph.Compile();
+            const auto& statistics = graph.GetStatistics();
+            VISCOM_CHECK(!graph.IsPassExecuted(unused));
+            for (std::size_t p = 0; p < statistics.numPasses_; ++p) VISCOM_CHECK(graph.IsPassExecuted(p) == (p != unused));
+            VISCOM_CHECK(statistics.numPasses_ == 6 && statistics.culledPasses_ == 1);
+            // a and c, b and d share frame buffers.
+            VISCOM_CHECK(statistics.numTargets_ == 4 && statistics.numPhysicalTargets_ == 2);
+        }
+
+        // kept textures are not overwritten by later passes.
+        {
+            RenderGraph graph;
+            auto a = buildGraph(graph).first;
+            graph.KeepResource({ a, 0 });
+            graph.Compile();
+            VISCOM_CHECK(graph.GetStatistics().culledPasses_ == 1);
+            VISCOM_CHECK(graph.GetStatistics().numPhysicalTargets_ == 3);
+        }
+
+        // kept passes are executed even if no output reads them.
+        {
+            RenderGraph graph;
+            auto unused = buildGraph(graph).second;
+            graph.KeepResource({ unused, 0 });
+            graph.Compile();
+            VISCOM_CHECK(graph.IsPassExecuted(unused));
+            VISCOM_CHECK(graph.GetStatistics().culledPasses_ == 0 && graph.GetStatistics().numTargets_ == 5);
+            VISCOM_CHECK(graph.GetStatistics().numPhysicalTargets_ == 3);
+        }
+
+        // a graph without outputs executes nothing.
+        {
+            RenderGraph graph;
+            auto a = graph.AddPass("a", {}, ColorDepthDesc(), 1, NoDraw);
+            graph.AddPass("b", { { a, 0 } }, ColorDepthDesc(), 1, NoDraw);
+            graph.Compile();
+            VISCOM_CHECK(graph.GetStatistics().culledPasses_ == 2 && graph.GetStatistics().numPhysicalTargets_ == 0);
+        }
+    }
+}
+
+int main(int, char**)
+{
+    TestAliasing();
+    TestCullingAndKeep();
+
+    return test::TestResult();
+}
@@ -0,0 +1,154 @@
+/**
+ * @file   RenderTargetPoolTest.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Tests the bookkeeping of the RenderTargetPool: keying, reuse of released targets and the memory limit.
+ */
+
+#include "TestHelper.h"
+#include "core/gfx/RenderTargetPoolBookkeeping.h"
+#include "core/open_gl.h"
+#include <set>
+#include <vector>
+
+using namespace viscom;
+
+namespace {
+
+    using TargetKey = RenderTargetPoolBookkeeping::TargetKey;
+
+    /** The names of the allocated (fake) targets. */
+    std::set<std::pair<GLenum, GLuint>> liveTargets;
+    /** The names of the deleted targets in the order of deletion. */
+    std::vector<GLuint> deletedTargets;
+
+    GLuint AllocateTarget(const TargetKey& key)
+    {
+        static GLuint nextName = 1;
+        liveTargets.emplace(std::get<0>(key), nextName);
+        return nextName++;
+    }
+
+    void DeleteTarget(GLenum target, GLuint name)
+    {
+        VISCOM_CHECK(liveTargets.erase(std::make_pair(target, name)) == 1);
+        deletedTargets.push_back(name);
+    }
+
+    TargetKey Key2D(GLenum internalFormat, unsigned int width, unsigned int height)
+    {
+        return TargetKey{ GL_TEXTURE_2D, internalFormat, width, height, 1, 1 };
+    }
+
+    void TestSizes()
+    {
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetBytesPerPixel(GL_R8) == 1);
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetBytesPerPixel(GL_R16) == 2);
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetBytesPerPixel(GL_R16F) == 2);
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetBytesPerPixel(GL_RGBA8) == 4);
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetBytesPerPixel(GL_DEPTH24_STENCIL8) == 4);
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetBytesPerPixel(GL_RGB16F) == 8);
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetBytesPerPixel(GL_RGBA16) == 8);
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetBytesPerPixel(GL_RGBA16F) == 8);
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetBytesPerPixel(GL_RGB32F) == 12);
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetBytesPerPixel(GL_RGBA32F) == 16);
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetBytesPerPixel(GL_RGBA32UI) == 16);
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetBytesPerPixel(GL_RGBA32I) == 16);
+
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetSizeInBytes(Key2D(GL_RGBA16, 64, 32)) == 8 * 64 * 32);
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetSizeInBytes(TargetKey{ GL_TEXTURE_2D_MULTISAMPLE_ARRAY, GL_RGBA8, 16, 16, 4, 3 }) == 4 * 16 * 16 * 4 * 3);
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetSizeInBytes(TargetKey{ GL_TEXTURE_CUBE_MAP, GL_R8, 8, 8, 1, 1 }) == 8 * 8 * 6);
+        VISCOM_CHECK(RenderTargetPoolBookkeeping::GetSizeInBytes(TargetKey{ GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, 8, 8, 0, 0 }) == 2 * 8 * 8);
+    }
+
+    void TestReuse()
+    {
+        RenderTargetPoolBookkeeping pool{ &AllocateTarget, &DeleteTarget, 1024 * 1024 };
+        const auto& statistics = pool.GetStatistics();
+        auto key = Key2D(GL_RGBA8, 64, 64);
+
+        // targets in use are never handed out twice.
+        auto first = pool.Acquire(key);
+        auto second = pool.Acquire(key);
+        VISCOM_CHECK(first != second);
+        VISCOM_CHECK(statistics.misses_ == 2 && statistics.hits_ == 0);
+        VISCOM_CHECK(statistics.numTargets_ == 2 && statistics.allocatedBytes_ == 2 * 4 * 64 * 64);
+
+        pool.Release(GL_TEXTURE_2D, first);
+        VISCOM_CHECK(statistics.pooledBytes_ == 4 * 64 * 64);
+        VISCOM_CHECK(pool.Acquire(key) == first);
+        VISCOM_CHECK(statistics.hits_ == 1 && statistics.pooledBytes_ == 0 && statistics.numTargets_ == 2);
+
+        // every part of the key has to match.
+        pool.Release(GL_TEXTURE_2D, first);
+        for (const auto& other : { TargetKey{ GL_TEXTURE_2D_ARRAY, GL_RGBA8, 64, 64, 1, 1 }, Key2D(GL_RGBA16F, 64, 64),
+            Key2D(GL_RGBA8, 32, 64), Key2D(GL_RGBA8, 64, 32), TargetKey{ GL_TEXTURE_2D, GL_RGBA8, 64, 64, 4, 1 },
+            TargetKey{ GL_TEXTURE_2D, GL_RGBA8, 64, 64, 1, 2 } }) {
+            VISCOM_CHECK(pool.Acquire(other) != first);
+        }
+        VISCOM_CHECK(statistics.hits_ == 1 && statistics.misses_ == 8);
+        VISCOM_CHECK(pool.Acquire(key) == first);
+
+        // releasing name 0 (e.g., of a frame buffer without that attachment) does nothing.
+        pool.Release(GL_TEXTURE_2D, 0);
+        VISCOM_CHECK(statistics.pooledBytes_ == 0 && deletedTargets.empty());
+
+        // Trim deletes the released targets only.
+        pool.Release(GL_TEXTURE_2D, first);
+        pool.Release(GL_TEXTURE_2D, second);
+        auto numLive = liveTargets.size();
+        pool.Trim();
+        VISCOM_CHECK(deletedTargets.size() == 2 && liveTargets.size() == numLive - 2);
+        VISCOM_CHECK(statistics.pooledBytes_ == 0 && statistics.numTargets_ == liveTargets.size());
+        VISCOM_CHECK(pool.Acquire(key) != first);
+
+        pool.ResetStatistics();
+        VISCOM_CHECK(statistics.hits_ == 0 && statistics.misses_ == 0 && statistics.numTargets_ == liveTargets.size());
+    }
+
+    void TestMaxPooledBytes()
+    {
+        liveTargets.clear();
+        deletedTargets.clear();
+        const std::size_t small = 4 * 16 * 16;
+        RenderTargetPoolBookkeeping pool{ &AllocateTarget, &DeleteTarget, 4 * small };
+        const auto& statistics = pool.GetStatistics();
+
+        auto smallTarget = pool.Acquire(Key2D(GL_RGBA8, 16, 16));
+        auto mediumTarget = pool.Acquire(Key2D(GL_RGBA8, 32, 16));
+        auto largeTarget = pool.Acquire(Key2D(GL_RGBA8, 32, 32));
+        auto renderBuffer = pool.Acquire(TargetKey{ GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, 16, 16, 1, 1 });
+
+        // the large target would exceed the limit and is deleted directly.
+        pool.Release(GL_TEXTURE_2D, smallTarget);
+        pool.Release(GL_TEXTURE_2D, mediumTarget);
+        pool.Release(GL_TEXTURE_2D, largeTarget);
+        VISCOM_CHECK(deletedTargets == std::vector<GLuint>({ largeTarget }));
+        VISCOM_CHECK(statistics.pooledBytes_ == 3 * small && statistics.allocatedBytes_ == 4 * small);
+        pool.Release(GL_RENDERBUFFER, renderBuffer);
+        VISCOM_CHECK(statistics.pooledBytes_ == 4 * small);
+
+        // lowering the limit deletes the largest released targets first.
+        pool.SetMaxPooledBytes(2 * small);
+        VISCOM_CHECK(deletedTargets == std::vector<GLuint>({ largeTarget, mediumTarget }));
+        VISCOM_CHECK(statistics.pooledBytes_ == 2 * small && statistics.numTargets_ == 2);
+        VISCOM_CHECK(pool.GetMaxPooledBytes() == 2 * small);
+
+        // without a limit, released targets are deleted directly (e.g., after clean up).
+        pool.SetMaxPooledBytes(0);
+        VISCOM_CHECK(statistics.pooledBytes_ == 0 && statistics.numTargets_ == 0 && statistics.allocatedBytes_ == 0);
+        auto target = pool.Acquire(Key2D(GL_RGBA8, 16, 16));
+        pool.Release(GL_TEXTURE_2D, target);
+        VISCOM_CHECK(deletedTargets.back() == target && liveTargets.empty());
+    }
+}
+
+int main(int, char**)
+{
+    TestSizes();
+    TestReuse();
+    TestMaxPooledBytes();
+
+    return test::TestResult();
+}
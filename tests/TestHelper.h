@@ -0,0 +1,54 @@
+/**
+ * @file   TestHelper.h
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Minimal helpers for the CPU side unit tests and benchmarks (see VISCOM_BUILD_TESTS).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+namespace viscom::test {
+
+    /** The number of failed checks of the current test executable. */
+    inline int& GetNumFailedChecks() { static int numFailed = 0; return numFailed; }
+
+    /** Returns the exit code of a test executable (0 if all checks passed). */
+    inline int TestResult()
+    {
+        if (GetNumFailedChecks() == 0) std::cout << "All checks passed." << std::endl;
+        else std::cout << GetNumFailedChecks() << " check(s) failed." << std::endl;
+        return GetNumFailedChecks() == 0 ? 0 : 1;
+    }
+
+    /**
+     *  Measures the best wall clock time of a number of runs of a function (in milliseconds).
+     *  @param numRuns the number of runs.
+     *  @param f the function to measure.
+     */
+    template<typename F> double MeasureMilliseconds(unsigned int numRuns, F&& f)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (unsigned int i = 0; i < numRuns; ++i) {
+            auto start = std::chrono::high_resolution_clock::now();
+            f();
+            std::chrono::duration<double, std::milli> duration = std::chrono::high_resolution_clock::now() - start;
+            best = std::min(best, duration.count());
+        }
+        return best;
+    }
+}
+
+/** Checks a condition and reports it (with the location) if it does not hold, the test continues. */
+#define VISCOM_CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            ++viscom::test::GetNumFailedChecks(); \
+            std::cerr << __FILE__ << "(" << __LINE__ << "): check failed: " #condition << std::endl; \
+        } \
+    } while (false)
@@ -0,0 +1,69 @@
+/**
+ * @file   BlendMaskConverter.cpp
+ * @author agent <agent@local>
+ * @date   2026.10.18
+ *
+ * @brief  Command line tool converting blend masks (alpha textures) to the compact format.
+ */
+
+#include "core/BlendMask.h"
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+    void PrintUsage()
+    {
+        std::cout << "Usage: BlendMaskConverter <input> <output> [R8|R16|R16F|R32F] [--uncompressed]" << std::endl;
+        std::cout << "  Converts a blend mask (legacy or compact format) to the compact format (default R16, compressed)." << std::endl;
+        std::cout << "  Input and output may be the same file." << std::endl;
+    }
+
+    viscom::BlendMaskFormat ParseFormat(const std::string& format)
+    {
+        if (format == "R8") return viscom::BlendMaskFormat::R8;
+        if (format == "R16") return viscom::BlendMaskFormat::R16;
+        if (format == "R16F") return viscom::BlendMaskFormat::R16F;
+        if (format == "R32F") return viscom::BlendMaskFormat::R32F;
+        throw std::runtime_error("Unknown format (" + format + ").");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        PrintUsage();
+        return 1;
+    }
+
+    try {
+        std::string input = argv[1];
+        std::string output = argv[2];
+        auto format = viscom::BlendMaskFormat::R16;
+        auto compression = viscom::BlendMaskCompression::DeltaRLE;
+        for (auto i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--uncompressed") compression = viscom::BlendMaskCompression::None;
+            else format = ParseFormat(arg);
+        }
+
+        glm::uvec2 size;
+        std::vector<float> data;
+        {
+            // the reader needs to be closed before the input can be overwritten.
+            viscom::BlendMaskReader reader(input);
+            size = reader.GetSize();
+            data = reader.ReadRowsf(size.y);
+        }
+        viscom::WriteBlendMask(output, size, data, format, compression);
+
+        auto inputSize = static_cast<double>(size.x) * size.y * sizeof(float);
+        std::ifstream outputFile(output, std::ios::binary | std::ios::ate);
+        auto outputSize = static_cast<double>(outputFile.tellg());
+        std::cout << input << " (" << size.x << "x" << size.y << ") -> " << output << ": "
+            << (outputSize / 1024.0) << "KB (" << (100.0 * outputSize / inputSize) << "% of the float data)." << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}